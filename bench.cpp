@@ -0,0 +1,884 @@
+// Benchmarks for the performance work on the containers. From the repository root:
+//
+//     c++ -std=c++11 -O2 -pthread -I. bench.cpp -o bench && ./bench [name...]
+//
+// With no names every benchmark runs. Each figure is the best of a few repetitions, so it shows
+// what the code can do rather than the noise of the machine; thread counts beyond the cores
+// available only measure contention.
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "deque/deque.hpp"
+#include "map/map.hpp"
+#include "map/sharded_map.hpp"
+#include "parallel/numa_allocator.hpp"
+#include "parallel/thread_pool.hpp"
+#include "queue/mpmc_ring.hpp"
+#include "set/roaring_set.hpp"
+#include "set/set.hpp"
+#include "queue/queue.hpp"
+#include "stack/concurrent_stack.hpp"
+#include "stack/stack.hpp"
+#include "utils/external_sort.hpp"
+#include "vector/concurrent_vector.hpp"
+#include "vector/mapped_vector_view.hpp"
+#include "vector/small_vector.hpp"
+#include "vector/soa_vector.hpp"
+#include "vector/vector_io.hpp"
+#include "vector/vector.hpp"
+
+namespace
+{
+    volatile size_t sink;
+
+    double now() {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // Seconds taken by the fastest of reps calls of f.
+    template <class F>
+    double best_of(int reps, F f) {
+        double best = 1e30;
+
+        for (int i = 0; i < reps; ++i) {
+            double start = now();
+            f();
+            double t = now() - start;
+            if (t < best)
+                best = t;
+        }
+        return best;
+    }
+
+    unsigned next_random(unsigned &state) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
+    // Lookups of random keys, half of them present, through find one at a time and through
+    // find_many in batches of several sizes.
+    void bench_find_many() {
+        const size_t sizes[] = {1 << 10, 1 << 16, 1 << 20};
+        const size_t batches[] = {4, 16, 64, 1024};
+        const size_t lookups = 1 << 20;
+
+        std::cout << "ns per lookup" << std::endl << std::setw(10) << "tree" << std::setw(12) << "find";
+        for (size_t b = 0; b < sizeof(batches) / sizeof(batches[0]); ++b)
+            std::cout << std::setw(10) << "batch " << std::setw(4) << batches[b];
+        std::cout << std::endl;
+        for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s) {
+            unsigned state = 12345;
+            ft::map<unsigned, unsigned> m;
+            std::vector<unsigned> present;
+            for (size_t i = 0; i < sizes[s]; ++i) {
+                present.push_back(next_random(state) | 1);
+                m.insert(ft::make_pair(present.back(), unsigned(i)));
+            }
+            // Present keys are odd, so the even ones drawn for the other half all miss.
+            std::vector<unsigned> keys(lookups);
+            for (size_t i = 0; i < lookups; ++i)
+                keys[i] = i & 1 ? next_random(state) & ~1u : present[next_random(state) % present.size()];
+
+            double single = best_of(3, [&]() {
+                size_t hits = 0;
+                for (size_t i = 0; i < lookups; ++i)
+                    hits += m.find(keys[i]) != m.end();
+                sink = hits;
+            });
+            std::cout << std::setw(10) << sizes[s] << std::setw(12) << std::fixed << std::setprecision(1)
+                      << single * 1e9 / lookups;
+            for (size_t b = 0; b < sizeof(batches) / sizeof(batches[0]); ++b) {
+                std::vector<ft::map<unsigned, unsigned>::iterator> out(batches[b]);
+                double batched = best_of(3, [&]() {
+                    size_t hits = 0;
+                    for (size_t i = 0; i < lookups; i += batches[b]) {
+                        m.find_many(keys.begin() + i, keys.begin() + i + batches[b], out.begin());
+                        for (size_t k = 0; k < batches[b]; ++k)
+                            hits += out[k] != m.end();
+                    }
+                    sink = hits;
+                });
+                std::cout << std::setw(14) << batched * 1e9 / lookups;
+            }
+            std::cout << std::endl;
+        }
+    }
+
+    size_t allocations;
+    size_t allocated_bytes;
+
+    // std::allocator that counts allocate calls and the bytes they asked for.
+    template <class T>
+    struct counting_allocator : std::allocator<T>{
+        template <class U>
+        struct rebind{
+            typedef counting_allocator<U> other;
+        };
+
+        counting_allocator() {}
+
+        template <class U>
+        counting_allocator(const counting_allocator<U> &) {}
+
+        T *allocate(size_t n, const void * = 0) {
+            ++allocations;
+            allocated_bytes += n * sizeof(T);
+            return std::allocator<T>::allocate(n);
+        }
+    };
+
+    template <class Vector>
+    void short_vectors(const char *name, size_t count) {
+        allocations = 0;
+        double t = best_of(1, [&]() {
+            size_t total = 0;
+            unsigned state = 7;
+            for (size_t i = 0; i < count; ++i) {
+                Vector v;
+                for (unsigned n = next_random(state) % 8; n; --n)
+                    v.push_back(int(n));
+                total += v.size();
+            }
+            sink = total;
+        });
+        std::cout << std::setw(28) << name << std::setw(14) << allocations << std::setw(12) << std::fixed
+                  << std::setprecision(1) << t * 1e9 / count << std::endl;
+    }
+
+    // Millions of vectors of 0 to 7 ints, each built by push_back and dropped again.
+    void bench_small_vector() {
+        const size_t count = 4000000;
+
+        std::cout << std::setw(28) << "4M vectors of 0-7 ints" << std::setw(14) << "allocations" << std::setw(12)
+                  << "ns each" << std::endl;
+        short_vectors<std::vector<int, counting_allocator<int> > >("std::vector", count);
+        short_vectors<ft::vector<int, counting_allocator<int> > >("ft::vector", count);
+        short_vectors<ft::small_vector<int, 8, counting_allocator<int> > >("ft::small_vector<int, 8>", count);
+        short_vectors<ft::small_vector<int, 4, counting_allocator<int> > >("ft::small_vector<int, 4>", count);
+    }
+
+    // main.cpp's Buffer: a 4 KiB element, so every copy a container makes shows.
+    struct buffer{
+        int idx;
+        char buff[4096];
+    };
+
+    template <class Container>
+    void stack_round(const char *name, size_t count) {
+        double t = best_of(3, [&]() {
+            ft::stack<buffer, Container> st;
+            buffer b;
+            size_t total = 0;
+            std::memset(&b, 0, sizeof(b));
+            for (size_t i = 0; i < count; ++i) {
+                b.idx = int(i);
+                st.push(b);
+            }
+            while (!st.empty()) {
+                total += st.top().idx;
+                st.pop();
+            }
+            sink = total;
+        });
+        std::cout << std::setw(16) << name << std::setw(14) << std::fixed << std::setprecision(1)
+                  << t * 1e9 / count / 2 << std::setw(14) << 2 * count / t / 1e6 << std::endl;
+    }
+
+    // Pushes count buffers onto an ft::stack and pops them all again, over each container.
+    void bench_stack() {
+        const size_t count = 1 << 16;
+
+        std::cout << std::setw(16) << "256 MiB stack" << std::setw(14) << "ns per op" << std::setw(14) << "Mops/s"
+                  << std::endl;
+        stack_round<ft::vector<buffer> >("ft::vector", count);
+        stack_round<ft::deque<buffer> >("ft::deque", count);
+        stack_round<std::deque<buffer> >("std::deque", count);
+    }
+
+    // Seconds for threads threads to run f(thread) each, all started together.
+    template <class F>
+    double run_threads(int threads, F f) {
+        return best_of(3, [&]() {
+            std::vector<std::thread> workers;
+            for (int t = 0; t < threads; ++t)
+                workers.push_back(std::thread(f, t));
+            for (int t = 0; t < threads; ++t)
+                workers[t].join();
+        });
+    }
+
+    // Every thread pushes a value and pops one, as threads sharing a free list do, on the lock-free
+    // stack and on an ft::stack behind a mutex.
+    void bench_concurrent_stack() {
+        const size_t ops = 1 << 20;
+        const int counts[] = {1, 2, 4, 8};
+
+        std::cout << std::setw(8) << "threads" << std::setw(22) << "concurrent_stack" << std::setw(22)
+                  << "mutex + ft::stack" << "   (Mops/s, push+pop pairs)" << std::endl;
+        for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); ++c) {
+            const int threads = counts[c];
+            const size_t per_thread = ops / threads;
+            ft::concurrent_stack<size_t> lock_free;
+            double t_free = run_threads(threads, [&](int) {
+                size_t total = 0;
+                size_t value;
+                for (size_t i = 0; i < per_thread; ++i) {
+                    lock_free.push(i);
+                    if (lock_free.try_pop(value))
+                        total += value;
+                }
+                sink = total;
+            });
+            ft::stack<size_t> locked;
+            std::mutex lock;
+            double t_locked = run_threads(threads, [&](int) {
+                size_t total = 0;
+                for (size_t i = 0; i < per_thread; ++i) {
+                    {
+                        std::lock_guard<std::mutex> guard(lock);
+                        locked.push(i);
+                    }
+                    std::lock_guard<std::mutex> guard(lock);
+                    if (!locked.empty()) {
+                        total += locked.top();
+                        locked.pop();
+                    }
+                }
+                sink = total;
+            });
+            std::cout << std::setw(8) << threads << std::setw(22) << std::fixed << std::setprecision(1)
+                      << ops / t_free / 1e6 << std::setw(22) << ops / t_locked / 1e6 << std::endl;
+        }
+    }
+
+    // The baseline the rings replace: an ft::queue behind a mutex, bounded like them.
+    template <class T>
+    struct locked_queue{
+        ft::queue<T> queue;
+        std::mutex lock;
+        size_t capacity;
+
+        explicit locked_queue(size_t n) : capacity(n) {}
+
+        bool try_push(const T &val) {
+            std::lock_guard<std::mutex> guard(lock);
+            if (queue.size() == capacity)
+                return false;
+            queue.push(val);
+            return true;
+        }
+
+        bool try_pop(T &out) {
+            std::lock_guard<std::mutex> guard(lock);
+            if (queue.empty())
+                return false;
+            out = queue.front();
+            queue.pop();
+            return true;
+        }
+    };
+
+    unsigned long long now_ns() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // Producers push their send time, consumers record how long each value waited. Reports the
+    // throughput of the whole run and the 99th percentile of the waits.
+    template <class Channel>
+    void pipeline(const char *name, int producers, int consumers, size_t items) {
+        Channel channel(1024);
+        std::atomic<size_t> received(0);
+        std::vector<std::vector<unsigned long long> > waits(consumers);
+        std::vector<std::thread> workers;
+        double start = now();
+
+        for (int p = 0; p < producers; ++p)
+            workers.push_back(std::thread([&, p]() {
+                for (size_t i = p; i < items; i += producers)
+                    while (!channel.try_push(now_ns()))
+                        std::this_thread::yield();
+            }));
+        for (int c = 0; c < consumers; ++c)
+            workers.push_back(std::thread([&, c]() {
+                unsigned long long sent;
+                waits[c].reserve(items / consumers + 1);
+                while (received.load(std::memory_order_relaxed) < items) {
+                    if (channel.try_pop(sent)) {
+                        waits[c].push_back(now_ns() - sent);
+                        received.fetch_add(1, std::memory_order_relaxed);
+                    }
+                    else
+                        std::this_thread::yield();
+                }
+            }));
+        for (size_t i = 0; i < workers.size(); ++i)
+            workers[i].join();
+
+        double t = now() - start;
+        std::vector<unsigned long long> all;
+        for (int c = 0; c < consumers; ++c)
+            all.insert(all.end(), waits[c].begin(), waits[c].end());
+        std::nth_element(all.begin(), all.begin() + all.size() * 99 / 100, all.end());
+        std::cout << std::setw(24) << name << std::setw(4) << producers << "x" << std::left << std::setw(4)
+                  << consumers << std::right << std::setw(12) << std::fixed << std::setprecision(2)
+                  << items / t / 1e6 << std::setw(14) << all[all.size() * 99 / 100] / 1e3 << std::endl;
+    }
+
+    void bench_ring() {
+        const size_t items = 1 << 20;
+        const int counts[] = {1, 2, 4};
+
+        std::cout << std::setw(24) << "capacity 1024" << std::setw(9) << "p x c" << std::setw(12) << "Mops/s"
+                  << std::setw(14) << "p99 wait us" << std::endl;
+        pipeline<ft::mpmc_ring<unsigned long long, ft::spsc_tag> >("spsc ring", 1, 1, items);
+        for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); ++c) {
+            pipeline<ft::mpmc_ring<unsigned long long> >("mpmc ring", counts[c], counts[c], items);
+            pipeline<locked_queue<unsigned long long> >("mutex + ft::queue", counts[c], counts[c], items);
+        }
+    }
+
+    size_t spawn_tree(ft::thread_pool &pool, size_t n) {
+        if (n == 1)
+            return 1;
+        size_t a;
+        size_t b;
+        pool.invoke([&]() { a = spawn_tree(pool, n / 2); }, [&]() { b = spawn_tree(pool, n - n / 2); });
+        return a + b;
+    }
+
+    // Work of index i: a few units for most, thousands for one in 64, so equal static chunks end unevenly.
+    size_t irregular(size_t i) {
+        size_t units = i % 64 ? 4 : 4096;
+        size_t total = i;
+
+        for (size_t k = 0; k < units * 64; ++k)
+            total = total * 6364136223846793005ULL + 1442695040888963407ULL;
+        return total;
+    }
+
+    // Cost of a fork/join with empty tasks, then an irregular loop through parallel_for against the
+    // same loop cut into one equal chunk per thread, for a pool of one thread and of four.
+    void bench_thread_pool() {
+        const size_t leaves = 1 << 20;
+        const size_t items = 1 << 14;
+
+        double t = best_of(3, [&]() {
+            std::thread th([]() { sink = 1; });
+            th.join();
+        });
+        std::cout << "std::thread create and join: " << std::fixed << std::setprecision(1) << t * 1e9 << " ns"
+                  << std::endl;
+        double serial = best_of(3, [&]() {
+            size_t total = 0;
+            for (size_t i = 0; i < items; ++i)
+                total += irregular(i);
+            sink = total;
+        });
+        std::cout << "irregular loop serial: " << serial * 1e3 << " ms" << std::endl;
+        for (size_t threads = 1; threads <= 4; threads *= 4) {
+            ft::thread_pool pool(threads);
+            t = best_of(3, [&]() { sink = spawn_tree(pool, leaves); });
+            std::cout << "pool of " << threads << ": " << t * 1e9 / (leaves - 1) << " ns per invoke of two empty tasks";
+            double stolen = best_of(3, [&]() {
+                std::atomic<size_t> total(0);
+                pool.parallel_for(0, items, [&](size_t first, size_t last) {
+                    size_t part = 0;
+                    for (size_t i = first; i < last; ++i)
+                        part += irregular(i);
+                    total += part;
+                });
+                sink = total;
+            });
+            double chunked = run_threads(int(threads), [&](int k) {
+                size_t part = 0;
+                for (size_t i = items * k / threads; i < items * (k + 1) / threads; ++i)
+                    part += irregular(i);
+                sink = part;
+            });
+            std::cout << ", irregular loop " << stolen * 1e3 << " ms through parallel_for, " << chunked * 1e3
+                      << " ms in equal chunks" << std::endl;
+        }
+    }
+
+    // Fills a 256 MiB vector from one thread or through the pool, then sums it with parallel_for.
+    template <class Alloc>
+    void scan(const char *name, const Alloc &alloc, bool parallel_fill, ft::thread_pool &pool) {
+        const size_t n = (256 << 20) / sizeof(size_t);
+        ft::vector<size_t, Alloc> v(alloc);
+
+        double fill = now();
+        if (parallel_fill)
+            v.assign(n, 1, pool);
+        else {
+            v.reserve(n);
+            for (size_t i = 0; i < n; ++i)
+                v.push_back(1);
+        }
+        fill = now() - fill;
+        const size_t *data = &v[0];
+        double t = best_of(5, [&]() {
+            std::atomic<size_t> total(0);
+            pool.parallel_for(0, n, [&](size_t first, size_t last) {
+                size_t part = 0;
+                for (size_t i = first; i < last; ++i)
+                    part += data[i];
+                total += part;
+            }, n / pool.size() + 1);
+            sink = total;
+        });
+        std::cout << std::setw(36) << name << std::setw(12) << std::fixed << std::setprecision(1) << fill * 1e3
+                  << std::setw(14) << n * sizeof(size_t) / t / 1e9 << std::endl;
+    }
+
+    void bench_first_touch() {
+        ft::thread_pool pool;
+
+        std::cout << std::setw(36) << "256 MiB, pool of " + std::to_string(pool.size()) << std::setw(12) << "fill ms"
+                  << std::setw(14) << "scan GB/s" << std::endl;
+        scan("std::allocator, serial fill", std::allocator<size_t>(), false, pool);
+        scan("std::allocator, parallel fill", std::allocator<size_t>(), true, pool);
+        scan("numa first touch, parallel fill", ft::numa_allocator<size_t>(ft::numa_first_touch), true, pool);
+        scan("numa local, serial fill", ft::numa_allocator<size_t>(ft::numa_local), false, pool);
+        scan("numa interleave, serial fill", ft::numa_allocator<size_t>(ft::numa_interleave), false, pool);
+    }
+
+    // Best time of threads threads each calling append(log, thread) on a fresh Log; building and
+    // destroying the log stay outside the timing.
+    template <class Log, class F>
+    double append_run(int threads, F append) {
+        double best = 1e30;
+
+        for (int rep = 0; rep < 3; ++rep) {
+            Log log;
+            std::vector<std::thread> workers;
+            double start = now();
+            for (int t = 0; t < threads; ++t)
+                workers.push_back(std::thread([&, t]() { append(log, t); }));
+            for (int t = 0; t < threads; ++t)
+                workers[t].join();
+            best = std::min(best, now() - start);
+        }
+        return best;
+    }
+
+    struct locked_vector{
+        ft::vector<size_t> values;
+        std::mutex lock;
+    };
+
+    // Appends 4M values split over the threads: one at a time, in runs of 64 through grow_by, and
+    // through ft::vector::push_back behind a mutex.
+    void bench_concurrent_vector() {
+        const size_t total = 1 << 22;
+        const int counts[] = {1, 2, 4, 8};
+
+        std::cout << std::setw(8) << "threads" << std::setw(14) << "push_back" << std::setw(14) << "grow_by(64)"
+                  << std::setw(22) << "mutex + ft::vector" << "   (M appends/s)" << std::endl;
+        for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); ++c) {
+            const int threads = counts[c];
+            const size_t per_thread = total / threads;
+            double t_push = append_run<ft::concurrent_vector<size_t> >(threads,
+                [&](ft::concurrent_vector<size_t> &log, int) {
+                    for (size_t i = 0; i < per_thread; ++i)
+                        log.push_back(i);
+                });
+            double t_grow = append_run<ft::concurrent_vector<size_t> >(threads,
+                [&](ft::concurrent_vector<size_t> &log, int) {
+                    for (size_t i = 0; i < per_thread; i += 64)
+                        log.grow_by(64, i);
+                });
+            double t_locked = append_run<locked_vector>(threads, [&](locked_vector &log, int) {
+                for (size_t i = 0; i < per_thread; ++i) {
+                    std::lock_guard<std::mutex> guard(log.lock);
+                    log.values.push_back(i);
+                }
+            });
+            std::cout << std::setw(8) << threads << std::setw(14) << std::fixed << std::setprecision(1)
+                      << total / t_push / 1e6 << std::setw(14) << total / t_grow / 1e6 << std::setw(22)
+                      << total / t_locked / 1e6 << std::endl;
+        }
+    }
+
+    struct locked_map{
+        ft::map<unsigned, unsigned> map;
+        std::mutex lock;
+    };
+
+    // 1M distinct random keys split over the threads, inserted one at a time into a 16-shard map, in
+    // batches of 256 into it, and one at a time into an ft::map behind a mutex.
+    void bench_sharded_map() {
+        const size_t total = 1 << 20;
+        const int counts[] = {1, 2, 4, 8};
+        std::vector<ft::pair<unsigned, unsigned> > keys;
+        unsigned state = 99;
+
+        for (size_t i = 0; i < total; ++i)
+            keys.push_back(ft::make_pair(next_random(state), unsigned(i)));
+        std::cout << std::setw(8) << "threads" << std::setw(14) << "sharded" << std::setw(16) << "sharded batch"
+                  << std::setw(20) << "mutex + ft::map" << "   (M inserts/s)" << std::endl;
+        for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); ++c) {
+            const int threads = counts[c];
+            typedef ft::sharded_map<unsigned, unsigned, 16> sharded;
+            double t_single = append_run<sharded>(threads, [&](sharded &m, int t) {
+                for (size_t i = total * t / threads; i < total * (t + 1) / threads; ++i)
+                    m.insert(keys[i]);
+            });
+            double t_batch = append_run<sharded>(threads, [&](sharded &m, int t) {
+                for (size_t i = total * t / threads; i < total * (t + 1) / threads; i += 256)
+                    m.insert(keys.begin() + i, keys.begin() + std::min(i + 256, total * (t + 1) / threads));
+            });
+            double t_locked = append_run<locked_map>(threads, [&](locked_map &m, int t) {
+                for (size_t i = total * t / threads; i < total * (t + 1) / threads; ++i) {
+                    std::lock_guard<std::mutex> guard(m.lock);
+                    m.map.insert(keys[i]);
+                }
+            });
+            std::cout << std::setw(8) << threads << std::setw(14) << std::fixed << std::setprecision(2)
+                      << total / t_single / 1e6 << std::setw(16) << total / t_batch / 1e6 << std::setw(20)
+                      << total / t_locked / 1e6 << std::endl;
+        }
+    }
+
+    // Checkpoint and warm restart of 256 MiB of buffers: element by element through iostreams and
+    // push_back, against ft::save / ft::load and a mapped_vector_view. The file stays in the page cache,
+    // so this is the copy cost, not the disk.
+    void bench_vector_io() {
+        const size_t count = (256 << 20) / sizeof(buffer);
+        const char *path = "/tmp/ft_bench_vector_io";
+        ft::vector<buffer> pool;
+        buffer b;
+
+        std::memset(&b, 0, sizeof(b));
+        for (size_t i = 0; i < count; ++i) {
+            b.idx = int(i);
+            pool.push_back(b);
+        }
+        double stream_save = best_of(3, [&]() {
+            std::ofstream out(path, std::ios::binary);
+            for (size_t i = 0; i < pool.size(); ++i)
+                out.write(reinterpret_cast<const char *>(&pool[i]), sizeof(buffer));
+        });
+        double stream_load = best_of(3, [&]() {
+            std::ifstream in(path, std::ios::binary);
+            ft::vector<buffer> back;
+            while (in.read(reinterpret_cast<char *>(&b), sizeof(b)))
+                back.push_back(b);
+            sink = back.size();
+        });
+        double bulk_save = best_of(3, [&]() {
+            int fd = ::open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+            ft::save(pool, fd);
+            ::close(fd);
+        });
+        double bulk_load = best_of(3, [&]() {
+            int fd = ::open(path, O_RDONLY);
+            ft::vector<buffer> back;
+            ft::load(back, fd);
+            ::close(fd);
+            sink = back.size();
+        });
+        double view_open = best_of(3, [&]() {
+            ft::mapped_vector_view<buffer> view(path);
+            sink = view.size();
+        });
+        double view_scan = best_of(3, [&]() {
+            ft::mapped_vector_view<buffer> view(path);
+            size_t total = 0;
+            for (size_t i = 0; i < view.size(); ++i)
+                total += view[i].idx;
+            sink = total;
+        });
+        std::remove(path);
+        std::cout << std::fixed << std::setprecision(1) << "256 MiB, ms      save      load" << std::endl
+                  << "iostream  " << std::setw(14) << stream_save * 1e3 << std::setw(10) << stream_load * 1e3
+                  << std::endl << "save/load " << std::setw(14) << bulk_save * 1e3 << std::setw(10)
+                  << bulk_load * 1e3 << std::endl << "mapped view: open " << view_open * 1e3
+                  << ", open and touch every element " << view_scan * 1e3 << std::endl;
+    }
+
+    struct record{
+        unsigned long long key;
+        unsigned long long payload;
+    };
+
+    struct record_less{
+        bool operator()(const record &a, const record &b) const {
+            return a.key < b.key;
+        }
+    };
+
+    // Runs f, which returns the seconds it measured, in a child process and returns those seconds
+    // with the child's peak resident size in MiB, so each sort is measured on its own rather than
+    // against the high-water mark of everything before it.
+    template <class F>
+    double in_child(F f, double *peak) {
+        int ends[2];
+        double seconds = -1;
+
+        if (::pipe(ends))
+            return -1;
+        pid_t child = fork();
+        if (!child) {
+            seconds = f();
+            ft::vector_io_detail::write_all(ends[1], &seconds, sizeof(seconds));
+            _exit(0);
+        }
+        ::close(ends[1]);
+        if (ft::vector_io_detail::read_some(ends[0], &seconds, sizeof(seconds)) != sizeof(seconds))
+            seconds = -1;
+        ::close(ends[0]);
+        int status;
+        struct rusage usage;
+        if (wait4(child, &status, 0, &usage) != child || !WIFEXITED(status) || WEXITSTATUS(status))
+            return -1;
+        *peak = usage.ru_maxrss / 1024.0;
+        return seconds;
+    }
+
+    // Sorts path into a scratch file with external_sort; returns the seconds taken.
+    template <class T, class Compare>
+    double sort_file(const char *path, size_t budget, Compare comp) {
+        int in = ::open(path, O_RDONLY);
+        int out = ::open("/tmp/ft_bench_sorted", O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        double start = now();
+        ft::external_sort<T>(in, out, budget, comp);
+        double t = now() - start;
+        ::close(in);
+        ::close(out);
+        return t;
+    }
+
+    // 160 MiB of random records through external_sort with a 16 MiB budget (one merge pass) and a
+    // 1 MiB budget (several), as 16-byte records by key and as bare 8-byte keys, which radix sort.
+    // Each sort runs in a child process so its peak resident size can be read; the baseline row is
+    // the same read, std::sort and write with the whole input in memory.
+    void bench_external_sort() {
+        const size_t input = 160 << 20;
+        const char *path = "/tmp/ft_bench_unsorted";
+        std::vector<record> chunk(1 << 16);
+        unsigned state = 4242;
+        int fd = ::open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+        for (size_t done = 0; done < input; done += chunk.size() * sizeof(record)) {
+            for (size_t i = 0; i < chunk.size(); ++i) {
+                chunk[i].key = (static_cast<unsigned long long>(next_random(state)) << 32) | next_random(state);
+                chunk[i].payload = done + i;
+            }
+            ft::vector_io_detail::write_all(fd, &chunk[0], chunk.size() * sizeof(record));
+        }
+        ::close(fd);
+        std::vector<record>().swap(chunk);
+
+        const size_t budgets[] = {16 << 20, 1 << 20};
+        double idle = 0;
+        double peak = 0;
+        in_child([]() { return 0.0; }, &idle);
+        std::cout << "160 MiB input, page cache warm; peak RSS is the child's, minus " << std::fixed
+                  << std::setprecision(1) << idle << " MiB for an idle child" << std::endl
+                  << std::setw(28) << "sort" << std::setw(12) << "budget" << std::setw(10) << "s" << std::setw(10)
+                  << "MB/s" << std::setw(16) << "peak RSS MiB" << std::endl;
+        for (size_t b = 0; b < 2; ++b)
+            for (int keys = 0; keys < 2; ++keys) {
+                double t = in_child([&]() {
+                    return keys ? sort_file<unsigned long long>(path, budgets[b], ft::less<unsigned long long>())
+                                : sort_file<record>(path, budgets[b], record_less());
+                }, &peak);
+                std::cout << std::setw(28) << (keys ? "external_sort, 8 B keys" : "external_sort, 16 B records")
+                          << std::setw(8) << (budgets[b] >> 20) << " MiB" << std::setw(10) << std::setprecision(2)
+                          << t << std::setw(10) << std::setprecision(0) << input / t / 1e6 << std::setw(16)
+                          << std::setprecision(1) << peak - idle << std::endl;
+            }
+        double t = in_child([&]() {
+            std::vector<record> all(input / sizeof(record));
+            int in = ::open(path, O_RDONLY);
+            int out = ::open("/tmp/ft_bench_sorted", O_WRONLY | O_CREAT | O_TRUNC, 0644);
+            double start = now();
+            ft::vector_io_detail::read_all(in, &all[0], input);
+            std::sort(all.begin(), all.end(), record_less());
+            ft::vector_io_detail::write_all(out, &all[0], input);
+            double t = now() - start;
+            ::close(in);
+            ::close(out);
+            return t;
+        }, &peak);
+        std::cout << std::setw(28) << "in memory, std::sort" << std::setw(12) << "-" << std::setw(10)
+                  << std::setprecision(2) << t << std::setw(10) << std::setprecision(0) << input / t / 1e6
+                  << std::setw(16) << std::setprecision(1) << peak - idle << std::endl;
+        std::remove(path);
+        std::remove("/tmp/ft_bench_sorted");
+    }
+
+    typedef ft::set<unsigned, ft::less<unsigned>, counting_allocator<unsigned> > counted_set;
+
+    // a | b, a & b and a - b through std:: algorithms over ft::set, rebuilt into ft::sets.
+    double tree_ops(const counted_set &a, const counted_set &b) {
+        return best_of(3, [&]() {
+            std::vector<unsigned> out;
+            size_t total = 0;
+            std::set_union(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(out));
+            total += counted_set(out.begin(), out.end()).size();
+            out.clear();
+            std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(out));
+            total += counted_set(out.begin(), out.end()).size();
+            out.clear();
+            std::set_difference(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(out));
+            total += counted_set(out.begin(), out.end()).size();
+            sink = total;
+        });
+    }
+
+    double roaring_ops(const ft::roaring_set &a, const ft::roaring_set &b) {
+        return best_of(3, [&]() { sink = (a | b).size() + (a & b).size() + (a - b).size(); });
+    }
+
+    // Two sets of 1M ids each, dense (80% of a range), clustered in runs of 1000, and spread over
+    // all 32 bits: bytes per element, then the time of union, intersection and difference together.
+    void bench_roaring_set() {
+        const size_t n = 1 << 20;
+        const char *shapes[] = {"dense 80%", "runs of 1000", "sparse"};
+
+        std::cout << std::setw(14) << "1M ids" << std::setw(14) << "set B/elem" << std::setw(16) << "roaring B/elem"
+                  << std::setw(12) << "set ops ms" << std::setw(16) << "roaring ops ms" << std::endl;
+        for (int shape = 0; shape < 3; ++shape) {
+            std::vector<unsigned> ids[2];
+            unsigned state = 777;
+            for (int k = 0; k < 2; ++k) {
+                std::set<unsigned> seen;
+                while (seen.size() < n) {
+                    unsigned r = next_random(state);
+                    if (shape == 0)
+                        seen.insert(r % (n * 5 / 4));
+                    else if (shape == 1)
+                        for (unsigned i = 0; i < 1000 && seen.size() < n; ++i)
+                            seen.insert((r % 4096) * 4096 + i);
+                    else
+                        seen.insert(r);
+                }
+                ids[k].assign(seen.begin(), seen.end());
+            }
+            allocated_bytes = 0;
+            counted_set a(ids[0].begin(), ids[0].end());
+            double tree_bytes = double(allocated_bytes) / n;
+            counted_set b(ids[1].begin(), ids[1].end());
+            ft::roaring_set ra(ids[0].begin(), ids[0].end());
+            ft::roaring_set rb(ids[1].begin(), ids[1].end());
+            ra.run_optimize();
+            rb.run_optimize();
+            std::cout << std::setw(14) << shapes[shape] << std::setw(14) << std::fixed << std::setprecision(2)
+                      << tree_bytes << std::setw(16) << double(ra.memory_bytes()) / n << std::setw(12)
+                      << std::setprecision(1) << tree_ops(a, b) * 1e3 << std::setw(16) << std::setprecision(2)
+                      << roaring_ops(ra, rb) * 1e3 << std::endl;
+        }
+    }
+
+    struct order_name{
+        char text[52];
+    };
+
+    // A 64-byte record of which a scan needs only the price.
+    struct order{
+        double price;
+        int quantity;
+        order_name name;
+    };
+
+    // Sums the price of n records held as an ft::vector of structs and as an soa_vector column, in and
+    // out of cache. GB/s counts only the price bytes, the ones the scan needs.
+    void bench_soa_vector() {
+        const size_t sizes[] = {1 << 12, 1 << 22};
+
+        std::cout << std::setw(12) << "records" << std::setw(16) << "AoS GB/s" << std::setw(16) << "SoA GB/s"
+                  << std::setw(16) << "AoS ns/elem" << std::setw(16) << "SoA ns/elem" << std::endl;
+        for (size_t s = 0; s < 2; ++s) {
+            const size_t n = sizes[s];
+            const int reps = n < (1 << 20) ? 2000 : 5;
+            ft::vector<order> aos;
+            ft::soa_vector<double, int, order_name> soa;
+            order o;
+            std::memset(&o, 0, sizeof(o));
+            for (size_t i = 0; i < n; ++i) {
+                o.price = double(i % 1000) / 8;
+                o.quantity = int(i);
+                aos.push_back(o);
+            }
+            soa.resize(n);
+            for (size_t i = 0; i < n; ++i) {
+                soa.field<0>()[i] = double(i % 1000) / 8;
+                soa.field<1>()[i] = int(i);
+            }
+            double t_aos = best_of(3, [&]() {
+                double total = 0;
+                for (int r = 0; r < reps; ++r) {
+                    const order *data = &aos[0];
+                    for (size_t i = 0; i < n; ++i)
+                        total += data[i].price;
+                }
+                sink = size_t(total);
+            }) / reps;
+            double t_soa = best_of(3, [&]() {
+                double total = 0;
+                for (int r = 0; r < reps; ++r) {
+                    const double *data = soa.data<0>();
+                    for (size_t i = 0; i < n; ++i)
+                        total += data[i];
+                }
+                sink = size_t(total);
+            }) / reps;
+            std::cout << std::setw(12) << n << std::setw(16) << std::fixed << std::setprecision(2)
+                      << n * sizeof(double) / t_aos / 1e9 << std::setw(16) << n * sizeof(double) / t_soa / 1e9
+                      << std::setw(16) << t_aos * 1e9 / n << std::setw(16) << t_soa * 1e9 / n << std::endl;
+        }
+    }
+
+    struct benchmark{
+        const char *name;
+        void (*run)();
+    };
+
+    const benchmark benchmarks[] = {
+        {"find_many", bench_find_many},
+        {"small_vector", bench_small_vector},
+        {"stack", bench_stack},
+        {"concurrent_stack", bench_concurrent_stack},
+        {"ring", bench_ring},
+        {"thread_pool", bench_thread_pool},
+        {"first_touch", bench_first_touch},
+        {"concurrent_vector", bench_concurrent_vector},
+        {"sharded_map", bench_sharded_map},
+        {"vector_io", bench_vector_io},
+        {"external_sort", bench_external_sort},
+        {"roaring_set", bench_roaring_set},
+        {"soa_vector", bench_soa_vector},
+    };
+}
+
+int main(int argc, char **argv) {
+    for (size_t i = 0; i < sizeof(benchmarks) / sizeof(benchmarks[0]); ++i) {
+        bool wanted = argc < 2;
+        for (int a = 1; a < argc; ++a)
+            wanted |= !std::strcmp(argv[a], benchmarks[i].name);
+        if (!wanted)
+            continue;
+        std::cout << "== " << benchmarks[i].name << std::endl;
+        benchmarks[i].run();
+    }
+    return 0;
+}
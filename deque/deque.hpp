@@ -0,0 +1,523 @@
+#pragma once
+
+#include <memory>
+#include <cstddef>
+#include <stdexcept>
+#include "../utils/iterator_traits.hpp"
+#include "../utils/is_integral.hpp"
+#include "../utils/enable_if.hpp"
+#include "../utils/utils.hpp"
+#include "../utils/switch_const.hpp"
+#include "../utils/chunk_shift.hpp"
+
+namespace ft{
+    template <typename T, typename Deque>
+    class deque_iterator{
+    public:
+        typedef std::random_access_iterator_tag iterator_category;
+        typedef typename ft::switch_const<T>::type value_type;
+        typedef ptrdiff_t difference_type;
+        typedef T *pointer;
+        typedef T &reference;
+
+        deque_iterator() : deque_(0), index_(0) {}
+
+        deque_iterator(const Deque *deque, size_t index) : deque_(deque), index_(index) {}
+
+        size_t index() const {
+            return index_;
+        }
+
+        reference operator*() const {
+            return *deque_->slot(index_);
+        }
+
+        pointer operator->() const {
+            return deque_->slot(index_);
+        }
+
+        reference operator[](difference_type n) const {
+            return *deque_->slot(index_ + n);
+        }
+
+        deque_iterator &operator++() {
+            ++index_;
+            return *this;
+        }
+
+        deque_iterator operator++(int) {
+            deque_iterator tmp = *this;
+            ++index_;
+            return tmp;
+        }
+
+        deque_iterator &operator--() {
+            --index_;
+            return *this;
+        }
+
+        deque_iterator operator--(int) {
+            deque_iterator tmp = *this;
+            --index_;
+            return tmp;
+        }
+
+        deque_iterator &operator+=(difference_type n) {
+            index_ += n;
+            return *this;
+        }
+
+        deque_iterator &operator-=(difference_type n) {
+            index_ -= n;
+            return *this;
+        }
+
+        deque_iterator operator+(difference_type n) const {
+            return deque_iterator(deque_, index_ + n);
+        }
+
+        deque_iterator operator-(difference_type n) const {
+            return deque_iterator(deque_, index_ - n);
+        }
+
+        difference_type operator-(const deque_iterator &it) const {
+            return difference_type(index_) - difference_type(it.index_);
+        }
+
+        bool operator==(const deque_iterator &it) const {
+            return index_ == it.index_;
+        }
+
+        bool operator!=(const deque_iterator &it) const {
+            return index_ != it.index_;
+        }
+
+        bool operator<(const deque_iterator &it) const {
+            return index_ < it.index_;
+        }
+
+        bool operator>(const deque_iterator &it) const {
+            return index_ > it.index_;
+        }
+
+        bool operator<=(const deque_iterator &it) const {
+            return index_ <= it.index_;
+        }
+
+        bool operator>=(const deque_iterator &it) const {
+            return index_ >= it.index_;
+        }
+
+        operator deque_iterator<const T, Deque>() const {
+            return deque_iterator<const T, Deque>(deque_, index_);
+        }
+
+    private:
+        const Deque *deque_;
+        size_t index_;
+    };
+
+    // Fixed-size blocks reached through a circular map of block pointers; one emptied block is kept for reuse.
+    template <typename T, typename Alloc = std::allocator<T> >
+    class deque{
+        public:
+            typedef T value_type;
+            typedef Alloc allocator_type;
+            typedef typename allocator_type::reference reference;
+            typedef typename allocator_type::const_reference const_reference;
+            typedef typename allocator_type::const_pointer const_pointer;
+            typedef typename allocator_type::pointer pointer;
+            typedef typename allocator_type::size_type size_type;
+            typedef ft::deque_iterator<value_type, deque> iterator;
+            typedef ft::deque_iterator<const value_type, deque> const_iterator;
+            typedef ft::reverse_iterator<iterator> reverse_iterator;
+            typedef ft::reverse_iterator<const_iterator> const_reverse_iterator;
+            typedef typename iterator::difference_type difference_type;
+            typedef typename Alloc::template rebind<pointer>::other map_allocator_type;
+
+            static const size_type block_shift = ft::chunk_shift<T, 4096>::value;
+            static const size_type block_size = size_type(1) << block_shift;
+
+            explicit deque(const allocator_type &allocator = allocator_type())
+                : allocator_(allocator), map_(0), map_size_(0), head_(0), blocks_(0), start_(0), size_(0), spare_(0) {}
+
+            explicit deque(size_type n, const value_type &val = value_type(), const allocator_type &allocator = allocator_type())
+                : allocator_(allocator), map_(0), map_size_(0), head_(0), blocks_(0), start_(0), size_(0), spare_(0) {
+                assign(n, val);
+            }
+
+            template<class TemplateIterator>
+            deque(TemplateIterator first, TemplateIterator last, const allocator_type &allocator = allocator_type(),
+                   typename ft::enable_if<!ft::is_integral<TemplateIterator>::value>::type* = 0)
+                : allocator_(allocator), map_(0), map_size_(0), head_(0), blocks_(0), start_(0), size_(0), spare_(0) {
+                assign(first, last);
+            }
+
+            deque(const deque &x)
+                : allocator_(x.allocator_), map_(0), map_size_(0), head_(0), blocks_(0), start_(0), size_(0), spare_(0) {
+                assign(x.begin(), x.end());
+            }
+
+            ~deque() {
+                clear();
+                if (spare_)
+                    allocator_.deallocate(spare_, block_size);
+                if (map_)
+                    map_allocator_.deallocate(map_, map_size_);
+            }
+
+            deque &operator=(const deque &x) {
+                if (&x != this)
+                    assign(x.begin(), x.end());
+                return *this;
+            }
+
+            iterator begin() {
+                return iterator(this, 0);
+            }
+
+            const_iterator begin() const {
+                return const_iterator(this, 0);
+            }
+
+            iterator end() {
+                return iterator(this, size_);
+            }
+
+            const_iterator end() const {
+                return const_iterator(this, size_);
+            }
+
+            reverse_iterator rbegin() {
+                return reverse_iterator(end());
+            }
+
+            const_reverse_iterator rbegin() const {
+                return const_reverse_iterator(end());
+            }
+
+            reverse_iterator rend() {
+                return reverse_iterator(begin());
+            }
+
+            const_reverse_iterator rend() const {
+                return const_reverse_iterator(begin());
+            }
+
+            size_type size() const {
+                return size_;
+            }
+
+            size_type max_size() const {
+                return allocator_.max_size();
+            }
+
+            bool empty() const {
+                return !size_;
+            }
+
+            void resize(size_type n, value_type val = value_type()) {
+                while (size_ > n)
+                    pop_back();
+                while (size_ < n)
+                    push_back(val);
+            }
+
+            const_reference operator[](size_type n) const {
+                return *slot(n);
+            }
+
+            reference operator[](size_type n) {
+                return *slot(n);
+            }
+
+            const_reference at(size_type n) const {
+                if (n < size_)
+                    return *slot(n);
+                throw std::out_of_range("Error: position_ out of range");
+            }
+
+            reference at(size_type n) {
+                if (n < size_)
+                    return *slot(n);
+                throw std::out_of_range("Error: position_ out of range");
+            }
+
+            const_reference front() const {
+                return *slot(0);
+            }
+
+            reference front() {
+                return *slot(0);
+            }
+
+            const_reference back() const {
+                return *slot(size_ - 1);
+            }
+
+            reference back() {
+                return *slot(size_ - 1);
+            }
+
+            template<class TemplateIterator>
+            void assign(TemplateIterator first, TemplateIterator last, typename ft::enable_if<!ft::is_integral<TemplateIterator>::value>::type* = 0) {
+                clear();
+                for (; first != last; ++first)
+                    push_back(*first);
+            }
+
+            void assign(size_type n, const value_type &val) {
+                clear();
+                resize(n, val);
+            }
+
+            void push_back(const value_type &val) {
+                if (start_ + size_ == blocks_ << block_shift) {
+                    value_type copy(val);
+                    add_block(false);
+                    allocator_.construct(slot(size_), copy);
+                }
+                else
+                    allocator_.construct(slot(size_), val);
+                ++size_;
+            }
+
+            void push_front(const value_type &val) {
+                if (!start_) {
+                    value_type copy(val);
+                    add_block(true);
+                    allocator_.construct(slot_at(start_ - 1), copy);
+                }
+                else
+                    allocator_.construct(slot_at(start_ - 1), val);
+                --start_;
+                ++size_;
+            }
+
+            void pop_back() {
+                if (!size_)
+                    return;
+                allocator_.destroy(slot(--size_));
+                if (!size_)
+                    release_all();
+                else if (start_ + size_ <= (blocks_ - 1) << block_shift)
+                    release_block(map_[(head_ + --blocks_) & (map_size_ - 1)]);
+            }
+
+            void pop_front() {
+                if (!size_)
+                    return;
+                allocator_.destroy(slot(0));
+                ++start_;
+                --size_;
+                if (!size_)
+                    release_all();
+                else if (start_ == block_size) {
+                    release_block(map_[head_]);
+                    head_ = (head_ + 1) & (map_size_ - 1);
+                    --blocks_;
+                    start_ = 0;
+                }
+            }
+
+            iterator insert(iterator position, const value_type &val) {
+                size_type dist = position - begin();
+                insert(position, 1, val);
+                return begin() + dist;
+            }
+
+            void insert(iterator position, size_type n, const value_type &val) {
+                size_type dist = position - begin();
+                value_type copy(val);
+
+                if (dist < size_ / 2) {
+                    for (size_type i = 0; i < n; ++i)
+                        push_front(copy);
+                    rotate(0, n, n + dist);
+                }
+                else {
+                    size_type old = size_;
+                    for (size_type i = 0; i < n; ++i)
+                        push_back(copy);
+                    rotate(dist, old, size_);
+                }
+            }
+
+            template<class TemplateIterator>
+            void insert(iterator position, TemplateIterator first, TemplateIterator last, typename ft::enable_if<!ft::is_integral<TemplateIterator>::value>::type* = 0) {
+                size_type dist = position - begin();
+                size_type old = size_;
+
+                if (dist < size_ / 2) {
+                    for (; first != last; ++first)
+                        push_front(*first);
+                    reverse(0, size_ - old);
+                    rotate(0, size_ - old, size_ - old + dist);
+                }
+                else {
+                    for (; first != last; ++first)
+                        push_back(*first);
+                    rotate(dist, old, size_);
+                }
+            }
+
+            iterator erase(iterator position) {
+                return erase(position, position + 1);
+            }
+
+            iterator erase(iterator first, iterator last) {
+                size_type from = first - begin();
+                size_type n = last - first;
+
+                if (from < size_ - from - n) {
+                    for (size_type i = from; i-- > 0;)
+                        *slot(i + n) = *slot(i);
+                    for (size_type i = 0; i < n; ++i)
+                        pop_front();
+                }
+                else {
+                    for (size_type i = from + n; i < size_; ++i)
+                        *slot(i - n) = *slot(i);
+                    for (size_type i = 0; i < n; ++i)
+                        pop_back();
+                }
+                return begin() + from;
+            }
+
+            void clear() {
+                while (size_)
+                    pop_back();
+            }
+
+            allocator_type get_allocator() const {
+                return allocator_;
+            }
+
+            void swap(deque &x) {
+                ft::swap(map_, x.map_);
+                ft::swap(map_size_, x.map_size_);
+                ft::swap(head_, x.head_);
+                ft::swap(blocks_, x.blocks_);
+                ft::swap(start_, x.start_);
+                ft::swap(size_, x.size_);
+                ft::swap(spare_, x.spare_);
+            }
+
+        private:
+            template <typename, typename>
+            friend class ft::deque_iterator;
+
+            allocator_type allocator_;
+            map_allocator_type map_allocator_;
+            pointer *map_;
+            size_type map_size_;
+            size_type head_;
+            size_type blocks_;
+            size_type start_;
+            size_type size_;
+            pointer spare_;
+
+            pointer slot(size_type n) const {
+                return slot_at(start_ + n);
+            }
+
+            // `position` counts from the first slot of the first block.
+            pointer slot_at(size_type position) const {
+                return map_[(head_ + (position >> block_shift)) & (map_size_ - 1)] + (position & (block_size - 1));
+            }
+
+            void add_block(bool front) {
+                pointer block = spare_;
+
+                if (blocks_ == map_size_)
+                    grow_map();
+                if (block)
+                    spare_ = 0;
+                else
+                    block = allocator_.allocate(block_size);
+                if (front) {
+                    head_ = (head_ + map_size_ - 1) & (map_size_ - 1);
+                    map_[head_] = block;
+                    start_ += block_size;
+                }
+                else
+                    map_[(head_ + blocks_) & (map_size_ - 1)] = block;
+                ++blocks_;
+            }
+
+            void grow_map() {
+                size_type size = map_size_ ? map_size_ * 2 : 8;
+                pointer *map = map_allocator_.allocate(size);
+
+                for (size_type i = 0; i < blocks_; ++i)
+                    map[i] = map_[(head_ + i) & (map_size_ - 1)];
+                if (map_)
+                    map_allocator_.deallocate(map_, map_size_);
+                map_ = map;
+                map_size_ = size;
+                head_ = 0;
+            }
+
+            void release_block(pointer block) {
+                if (spare_)
+                    allocator_.deallocate(block, block_size);
+                else
+                    spare_ = block;
+            }
+
+            void release_all() {
+                while (blocks_) {
+                    release_block(map_[head_]);
+                    head_ = (head_ + 1) & (map_size_ - 1);
+                    --blocks_;
+                }
+                start_ = 0;
+            }
+
+            void reverse(size_type first, size_type last) {
+                while (first < last && first < --last)
+                    ft::swap(*slot(first++), *slot(last));
+            }
+
+            void rotate(size_type first, size_type middle, size_type last) {
+                reverse(first, middle);
+                reverse(middle, last);
+                reverse(first, last);
+            }
+    };
+
+    template<class T, class Alloc>
+    bool operator==(const ft::deque<T, Alloc> &lhs, const ft::deque<T, Alloc> &rhs) {
+        return lhs.size() == rhs.size() && ft::equal(lhs.begin(), lhs.end(), rhs.begin());
+    }
+
+    template<class T, class Alloc>
+    bool operator!=(const ft::deque<T, Alloc> &lhs, const ft::deque<T, Alloc> &rhs) {
+        return !(lhs == rhs);
+    }
+
+    template<class T, class Alloc>
+    bool operator<(const ft::deque<T, Alloc> &lhs, const ft::deque<T, Alloc> &rhs) {
+        return ft::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+
+    template<class T, class Alloc>
+    bool operator>(const ft::deque<T, Alloc> &lhs, const ft::deque<T, Alloc> &rhs) {
+        return rhs < lhs;
+    }
+
+    template<class T, class Alloc>
+    bool operator<=(const ft::deque<T, Alloc> &lhs, const ft::deque<T, Alloc> &rhs) {
+        return !(rhs < lhs);
+    }
+
+    template<class T, class Alloc>
+    bool operator>=(const ft::deque<T, Alloc> &lhs, const ft::deque<T, Alloc> &rhs) {
+        return !(lhs < rhs);
+    }
+
+    template<class T, class Alloc>
+    void swap(ft::deque<T, Alloc> &x, ft::deque<T, Alloc> &y) {
+        x.swap(y);
+    }
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cstddef>
+#include "../parallel/thread_pool.hpp"
+#include "../parallel/parallel_sort.hpp"
+#include "../utils/sort.hpp"
+#include "../vector/vector.hpp"
+
+namespace ft{
+    struct keep_first_t{};
+    struct keep_last_t{};
+
+    // Which element of a run of equal keys a bulk-built map or set keeps.
+    static const keep_first_t keep_first = keep_first_t();
+    static const keep_last_t keep_last = keep_last_t();
+
+    template <class Compare>
+    struct pair_key_less{
+        Compare comp;
+
+        explicit pair_key_less(const Compare &c) : comp(c) {}
+
+        template <class PairA, class PairB>
+        bool operator()(const PairA &a, const PairB &b) const {
+            return comp(a.first, b.first);
+        }
+    };
+
+    namespace bulk_detail
+    {
+        static const size_t parallel_threshold = 1 << 14;
+        static const size_t link_grain = 1 << 12;
+
+        template <class Value>
+        struct entry{
+            Value value;
+            size_t index;
+
+            entry() : value(), index(0) {}
+
+            entry(const Value &v, size_t i) : value(v), index(i) {}
+        };
+
+        // Orders by key, then by input position, so a run of equal keys keeps the input order.
+        template <class Value, class Less>
+        struct entry_less{
+            Less less;
+
+            explicit entry_less(const Less &l) : less(l) {}
+
+            bool operator()(const entry<Value> &a, const entry<Value> &b) const {
+                if (less(a.value, b.value))
+                    return true;
+                if (less(b.value, a.value))
+                    return false;
+                return a.index < b.index;
+            }
+        };
+
+        template <class Tree>
+        typename Tree::p_node link(Tree &tree, ft::thread_pool *pool, typename Tree::p_node *nodes, size_t n, size_t depth, size_t red) {
+            typename Tree::p_node left;
+            typename Tree::p_node right;
+            size_t mid = n / 2;
+
+            if (!pool || n <= link_grain)
+                return tree.build_sorted(nodes, n, depth, red);
+            pool->invoke([&]() { left = link(tree, pool, nodes, mid, depth + 1, red); },
+                         [&]() { right = link(tree, pool, nodes + mid + 1, n - mid - 1, depth + 1, red); });
+            return tree.attach(nodes[mid], left, right, depth == red);
+        }
+    }
+
+    // Returns the root of a balanced tree holding the distinct keys of [first, last) and stores the node
+    // count. The input is sorted by (key, position), one element per run of equal keys is kept, nodes are
+    // created in key order so neighbours sit close in memory, and the array is linked by halving. Given a
+    // pool, inputs from parallel_threshold elements sort and link on it, so the comparator and the value's
+    // copy run on its threads; nodes are always allocated and constructed on the calling thread.
+    template <class Value, class Tree, class InputIterator, class Less>
+    typename Tree::p_node bulk_build(Tree &tree, InputIterator first, InputIterator last, const Less &less, bool keep_last,
+                                     size_t *count, ft::thread_pool *pool = 0) {
+        typedef bulk_detail::entry<Value> entry;
+        typedef typename Tree::p_node p_node;
+        ft::vector<entry> entries;
+
+        for (size_t i = 0; first != last; ++first, ++i)
+            entries.push_back(entry(Value(*first), i));
+        *count = 0;
+        if (entries.empty())
+            return 0;
+
+        const size_t n = entries.size();
+        bulk_detail::entry_less<Value, Less> order(less);
+        entry *sorted = &entries[0];
+
+        if (n < bulk_detail::parallel_threshold)
+            pool = 0;
+        if (pool)
+            ft::parallel_sort(sorted, sorted + n, order, *pool);
+        else
+            ft::sort(sorted, sorted + n, order);
+
+        ft::vector<p_node> nodes;
+        try {
+            for (size_t i = 0; i < n; ++i) {
+                bool kept = keep_last ? i + 1 == n || less(sorted[i].value, sorted[i + 1].value)
+                                      : !i || less(sorted[i - 1].value, sorted[i].value);
+                if (kept) {
+                    nodes.push_back(p_node(0));
+                    nodes.back() = tree.create_node(sorted[i].value);
+                }
+            }
+        }
+        catch (...) {
+            for (size_t i = 0; i < nodes.size(); ++i)
+                tree.delete_node(nodes[i]);
+            throw;
+        }
+        *count = nodes.size();
+        return bulk_detail::link(tree, pool, &nodes[0], nodes.size(), 0, Tree::red_depth(nodes.size()));
+    }
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstddef>
+#include "../utils/bits.hpp"
+#include "../utils/prefetch.hpp"
+
+namespace ft
+{
+    // Index arithmetic over a 1-based array holding a complete binary search tree in BFS order.
+    struct eytzinger{
+        typedef size_t size_type;
+
+        static const size_type prefetch_shift = 4;
+
+        static size_type first(size_type n){
+            size_type k = n ? 1 : 0;
+
+            while (2 * k <= n && k)
+                k *= 2;
+            return k;
+        }
+
+        static size_type last(size_type n){
+            size_type k = n ? 1 : 0;
+
+            while (2 * k + 1 <= n && k)
+                k = 2 * k + 1;
+            return k;
+        }
+
+        static size_type next(size_type k, size_type n){
+            if (2 * k + 1 <= n){
+                k = 2 * k + 1;
+                while (2 * k <= n)
+                    k *= 2;
+                return k;
+            }
+            return k >> (ft::count_trailing_zeros(~k) + 1);
+        }
+
+        static size_type prev(size_type k, size_type n){
+            if (!k)
+                return last(n);
+            if (2 * k <= n){
+                k = 2 * k;
+                while (2 * k + 1 <= n)
+                    k = 2 * k + 1;
+                return k;
+            }
+            return k >> (ft::count_trailing_zeros(k) + 1);
+        }
+
+        template<class Key, class Compare>
+        static size_type lower_bound(const Key *keys, size_type n, const Key &key, const Compare &comp){
+            size_type k = 1;
+
+            while (k <= n){
+                if ((k << prefetch_shift) <= n)
+                    ft::prefetch(keys + (k << prefetch_shift));
+                k = 2 * k + comp(keys[k], key);
+            }
+            return k >> (ft::count_trailing_zeros(~k) + 1);
+        }
+
+        template<class Key, class Compare>
+        static size_type upper_bound(const Key *keys, size_type n, const Key &key, const Compare &comp){
+            size_type k = 1;
+
+            while (k <= n){
+                if ((k << prefetch_shift) <= n)
+                    ft::prefetch(keys + (k << prefetch_shift));
+                k = 2 * k + !comp(key, keys[k]);
+            }
+            return k >> (ft::count_trailing_zeros(~k) + 1);
+        }
+    };
+}
@@ -0,0 +1,224 @@
+#pragma once
+
+#include <memory>
+#include <stdexcept>
+#include "../utils/less.hpp"
+#include "../utils/pair.hpp"
+#include "../utils/utils.hpp"
+#include "../utils/iterator_traits.hpp"
+#include "eytzinger.hpp"
+
+namespace ft{
+    template<class Key, class T, class Compare = ft::less<Key>, class Alloc = std::allocator <ft::pair<const Key, T> > >
+    class frozen_map{
+    public:
+        typedef Key 													key_type;
+        typedef T 														mapped_type;
+        typedef ft::pair<const Key &, const T &> 						reference;
+        typedef Compare 												key_compare;
+        typedef Alloc 													allocator_type;
+        typedef typename Alloc::template rebind<Key>::other				key_allocator_type;
+        typedef typename Alloc::template rebind<T>::other				mapped_allocator_type;
+        typedef size_t 													size_type;
+        typedef ptrdiff_t 												difference_type;
+
+        class const_iterator{
+        public:
+            typedef std::bidirectional_iterator_tag	iterator_category;
+            typedef ft::pair<const Key, T> 			value_type;
+            typedef ptrdiff_t 						difference_type;
+            typedef typename frozen_map::reference 	reference;
+
+            struct pointer{
+                reference value;
+
+                const reference *operator->() const{
+                    return &value;}
+            };
+
+            const_iterator() : map_(0), index_(0){}
+
+            const_iterator(const frozen_map *map, size_type index) : map_(map), index_(index){}
+
+            reference operator*() const{
+                return reference(map_->keys_[index_], map_->values_[index_]);}
+
+            pointer operator->() const{
+                pointer res = {**this};
+                return res;
+            }
+
+            const_iterator &operator++(){
+                index_ = eytzinger::next(index_, map_->size_);
+                return *this;
+            }
+
+            const_iterator operator++(int){
+                const_iterator temp = *this;
+                ++(*this);
+                return temp;
+            }
+
+            const_iterator &operator--(){
+                index_ = eytzinger::prev(index_, map_->size_);
+                return *this;
+            }
+
+            const_iterator operator--(int){
+                const_iterator temp = *this;
+                --(*this);
+                return temp;
+            }
+
+            bool operator==(const const_iterator &it) const{
+                return index_ == it.index_;}
+
+            bool operator!=(const const_iterator &it) const{
+                return index_ != it.index_;}
+
+        private:
+            const frozen_map 	*map_;
+            size_type 			index_;
+        };
+
+        typedef const_iterator iterator;
+
+        explicit frozen_map(const key_compare &comp = key_compare(), const allocator_type &allocator = allocator_type())
+            : key_allocator_(allocator), mapped_allocator_(allocator), key_compare_(comp), keys_(0), values_(0), size_(0){}
+
+        // [first, last) must be sorted by comp and free of duplicate keys, as an ft::map range is.
+        template<class ForwardIterator>
+        frozen_map(ForwardIterator first, ForwardIterator last, const key_compare &comp = key_compare(), const allocator_type &allocator = allocator_type())
+            : key_allocator_(allocator), mapped_allocator_(allocator), key_compare_(comp), keys_(0), values_(0), size_(0){
+            assign(first, last, ft::distance(first, last));
+        }
+
+        frozen_map(const frozen_map &src)
+            : key_allocator_(src.key_allocator_), mapped_allocator_(src.mapped_allocator_), key_compare_(src.key_compare_), keys_(0), values_(0), size_(0){
+            assign(src.begin(), src.end(), src.size_);
+        }
+
+        ~frozen_map(){
+            clear();}
+
+        frozen_map &operator=(const frozen_map &src){
+            if (this != &src){
+                frozen_map copy(src);
+                swap(copy);
+            }
+            return *this;
+        }
+
+        const_iterator begin() const{
+            return const_iterator(this, eytzinger::first(size_));}
+
+        const_iterator end() const{
+            return const_iterator(this, 0);}
+
+        bool empty() const{
+            return size_ == 0;}
+
+        size_type size() const{
+            return size_;}
+
+        const_iterator find(const key_type &k) const{
+            size_type index = eytzinger::lower_bound(keys_, size_, k, key_compare_);
+
+            if (index && key_compare_(k, keys_[index]))
+                index = 0;
+            return const_iterator(this, index);
+        }
+
+        size_type count(const key_type &k) const{
+            return find(k) != end();}
+
+        const_iterator lower_bound(const key_type &k) const{
+            return const_iterator(this, eytzinger::lower_bound(keys_, size_, k, key_compare_));}
+
+        const_iterator upper_bound(const key_type &k) const{
+            return const_iterator(this, eytzinger::upper_bound(keys_, size_, k, key_compare_));}
+
+        ft::pair<const_iterator, const_iterator> equal_range(const key_type &k) const{
+            return ft::make_pair(lower_bound(k), upper_bound(k));}
+
+        const T& at(const Key &key) const{
+            const_iterator res = find(key);
+            if (res == end())
+                throw std::out_of_range("Key 'frozen_map::at' not found.");
+            return res->second;
+        }
+
+        key_compare key_comp() const{
+            return key_compare_;}
+
+        void swap(frozen_map &x){
+            ft::swap(x.key_compare_, key_compare_);
+            ft::swap(x.keys_, keys_);
+            ft::swap(x.values_, values_);
+            ft::swap(x.size_, size_);
+        }
+
+        void clear(){
+            if (!keys_)
+                return;
+            for (size_type i = 1; i <= size_; ++i){
+                key_allocator_.destroy(keys_ + i);
+                mapped_allocator_.destroy(values_ + i);
+            }
+            key_allocator_.deallocate(keys_, size_ + 1);
+            mapped_allocator_.deallocate(values_, size_ + 1);
+            keys_ = 0;
+            values_ = 0;
+            size_ = 0;
+        }
+
+    private:
+        key_allocator_type 		key_allocator_;
+        mapped_allocator_type 	mapped_allocator_;
+        key_compare 			key_compare_;
+        Key 					*keys_;
+        T 						*values_;
+        size_type 				size_;
+
+        // Fills fresh arrays and only then takes them, so an empty map stays empty if a copy throws:
+        // the slots filled so far, visited in the same order, are destroyed and both arrays freed.
+        template<class ForwardIterator>
+        void assign(ForwardIterator first, ForwardIterator last, size_type n){
+            if (!n)
+                return;
+            Key *keys = key_allocator_.allocate(n + 1);
+            T *values = 0;
+            size_type keys_done = 0;
+            size_type values_done = 0;
+
+            try{
+                values = mapped_allocator_.allocate(n + 1);
+                for (size_type i = eytzinger::first(n); first != last; ++first, i = eytzinger::next(i, n)){
+                    key_allocator_.construct(keys + i, (*first).first);
+                    ++keys_done;
+                    mapped_allocator_.construct(values + i, (*first).second);
+                    ++values_done;
+                }
+            }
+            catch (...){
+                size_type i = eytzinger::first(n);
+                for (size_type done = 0; done < keys_done; ++done, i = eytzinger::next(i, n)){
+                    key_allocator_.destroy(keys + i);
+                    if (done < values_done)
+                        mapped_allocator_.destroy(values + i);
+                }
+                if (values)
+                    mapped_allocator_.deallocate(values, n + 1);
+                key_allocator_.deallocate(keys, n + 1);
+                throw;
+            }
+            keys_ = keys;
+            values_ = values;
+            size_ = n;
+        }
+    };
+
+    template<class Key, class T, class Compare, class Allocator>
+    void swap(frozen_map<Key, T, Compare, Allocator> &x, frozen_map<Key, T, Compare, Allocator> &y){
+        x.swap(y);}
+}
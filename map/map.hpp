@@ -8,6 +8,9 @@
 #include "../utils/map_iterator.hpp"
 #include "../utils/iterator_traits.hpp"
 #include "red_black_tree.hpp"
+#include "frozen_map.hpp"
+#include "bulk_build.hpp"
+#include "stream_build.hpp"
 #include "node.hpp"
 
 namespace ft{
@@ -35,31 +38,54 @@ namespace ft{
         typedef red_black_tree<pair_type, value_compare, node_allocator_type> 	tree_type;
         typedef typename ft::node<pair_type> 									*p_node;
 
+        // Every other constructor delegates here first, so once the header node exists ~map owns it
+        // and releases it, together with anything already linked, if the build step throws.
         explicit map(const key_compare &comp = key_compare(), const allocator_type &allocator = allocator_type()){
             allocator_ = allocator;
             node_ = red_black_tree_.create_node(pair_type());
             key_compare_ = comp;
+            size_ = 0;
         }
 
         template<class InputIterator>
-        map(InputIterator first, InputIterator last, const key_compare &comp = key_compare(), const allocator_type &allocator = allocator_type()){
-            allocator_ = allocator;
-            node_ = red_black_tree_.create_node(pair_type());
-            key_compare_ = comp;
-            insert(first, last);
-        }
+        map(InputIterator first, InputIterator last, const key_compare &comp = key_compare(), const allocator_type &allocator = allocator_type())
+            : map(comp, allocator){
+            build(first, last, false, 0);}
+
+        template<class InputIterator>
+        map(InputIterator first, InputIterator last, keep_first_t, const key_compare &comp = key_compare(), const allocator_type &allocator = allocator_type())
+            : map(comp, allocator){
+            build(first, last, false, 0);}
+
+        template<class InputIterator>
+        map(InputIterator first, InputIterator last, keep_last_t, const key_compare &comp = key_compare(), const allocator_type &allocator = allocator_type())
+            : map(comp, allocator){
+            build(first, last, true, 0);}
+
+        // Sorts and links inputs of bulk_detail::parallel_threshold elements or more on pool.
+        template<class InputIterator>
+        map(InputIterator first, InputIterator last, ft::thread_pool &pool, const key_compare &comp = key_compare(), const allocator_type &allocator = allocator_type())
+            : map(comp, allocator){
+            build(first, last, false, &pool);}
+
+        template<class InputIterator>
+        map(sorted_input_t, InputIterator first, InputIterator last, const key_compare &comp = key_compare(), const allocator_type &allocator = allocator_type())
+            : map(comp, allocator){
+            stream(first, last);}
+
+        template<class InputIterator>
+        map(spill_input_t, InputIterator first, InputIterator last, size_t run_records = stream_detail::run_records,
+            const key_compare &comp = key_compare(), const allocator_type &allocator = allocator_type())
+            : map(comp, allocator){
+            spill(first, last, run_records ? run_records : 1);}
 
         ~map(){
             red_black_tree_.clear(&node_->parent);
             red_black_tree_.clear(&node_);
         }
 
-        map(const map &src){
-            allocator_ = src.allocator_;
-            node_ = red_black_tree_.create_node(pair_type());
-            key_compare_ = src.key_compare_;
-            *this = src;
-        }
+        map(const map &src) : map(src.key_compare_, src.allocator_){
+            *this = src;}
 
         map &operator=(const map &src){
             clear();
@@ -129,10 +155,10 @@ namespace ft{
                 insert(*first);
         }
 
-        void erase(iterator position){
-            bool res = red_black_tree_.erase(&node_->parent, *position);
-            if (res)
-                --size_;
+        iterator erase(iterator position){
+            p_node next = red_black_tree_.erase_node(&node_->parent, position.base());
+            --size_;
+            return iterator(node_, next);
         }
 
         size_type erase(const key_type &k){
@@ -142,9 +168,9 @@ namespace ft{
             return res;
         }
 
-        void erase(iterator first, iterator last){
-            while (first != last)
-                erase(first++);
+        iterator erase(iterator first, iterator last){
+            size_ -= red_black_tree_.erase_range(&node_->parent, first.base(), last.base());
+            return last;
         }
 
         void swap(map &x){
@@ -182,6 +208,43 @@ namespace ft{
             return 0;
         }
 
+        template<class KeyIterator, class OutputIterator>
+        OutputIterator find_many(KeyIterator first, KeyIterator last, OutputIterator out){
+            p_node found[tree_type::batch_width];
+
+            while (first != last){
+                KeyIterator next = red_black_tree_.find_batch(node_->parent, first, last, found);
+                for (size_type i = 0; first != next; ++first, ++i)
+                    *out++ = iterator(node_, found[i]);
+            }
+            return out;
+        }
+
+        template<class KeyIterator, class OutputIterator>
+        OutputIterator find_many(KeyIterator first, KeyIterator last, OutputIterator out) const{
+            p_node found[tree_type::batch_width];
+
+            while (first != last){
+                KeyIterator next = red_black_tree_.find_batch(node_->parent, first, last, found);
+                for (size_type i = 0; first != next; ++first, ++i)
+                    *out++ = const_iterator(node_, found[i]);
+            }
+            return out;
+        }
+
+        template<class KeyIterator>
+        size_type count_many(KeyIterator first, KeyIterator last) const{
+            p_node found[tree_type::batch_width];
+            size_type res = 0;
+
+            while (first != last){
+                KeyIterator next = red_black_tree_.find_batch(node_->parent, first, last, found);
+                for (size_type i = 0; first != next; ++first, ++i)
+                    res += found[i] != 0;
+            }
+            return res;
+        }
+
         iterator lower_bound(const key_type &k){
             return (iterator(node_, red_black_tree_.lowest_elem(node_->parent, add_new_pair(k))));
         }
@@ -234,6 +297,9 @@ namespace ft{
         allocator_type get_allocator() const{
             return allocator_;}
 
+        frozen_map<Key, T, Compare, Alloc> freeze() const{
+            return frozen_map<Key, T, Compare, Alloc>(begin(), end(), key_compare_, allocator_);}
+
     private:
         tree_type 			red_black_tree_;
         allocator_type 		allocator_;
@@ -244,6 +310,33 @@ namespace ft{
 
         pair_type add_new_pair(const Key &key) const{
             return ft::make_pair(key, mapped_type());}
+
+        template<class InputIterator>
+        void build(InputIterator first, InputIterator last, bool keep_last, ft::thread_pool *pool){
+            size_t count;
+
+            node_->parent = ft::bulk_build<ft::pair<Key, T> >(red_black_tree_, first, last,
+                    ft::pair_key_less<key_compare>(key_compare_), keep_last, &count, pool);
+            size_ = count;
+        }
+
+        template<class InputIterator>
+        void stream(InputIterator first, InputIterator last){
+            size_t count;
+
+            node_->parent = ft::stream_build<ft::pair<Key, T> >(red_black_tree_, first, last,
+                    ft::pair_key_less<key_compare>(key_compare_), &count);
+            size_ = count;
+        }
+
+        template<class InputIterator>
+        void spill(InputIterator first, InputIterator last, size_t run_records){
+            size_t count;
+
+            node_->parent = ft::spill_build<ft::pair<Key, T> >(red_black_tree_, first, last,
+                    ft::pair_key_less<key_compare>(key_compare_), run_records, &count);
+            size_ = count;
+        }
     };
 
 
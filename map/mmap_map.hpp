@@ -0,0 +1,685 @@
+#pragma once
+
+#include <new>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "../utils/less.hpp"
+#include "../utils/pair.hpp"
+#include "../vector/vector.hpp"
+
+namespace ft{
+    namespace mmap_map_detail
+    {
+        static const char magic[8] = {'F', 'T', 'M', 'A', 'P', 0, 0, 0};
+        static const unsigned version = 1;
+        static const unsigned long long arena_offset = 4096;
+        static const unsigned long long initial_length = 1 << 20;
+        static const unsigned max_depth = 128;
+
+        // One committed state of the tree. Two of them alternate in the header, each guarded by a
+        // checksum, so a torn header write leaves the previous one in force.
+        struct record{
+            unsigned long long seq;
+            unsigned long long root;
+            unsigned long long size;
+            unsigned long long used;
+            unsigned long long free_head;
+            unsigned long long checksum;
+        };
+
+        struct header{
+            char magic[8];
+            unsigned version;
+            unsigned node_size;
+            unsigned long long key_size;
+            unsigned long long mapped_size;
+            record records[2];
+        };
+
+        inline unsigned long long checksum(const record &r) {
+            const unsigned char *p = reinterpret_cast<const unsigned char *>(&r);
+            unsigned long long h = 1469598103934665603ULL;
+
+            for (size_t i = 0; i < offsetof(record, checksum); ++i)
+                h = (h ^ p[i]) * 1099511628211ULL;
+            return h;
+        }
+
+        inline void fail(const char *what) {
+            throw std::system_error(errno, std::generic_category(), what);
+        }
+    }
+
+    // Ordered map persisted in a file. Nodes live in a file-backed arena and link by offset, so the
+    // file can be mapped anywhere and is usable straight after open: nothing is rebuilt.
+    //
+    // The tree is a left-leaning red-black tree without parent links, updated copy-on-write: a node
+    // written since the last checkpoint is changed in place, an older one is copied first. So the
+    // tree reachable from the last committed root is never touched, and checkpoint() only has to msync
+    // the arena and then commit the new root to the spare header record. After a crash the file opens
+    // at the last checkpoint. The committed free list is only ever read between checkpoints: nodes freed
+    // in an epoch are kept in memory and linked into the list by checkpoint(), and superseded committed
+    // nodes become free once it lands. Key and T must be trivially copyable; iterators are invalidated
+    // by any change.
+    template <class Key, class T, class Compare = ft::less<Key> >
+    class mmap_map{
+        public:
+            typedef Key key_type;
+            typedef T mapped_type;
+            typedef ft::pair<const Key, T> value_type;
+            typedef Compare key_compare;
+            typedef size_t size_type;
+            typedef unsigned long long offset_type;
+
+        private:
+            struct node{
+                offset_type left;
+                offset_type right;
+                offset_type epoch;
+                offset_type free_next;
+                bool red;
+                value_type value;
+            };
+
+        public:
+            class const_iterator{
+            public:
+                typedef std::forward_iterator_tag iterator_category;
+                typedef typename mmap_map::value_type value_type;
+                typedef ptrdiff_t difference_type;
+                typedef const value_type *pointer;
+                typedef const value_type &reference;
+
+                const_iterator() : map_(0), depth_(0) {}
+
+                reference operator*() const {
+                    return map_->at(path_[depth_ - 1])->value;
+                }
+
+                pointer operator->() const {
+                    return &(operator*());
+                }
+
+                const_iterator &operator++() {
+                    offset_type x = map_->at(path_[--depth_])->right;
+
+                    descend(x);
+                    return *this;
+                }
+
+                const_iterator operator++(int) {
+                    const_iterator tmp = *this;
+                    ++(*this);
+                    return tmp;
+                }
+
+                bool operator==(const const_iterator &it) const {
+                    if (!depth_ || !it.depth_)
+                        return depth_ == it.depth_;
+                    return path_[depth_ - 1] == it.path_[it.depth_ - 1];
+                }
+
+                bool operator!=(const const_iterator &it) const {
+                    return !(*this == it);
+                }
+
+            private:
+                friend class mmap_map;
+
+                const mmap_map *map_;
+                offset_type path_[mmap_map_detail::max_depth];
+                unsigned depth_;
+
+                explicit const_iterator(const mmap_map *map) : map_(map), depth_(0) {}
+
+                void descend(offset_type x) {
+                    for (; x; x = map_->at(x)->left)
+                        path_[depth_++] = x;
+                }
+            };
+
+            typedef const_iterator iterator;
+
+            // Opens path, creating an empty map when the file is new or empty.
+            explicit mmap_map(const char *path, const key_compare &comp = key_compare())
+                : fd_(-1), base_(0), length_(0), comp_(comp) {
+                static_assert(std::is_trivially_copyable<Key>::value && std::is_trivially_copyable<T>::value,
+                              "mmap_map needs trivially copyable Key and T");
+                struct stat info;
+
+                fd_ = ::open(path, O_RDWR | O_CREAT, 0644);
+                if (fd_ < 0)
+                    mmap_map_detail::fail("ft::mmap_map");
+                try {
+                    if (fstat(fd_, &info) < 0)
+                        mmap_map_detail::fail("ft::mmap_map");
+                    if (!info.st_size)
+                        create();
+                    else
+                        open(static_cast<size_t>(info.st_size));
+                }
+                catch (...) {
+                    if (base_)
+                        munmap(base_, length_);
+                    ::close(fd_);
+                    throw;
+                }
+            }
+
+            // Commits whatever changed since the last checkpoint, best effort.
+            ~mmap_map() {
+                try {
+                    checkpoint();
+                }
+                catch (...) {
+                }
+                munmap(base_, length_);
+                ::close(fd_);
+            }
+
+            size_type size() const {
+                return size_;
+            }
+
+            bool empty() const {
+                return !size_;
+            }
+
+            const_iterator begin() const {
+                const_iterator it(this);
+
+                it.descend(root_);
+                return it;
+            }
+
+            const_iterator end() const {
+                return const_iterator(this);
+            }
+
+            const_iterator lower_bound(const key_type &k) const {
+                const_iterator it(this);
+
+                for (offset_type x = root_; x; ) {
+                    if (!comp_(key(x), k)) {
+                        it.path_[it.depth_++] = x;
+                        x = at(x)->left;
+                    }
+                    else
+                        x = at(x)->right;
+                }
+                return it;
+            }
+
+            const_iterator find(const key_type &k) const {
+                const_iterator it = lower_bound(k);
+
+                if (it != end() && comp_(k, it->first))
+                    return end();
+                return it;
+            }
+
+            size_type count(const key_type &k) const {
+                return find(k) != end();
+            }
+
+            bool insert(const value_type &val) {
+                if (find(val.first) != end())
+                    return false;
+                root_ = insert(root_, val, false);
+                at(root_)->red = false;
+                ++size_;
+                return true;
+            }
+
+            // Returns true when the key was new.
+            bool insert_or_assign(const key_type &k, const mapped_type &obj) {
+                bool fresh = find(k) == end();
+
+                root_ = insert(root_, value_type(k, obj), true);
+                at(root_)->red = false;
+                size_ += fresh;
+                return fresh;
+            }
+
+            size_type erase(const key_type &k) {
+                if (find(k) == end())
+                    return 0;
+                root_ = own(root_);
+                if (!red(at(root_)->left) && !red(at(root_)->right))
+                    at(root_)->red = true;
+                root_ = erase(root_, k);
+                if (root_)
+                    at(root_)->red = false;
+                --size_;
+                return 1;
+            }
+
+            // Makes the current state durable: links the nodes freed since the last checkpoint into the
+            // free list, flushes the arena, then writes the new root into the header record not holding
+            // the last checkpoint and flushes the header. A node taken off the committed free list this
+            // epoch still carries a link that list depends on, so it is linked by a second commit once
+            // the first has replaced that list; a crash between the two can only leak such nodes.
+            void checkpoint() {
+                ft::vector<offset_type> held;
+
+                for (size_t i = 0; i < spare_.size(); ++i) {
+                    if (spare_[i] < committed_used_)
+                        held.push_back(spare_[i]);
+                    else
+                        link_free(spare_[i]);
+                }
+                for (size_t i = 0; i < pending_.size(); ++i)
+                    link_free(pending_[i]);
+                pending_.clear();
+                spare_.swap(held);
+                commit();
+                if (!spare_.empty()) {
+                    for (size_t i = 0; i < spare_.size(); ++i)
+                        link_free(spare_[i]);
+                    spare_.clear();
+                    commit();
+                }
+            }
+
+            // Nodes held on the free list or waiting in memory to join it.
+            size_type free_nodes() const {
+                size_type n = spare_.size() + pending_.size();
+
+                for (offset_type x = free_head_; x && n <= capacity(); x = at(x)->free_next)
+                    ++n;
+                return n;
+            }
+
+            // Consistency check of the arena: every node in range and on a node boundary, the tree
+            // ordered, balanced and holding size() nodes, the free list acyclic, no node both free and
+            // in the tree, and every node of the arena accounted for by one of them.
+            bool verify() const {
+                ft::vector<unsigned char> seen(capacity(), 0);
+                size_type black = 0;
+                size_type count = 0;
+
+                if (!verify_tree(root_, 0, 0, false, &black, &count, seen) || count != size_)
+                    return false;
+                for (size_t i = 0; i < pending_.size(); ++i)
+                    if (!mark(pending_[i], seen))
+                        return false;
+                for (size_t i = 0; i < spare_.size(); ++i)
+                    if (!mark(spare_[i], seen))
+                        return false;
+                for (offset_type x = free_head_; x; x = at(x)->free_next)
+                    if (!mark(x, seen))
+                        return false;
+                for (size_t i = 0; i < seen.size(); ++i)
+                    if (!seen[i])
+                        return false;
+                return true;
+            }
+
+        private:
+            mmap_map(const mmap_map &);
+            mmap_map &operator=(const mmap_map &);
+
+            int fd_;
+            char *base_;
+            size_t length_;
+            key_compare comp_;
+            offset_type seq_;
+            offset_type root_;
+            offset_type size_;
+            offset_type used_;
+            offset_type free_head_;
+            offset_type committed_used_;
+            ft::vector<offset_type> pending_;
+            ft::vector<offset_type> spare_;
+
+            mmap_map_detail::header *head() const {
+                return reinterpret_cast<mmap_map_detail::header *>(base_);
+            }
+
+            // Offsets stay valid across a remap; node pointers do not, so none is held over an allocation.
+            node *at(offset_type off) const {
+                return reinterpret_cast<node *>(base_ + off);
+            }
+
+            const key_type &key(offset_type off) const {
+                return at(off)->value.first;
+            }
+
+            bool red(offset_type off) const {
+                return off && at(off)->red;
+            }
+
+            void map(size_t length) {
+                void *p = mmap(0, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+
+                if (p == MAP_FAILED)
+                    mmap_map_detail::fail("ft::mmap_map");
+                base_ = static_cast<char *>(p);
+                length_ = length;
+            }
+
+            void create() {
+                mmap_map_detail::record r = {0, 0, 0, mmap_map_detail::arena_offset, 0, 0};
+
+                if (ftruncate(fd_, mmap_map_detail::initial_length) < 0)
+                    mmap_map_detail::fail("ft::mmap_map");
+                map(mmap_map_detail::initial_length);
+                mmap_map_detail::header *h = head();
+                std::memcpy(h->magic, mmap_map_detail::magic, sizeof(h->magic));
+                h->version = mmap_map_detail::version;
+                h->node_size = sizeof(node);
+                h->key_size = sizeof(Key);
+                h->mapped_size = sizeof(T);
+                r.checksum = mmap_map_detail::checksum(r);
+                h->records[0] = r;
+                if (msync(base_, mmap_map_detail::arena_offset, MS_SYNC) < 0)
+                    mmap_map_detail::fail("ft::mmap_map");
+                load(r);
+            }
+
+            void open(size_t length) {
+                if (length < mmap_map_detail::arena_offset)
+                    throw std::runtime_error("ft::mmap_map: truncated file");
+                map(length);
+                const mmap_map_detail::header *h = head();
+                if (std::memcmp(h->magic, mmap_map_detail::magic, sizeof(h->magic)) || h->version != mmap_map_detail::version)
+                    throw std::runtime_error("ft::mmap_map: not a map file");
+                if (h->node_size != sizeof(node) || h->key_size != sizeof(Key) || h->mapped_size != sizeof(T))
+                    throw std::runtime_error("ft::mmap_map: layout mismatch");
+                const mmap_map_detail::record *best = 0;
+                for (int i = 0; i < 2; ++i) {
+                    const mmap_map_detail::record &r = h->records[i];
+                    if (r.checksum == mmap_map_detail::checksum(r) && r.used <= length && (!best || r.seq > best->seq))
+                        best = &r;
+                }
+                if (!best)
+                    throw std::runtime_error("ft::mmap_map: no valid checkpoint");
+                load(*best);
+            }
+
+            void load(const mmap_map_detail::record &r) {
+                seq_ = r.seq;
+                root_ = r.root;
+                size_ = r.size;
+                used_ = r.used;
+                free_head_ = r.free_head;
+                committed_used_ = r.used;
+            }
+
+            void commit() {
+                mmap_map_detail::header *h = head();
+                mmap_map_detail::record r;
+
+                if (msync(base_, length_, MS_SYNC) < 0)
+                    mmap_map_detail::fail("ft::mmap_map::checkpoint");
+                r.seq = seq_ + 1;
+                r.root = root_;
+                r.size = size_;
+                r.used = used_;
+                r.free_head = free_head_;
+                r.checksum = mmap_map_detail::checksum(r);
+                h->records[r.seq & 1] = r;
+                if (msync(base_, mmap_map_detail::arena_offset, MS_SYNC) < 0)
+                    mmap_map_detail::fail("ft::mmap_map::checkpoint");
+                seq_ = r.seq;
+                committed_used_ = used_;
+            }
+
+            void link_free(offset_type off) {
+                at(off)->free_next = free_head_;
+                free_head_ = off;
+            }
+
+            size_type capacity() const {
+                return (used_ - mmap_map_detail::arena_offset) / sizeof(node);
+            }
+
+            bool mark(offset_type off, ft::vector<unsigned char> &seen) const {
+                if (off < mmap_map_detail::arena_offset || off >= used_
+                    || (off - mmap_map_detail::arena_offset) % sizeof(node))
+                    return false;
+                unsigned char &s = seen[(off - mmap_map_detail::arena_offset) / sizeof(node)];
+                if (s)
+                    return false;
+                s = 1;
+                return true;
+            }
+
+            // Checks [lo, hi) key bounds, no red right links or red pairs, and equal black heights.
+            bool verify_tree(offset_type x, const key_type *lo, const key_type *hi, bool parent_red, size_type *black,
+                             size_type *count, ft::vector<unsigned char> &seen) const {
+                size_type left_black = 0;
+                size_type right_black = 0;
+
+                if (!x) {
+                    *black = 1;
+                    return true;
+                }
+                if (!mark(x, seen))
+                    return false;
+                const node *n = at(x);
+                if ((lo && !comp_(*lo, n->value.first)) || (hi && !comp_(n->value.first, *hi)))
+                    return false;
+                if (red(n->right) || (parent_red && n->red))
+                    return false;
+                if (!verify_tree(n->left, lo, &n->value.first, n->red, &left_black, count, seen)
+                    || !verify_tree(n->right, &n->value.first, hi, n->red, &right_black, count, seen)
+                    || left_black != right_black)
+                    return false;
+                *black = left_black + !n->red;
+                ++*count;
+                return true;
+            }
+
+            // Nodes stamped with the running epoch are not reachable from the last checkpoint.
+            offset_type epoch() const {
+                return seq_ + 1;
+            }
+
+            void grow() {
+                size_t length = length_ * 2;
+
+                if (ftruncate(fd_, length) < 0)
+                    mmap_map_detail::fail("ft::mmap_map");
+#ifdef __linux__
+                void *p = mremap(base_, length_, length, MREMAP_MAYMOVE);
+                if (p == MAP_FAILED)
+                    mmap_map_detail::fail("ft::mmap_map");
+                base_ = static_cast<char *>(p);
+                length_ = length;
+#else
+                munmap(base_, length_);
+                map(length);
+#endif
+            }
+
+            // Takes a node freed this epoch, then one off the committed free list, whose links are
+            // only read, then a new one at the end of the arena.
+            offset_type allocate() {
+                offset_type off;
+
+                if (!spare_.empty()) {
+                    off = spare_.back();
+                    spare_.pop_back();
+                }
+                else if (free_head_) {
+                    off = free_head_;
+                    free_head_ = at(off)->free_next;
+                }
+                else {
+                    while (used_ + sizeof(node) > length_)
+                        grow();
+                    off = used_;
+                    used_ += sizeof(node);
+                }
+                at(off)->epoch = epoch();
+                return off;
+            }
+
+            // A node from this epoch is free at once; an older one is still part of the last
+            // checkpoint and waits for the next.
+            void release(offset_type off) {
+                if (at(off)->epoch == epoch())
+                    spare_.push_back(off);
+                else
+                    pending_.push_back(off);
+            }
+
+            offset_type make_node(const value_type &val) {
+                offset_type off = allocate();
+                node *n = at(off);
+
+                n->left = 0;
+                n->right = 0;
+                n->red = true;
+                new (&n->value) value_type(val);
+                return off;
+            }
+
+            offset_type own(offset_type off) {
+                if (at(off)->epoch == epoch())
+                    return off;
+                offset_type copy = allocate();
+                node *src = at(off);
+                node *dst = at(copy);
+                dst->left = src->left;
+                dst->right = src->right;
+                dst->red = src->red;
+                new (&dst->value) value_type(src->value);
+                release(off);
+                return copy;
+            }
+
+            offset_type rotate_left(offset_type h) {
+                offset_type x = own(at(h)->right);
+
+                at(h)->right = at(x)->left;
+                at(x)->left = h;
+                at(x)->red = at(h)->red;
+                at(h)->red = true;
+                return x;
+            }
+
+            offset_type rotate_right(offset_type h) {
+                offset_type x = own(at(h)->left);
+
+                at(h)->left = at(x)->right;
+                at(x)->right = h;
+                at(x)->red = at(h)->red;
+                at(h)->red = true;
+                return x;
+            }
+
+            void flip_colors(offset_type h) {
+                offset_type l = own(at(h)->left);
+                at(h)->left = l;
+                offset_type r = own(at(h)->right);
+                at(h)->right = r;
+                at(h)->red = !at(h)->red;
+                at(l)->red = !at(l)->red;
+                at(r)->red = !at(r)->red;
+            }
+
+            offset_type balance(offset_type h) {
+                if (red(at(h)->right) && !red(at(h)->left))
+                    h = rotate_left(h);
+                if (red(at(h)->left) && red(at(at(h)->left)->left))
+                    h = rotate_right(h);
+                if (red(at(h)->left) && red(at(h)->right))
+                    flip_colors(h);
+                return h;
+            }
+
+            offset_type insert(offset_type h, const value_type &val, bool assign) {
+                if (!h)
+                    return make_node(val);
+                h = own(h);
+                if (comp_(val.first, key(h))) {
+                    offset_type l = insert(at(h)->left, val, assign);
+                    at(h)->left = l;
+                }
+                else if (comp_(key(h), val.first)) {
+                    offset_type r = insert(at(h)->right, val, assign);
+                    at(h)->right = r;
+                }
+                else if (assign)
+                    at(h)->value.second = val.second;
+                return balance(h);
+            }
+
+            offset_type move_red_left(offset_type h) {
+                flip_colors(h);
+                if (red(at(at(h)->right)->left)) {
+                    offset_type r = rotate_right(own(at(h)->right));
+                    at(h)->right = r;
+                    h = rotate_left(h);
+                    flip_colors(h);
+                }
+                return h;
+            }
+
+            offset_type move_red_right(offset_type h) {
+                flip_colors(h);
+                if (red(at(at(h)->left)->left)) {
+                    h = rotate_right(h);
+                    flip_colors(h);
+                }
+                return h;
+            }
+
+            offset_type erase_min(offset_type h) {
+                h = own(h);
+                if (!at(h)->left) {
+                    release(h);
+                    return 0;
+                }
+                if (!red(at(h)->left) && !red(at(at(h)->left)->left))
+                    h = move_red_left(h);
+                offset_type l = erase_min(at(h)->left);
+                at(h)->left = l;
+                return balance(h);
+            }
+
+            // Sedgewick's top-down deletion; the key is known to be present.
+            offset_type erase(offset_type h, const key_type &k) {
+                h = own(h);
+                if (comp_(k, key(h))) {
+                    if (!red(at(h)->left) && !red(at(at(h)->left)->left))
+                        h = move_red_left(h);
+                    offset_type l = erase(at(h)->left, k);
+                    at(h)->left = l;
+                    return balance(h);
+                }
+                if (red(at(h)->left))
+                    h = rotate_right(h);
+                if (!comp_(key(h), k) && !at(h)->right) {
+                    release(h);
+                    return 0;
+                }
+                if (!red(at(h)->right) && !red(at(at(h)->right)->left))
+                    h = move_red_right(h);
+                if (!comp_(key(h), k)) {
+                    offset_type m = at(h)->right;
+                    while (at(m)->left)
+                        m = at(m)->left;
+                    at(h)->value.~value_type();
+                    new (&at(h)->value) value_type(at(m)->value);
+                    offset_type r = erase_min(at(h)->right);
+                    at(h)->right = r;
+                }
+                else {
+                    offset_type r = erase(at(h)->right, k);
+                    at(h)->right = r;
+                }
+                return balance(h);
+            }
+    };
+}
@@ -8,6 +8,7 @@
 #include "../utils/less.hpp"
 #include "../utils/pair.hpp"
 #include "../utils/pair_compare.hpp"
+#include "../utils/prefetch.hpp"
 #include "node.hpp"
 
 namespace ft
@@ -22,9 +23,17 @@ namespace ft
 		typedef typename allocator_type::size_type	size_type;
 		typedef typename allocator_type::pointer 	p_node;
 
+		static const size_type batch_width = 8;
+
 		p_node create_node(value src){
 			p_node new_node = allocator_.allocate(1);
-			allocator_.construct(new_node, src);
+			try{
+				allocator_.construct(new_node, src);
+			}
+			catch (...){
+				allocator_.deallocate(new_node, 1);
+				throw;
+			}
 			return new_node;
 		}
 
@@ -35,44 +44,39 @@ namespace ft
 			}
 		}
 
-        void rotate_right(p_node x, p_node *root)
-        {
-            p_node y = x->left;
-            y->parent = x->parent;
-            if (y->parent && y->parent->left == x)
-                y->parent->left = y;
-            x->parent = y;
-            x->left = y->right;
-            if (x->left && x->left->parent)
-                x->left->parent = x;
-            y->right = x;
-            x->isBlack = false;
-            y->isBlack = true;
-            if (!y->parent)
-                *root = y;
-        }
-
-        void rotate_left(p_node x, p_node *root){
-            p_node y = x->right;
-            y->parent = x->parent;
-
-            if (y->parent){
-                if (y->parent->right == x)
-                    y->parent->right = y;
-                else
-                    y->parent->left = y;
-            }
-            x->parent = y;
-            x->right = y->left;
-            if (x->right && x->right->parent == y)
-                x->right->parent = x;
-            y->left = x;
-            bool color = x->isBlack;
-            x->isBlack = y->isBlack;
-            y->isBlack = color;
-            if (!y->parent)
-                *root = y;
-        }
+		void rotate_right(p_node x, p_node *root){
+			p_node y = x->left;
+
+			x->left = y->right;
+			if (x->left)
+				x->left->parent = x;
+			y->parent = x->parent;
+			if (!y->parent)
+				*root = y;
+			else if (y->parent->left == x)
+				y->parent->left = y;
+			else
+				y->parent->right = y;
+			y->right = x;
+			x->parent = y;
+		}
+
+		void rotate_left(p_node x, p_node *root){
+			p_node y = x->right;
+
+			x->right = y->left;
+			if (x->right)
+				x->right->parent = x;
+			y->parent = x->parent;
+			if (!y->parent)
+				*root = y;
+			else if (y->parent->left == x)
+				y->parent->left = y;
+			else
+				y->parent->right = y;
+			y->left = x;
+			x->parent = y;
+		}
 
 		p_node min_node(p_node node) const{
 			if (node)
@@ -88,12 +92,23 @@ namespace ft
 			return node;
 		}
 
-        void swap_color(p_node node){
-            bool color = node->isBlack;
-            node->isBlack = node->right->isBlack;
-            node->right->isBlack = color;
-            node->left->isBlack = color;
-        }
+		p_node next_node(p_node node) const{
+			if (node->right)
+				return min_node(node->right);
+			while (node->parent && node->parent->right == node)
+				node = node->parent;
+			return node->parent;
+		}
+
+		bool is_black(p_node node) const{
+			return !node || node->isBlack;}
+
+		size_type black_height(p_node node) const{
+			size_type height = 0;
+			for (; node; node = node->left)
+				height += node->isBlack;
+			return height;
+		}
 
 		p_node find_node(p_node node, value key) const{
 			if (node){
@@ -105,6 +120,45 @@ namespace ft
 			return node;
 		}
 
+		// Descends for up to batch_width keys in lockstep so their cache misses overlap.
+		template<class KeyIterator>
+		KeyIterator find_batch(p_node root, KeyIterator first, KeyIterator last, p_node *found) const{
+			KeyIterator keys[batch_width];
+			p_node cur[batch_width];
+			p_node node;
+			size_type count = 0;
+			size_type active;
+
+			for (; count < batch_width && first != last; ++count, ++first){
+				keys[count] = first;
+				cur[count] = root;
+				found[count] = 0;
+			}
+			active = root ? count : 0;
+			while (active){
+				active = 0;
+				for (size_type i = 0; i < count; ++i){
+					node = cur[i];
+					if (!node)
+						continue;
+					if (compare_(node->value, *keys[i]))
+						node = node->right;
+					else if (compare_(*keys[i], node->value))
+						node = node->left;
+					else{
+						found[i] = node;
+						node = 0;
+					}
+					if (node){
+						ft::prefetch(node);
+						++active;
+					}
+					cur[i] = node;
+				}
+			}
+			return first;
+		}
+
 		p_node lowest_elem(p_node lowest, value cur_val) const{
 			p_node node = 0;
             while (lowest){
@@ -124,72 +178,78 @@ namespace ft
 			return lowest;
 		}
 
-		void clear(p_node *root){
+		size_type clear(p_node *root){
+			size_type count = 0;
+
 			if (*root == 0)
-				return;
-			if (*root){
-				if ((*root)->left)
-					clear(&((*root)->left));
-				if ((*root)->right)
-					clear(&((*root)->right));
-				delete_node((*root));
-			}
+				return count;
+			if ((*root)->left)
+				count += clear(&((*root)->left));
+			if ((*root)->right)
+				count += clear(&((*root)->right));
+			delete_node((*root));
 			*root = 0;
+			return count + 1;
 		}
 
 		size_type max_size() const{
             return allocator_.max_size();}
 
-		void balance(p_node *root, p_node node){
+		bool balance(p_node *root, p_node node){
 			p_node parent;
 			p_node grand;
-			p_node tmp;
+			p_node uncle;
+			bool grew;
 
-			while (node){
+			while (node != *root && !node->parent->isBlack){
 				parent = node->parent;
-				grand = 0;
-				tmp = parent;
-				if (parent){
-					grand = parent->parent;
-					if (node->isBlack == false){
-						if (parent->isBlack == true)
-                            node = parent;
-						else if (grand){
-							if (grand->left && grand->left->isBlack == false && grand->right && grand->right->isBlack == false){
-								swap_color(grand);
-                                node = grand;
-							}
-							else if (grand->right == parent){
-								if (parent->left == node){
-									rotate_right(parent, root);
-									parent = node;
-								}
-								if (parent->right == node)
-									rotate_left(grand, root);
-                                node = parent->parent;
-							}
-							else{
-								if (parent->right == node){
-									rotate_left(parent, root);
-									parent = node;
-								}
-								if (parent->left == node)
-									rotate_right(grand, root);
-                                node = parent->parent;
-							}
+				grand = parent->parent;
+				if (grand->left == parent){
+					uncle = grand->right;
+					if (!is_black(uncle)){
+						parent->isBlack = true;
+						uncle->isBlack = true;
+						grand->isBlack = false;
+						node = grand;
+					}
+					else{
+						if (parent->right == node){
+							node = parent;
+							rotate_left(node, root);
+							parent = node->parent;
 						}
+						parent->isBlack = true;
+						grand->isBlack = false;
+						rotate_right(grand, root);
 					}
-					else
-                        node = parent;
 				}
 				else{
-                    node->isBlack = true;
-                    node = node->parent;
+					uncle = grand->left;
+					if (!is_black(uncle)){
+						parent->isBlack = true;
+						uncle->isBlack = true;
+						grand->isBlack = false;
+						node = grand;
+					}
+					else{
+						if (parent->left == node){
+							node = parent;
+							rotate_right(node, root);
+							parent = node->parent;
+						}
+						parent->isBlack = true;
+						grand->isBlack = false;
+						rotate_left(grand, root);
+					}
 				}
 			}
+			grew = !(*root)->isBlack;
+			(*root)->isBlack = true;
+			return grew;
 		}
 
 		bool insert(p_node *root, p_node new_node){
+			new_node->isBlack = false;
 			if (*root == 0){
 				*root = new_node;
                 new_node->isBlack = true;}
@@ -221,162 +281,316 @@ namespace ft
 			return true;
 		}
 
-		void swap_pointers(p_node remove, p_node replace){
-			if (remove->parent){
-				if (remove->parent->left == remove)
-					remove->parent->left = replace;
-				else
-					remove->parent->right = replace;
-			}
-			replace->parent = remove->parent;
-			if (remove->left){
-				remove->left->parent = replace;
-			}
-			replace->left = remove->left;
-			if (remove->right){
-				remove->right->parent = replace;
-			}
-			replace->right = remove->right;
-			replace->isBlack = remove->isBlack;
+		void swap_pointers(p_node *root, p_node remove, p_node replace){
+			if (!remove->parent)
+				*root = replace;
+			else if (remove->parent->left == remove)
+				remove->parent->left = replace;
+			else
+				remove->parent->right = replace;
+			if (replace)
+				replace->parent = remove->parent;
 		}
 
 		bool erase(p_node *root, value key){
 			p_node remove = find_node(*root, key);
 
 			if (remove){
-				p_node replace = 0;
-				if (remove->left)
-					replace = erase_left(remove, root);
-				else if (remove->right)
-					replace = erase_right(remove, root);
-				else
-					no_child_case(remove, root);
-				if (replace)
-					swap_pointers(remove, replace);
-				if (remove == *root){
-					if (replace)
-						*root = replace;
-					else
-						*root = 0;
-				}
-				delete_node(remove);
+				erase_node(root, remove);
 				return true;
 			}
 			return false;
 		}
 
-		p_node erase_left(p_node some, p_node *root){
-			p_node replace = max_node(some->left);
+		p_node erase_node(p_node *root, p_node remove){
+			p_node next = next_node(remove);
 
-			if (replace){
-				if (replace == some->left){
-					some->left = replace->left;
-					if (replace->left)
-						replace->left->parent = some;
-				}
+			unlink_node(root, remove);
+			delete_node(remove);
+			return next;
+		}
+
+		void unlink_node(p_node *root, p_node remove){
+			p_node child;
+			p_node parent;
+			bool black = remove->isBlack;
+
+			if (remove->left && remove->right){
+				p_node replace = min_node(remove->right);
+
+				black = replace->isBlack;
+				child = replace->right;
+				if (replace->parent == remove)
+					parent = replace;
 				else{
-					replace->parent->right = replace->left;//*
-					if (replace->left)
-						replace->left->parent = replace->parent;
-				}
-				if (replace->isBlack == true){
-					if (replace->left && replace->left->isBlack == false)
-						replace->left->isBlack = true;
-					erase_balance(root, replace->parent);
+					parent = replace->parent;
+					swap_pointers(root, replace, child);
+					replace->right = remove->right;
+					replace->right->parent = replace;
 				}
+				swap_pointers(root, remove, replace);
+				replace->left = remove->left;
+				replace->left->parent = replace;
+				replace->isBlack = remove->isBlack;
+			}
+			else{
+				child = remove->left ? remove->left : remove->right;
+				parent = remove->parent;
+				swap_pointers(root, remove, child);
 			}
-			return replace;
+			if (black)
+				erase_balance(root, child, parent);
+			remove->left = 0;
+			remove->right = 0;
+			remove->parent = 0;
 		}
 
-		p_node erase_right(p_node some, p_node *root){//*
-			p_node replace = min_node(some->right);
+		void erase_balance(p_node *root, p_node some, p_node parent){
+			p_node brother;
 
-			if (replace){
-				if (replace == some->right){
-					some->right = replace->right;
-					if (replace->right)
-						replace->right->parent = some;
+			while (some != *root && is_black(some)){
+				if (parent->left == some){
+					brother = parent->right;
+					if (!brother->isBlack){
+						brother->isBlack = true;
+						parent->isBlack = false;
+						rotate_left(parent, root);
+						brother = parent->right;
+					}
+					if (is_black(brother->left) && is_black(brother->right)){
+						brother->isBlack = false;
+						some = parent;
+						parent = some->parent;
+					}
+					else{
+						if (is_black(brother->right)){
+							brother->left->isBlack = true;
+							brother->isBlack = false;
+							rotate_right(brother, root);
+							brother = parent->right;
+						}
+						brother->isBlack = parent->isBlack;
+						parent->isBlack = true;
+						brother->right->isBlack = true;
+						rotate_left(parent, root);
+						some = *root;
+					}
 				}
 				else{
-					replace->parent->left = replace->right;
-					if (replace->right)
-						replace->right->parent = replace->parent;
+					brother = parent->left;
+					if (!brother->isBlack){
+						brother->isBlack = true;
+						parent->isBlack = false;
+						rotate_right(parent, root);
+						brother = parent->left;
+					}
+					if (is_black(brother->left) && is_black(brother->right)){
+						brother->isBlack = false;
+						some = parent;
+						parent = some->parent;
+					}
+					else{
+						if (is_black(brother->left)){
+							brother->right->isBlack = true;
+							brother->isBlack = false;
+							rotate_left(brother, root);
+							brother = parent->left;
+						}
+						brother->isBlack = parent->isBlack;
+						parent->isBlack = true;
+						brother->left->isBlack = true;
+						rotate_right(parent, root);
+						some = *root;
+					}
 				}
-				if (replace->isBlack == true){
-					if (replace->right && replace->right->isBlack == false)
-						replace->right->isBlack = true;
-					erase_balance(root, replace->parent);
+			}
+			if (some)
+				some->isBlack = true;
+		}
+
+		// Links left < mid < right into one tree in O(|left_height - right_height| + 1).
+		p_node join(p_node left, size_type left_height, p_node mid, p_node right, size_type right_height, size_type *height){
+			p_node root;
+			p_node cur;
+			p_node parent = 0;
+			size_type cur_height;
+
+			if (left && !left->isBlack){
+				left->isBlack = true;
+				++left_height;
+			}
+			if (right && !right->isBlack){
+				right->isBlack = true;
+				++right_height;
+			}
+			mid->isBlack = false;
+			if (left_height == right_height){
+				mid->left = left;
+				mid->right = right;
+				mid->parent = 0;
+				if (left)
+					left->parent = mid;
+				if (right)
+					right->parent = mid;
+				mid->isBlack = true;
+				*height = left_height + 1;
+				return mid;
+			}
+			if (left_height > right_height){
+				root = left;
+				cur = left;
+				cur_height = left_height;
+				while (cur && (cur_height != right_height || !cur->isBlack)){
+					cur_height -= cur->isBlack;
+					parent = cur;
+					cur = cur->right;
+				}
+				mid->left = cur;
+				mid->right = right;
+				parent->right = mid;
+				*height = left_height;
+			}
+			else{
+				root = right;
+				cur = right;
+				cur_height = right_height;
+				while (cur && (cur_height != left_height || !cur->isBlack)){
+					cur_height -= cur->isBlack;
+					parent = cur;
+					cur = cur->left;
 				}
+				mid->left = left;
+				mid->right = cur;
+				parent->left = mid;
+				*height = right_height;
 			}
-			return replace;
+			mid->parent = parent;
+			if (mid->left)
+				mid->left->parent = mid;
+			if (mid->right)
+				mid->right->parent = mid;
+			*height += balance(&root, mid);
+			return root;
+		}
+
+		p_node attach(p_node mid, p_node left, p_node right, bool red){
+			mid->left = left;
+			mid->right = right;
+			mid->parent = 0;
+			mid->isBlack = !red;
+			if (left)
+				left->parent = mid;
+			if (right)
+				right->parent = mid;
+			return mid;
+		}
+
+		// Depth of the incomplete last level of an n-node tree built by build_sorted, or n if it is full.
+		static size_type red_depth(size_type n){
+			size_type depth = 0;
+
+			if (!((n + 1) & n))
+				return n;
+			while (n >>= 1)
+				++depth;
+			return depth;
+		}
+
+		// Links nodes[0, n), already in key order, by halving; only the last level can be incomplete
+		// and its nodes are red, so every path carries the same number of black nodes.
+		p_node build_sorted(p_node *nodes, size_type n, size_type depth, size_type red){
+			size_type mid = n / 2;
+
+			if (!n)
+				return 0;
+			return attach(nodes[mid], build_sorted(nodes, mid, depth + 1, red),
+					build_sorted(nodes + mid + 1, n - mid - 1, depth + 1, red), depth == red);
 		}
 
-		p_node no_child_case(p_node some, p_node *root)
-		{
-			p_node replace = some;
-
-			if (replace && replace->parent){
-				if (replace->parent->right == replace)
-					replace->parent->right = 0;
-				else
-					replace->parent->left = 0;
-				if (replace->isBlack == true){
-					if (replace->right && replace->right->isBlack == false)
-						replace->right->isBlack = true;
-					erase_balance(root, replace->parent);
+		// Cuts the tree holding `node` into the elements before it and the rest, walking up once.
+		void split(p_node node, p_node *left, size_type *left_height, p_node *right, size_type *right_height){
+			p_node up = node->parent;
+			p_node next;
+			p_node sub;
+			bool from_right = up && up->right == node;
+			bool next_from_right;
+			bool black;
+			size_type sub_height = black_height(node->left);
+
+			*left = node->left;
+			*left_height = sub_height;
+			if (*left)
+				(*left)->parent = 0;
+			sub = node->right;
+			if (sub)
+				sub->parent = 0;
+			black = node->isBlack;
+			node->left = 0;
+			*right = join(0, 0, node, sub, sub_height, right_height);
+			sub_height += black;
+			while (up){
+				next = up->parent;
+				next_from_right = next && next->right == up;
+				black = up->isBlack;
+				if (from_right){
+					sub = up->left;
+					if (sub)
+						sub->parent = 0;
+					*left = join(sub, sub_height, up, *left, *left_height, left_height);
+				}
+				else{
+					sub = up->right;
+					if (sub)
+						sub->parent = 0;
+					*right = join(*right, *right_height, up, sub, sub_height, right_height);
 				}
+				sub_height += black;
+				up = next;
+				from_right = next_from_right;
 			}
-			return replace;
 		}
 
-		void erase_balance(p_node *root, p_node some){
-			p_node right;
+		// Removes [first, last) and returns the count; long runs are split off and freed whole.
+		size_type erase_range(p_node *root, p_node first, p_node last){
+			size_type limit = 2 * black_height(*root) + 1;
+			size_type count = 0;
+			p_node cur = first;
 			p_node left;
-			p_node brother;
+			p_node middle;
+			p_node right = 0;
+			p_node mid;
+			size_type left_height;
+			size_type middle_height;
+			size_type right_height = 0;
 
-			while (some != *root && some->isBlack){
-				brother = some->right;
-				if (brother){
-					right = brother->right;
-					left = brother->left;
-					if ((right || left) && (!right || right->isBlack == true) &&
-						(!left || left->isBlack == true)){
-						if (brother->isBlack == true){
-							brother->isBlack = false;
-							some->isBlack = true;
-							rotate_left(some, root);
-						}
-						else
-							some = some->parent;
-					}
-					else if (right && brother->isBlack == true){
-						if (left && left->isBlack == false &&
-							right->isBlack == true){
-							rotate_right(brother, root);
-							right = brother;
-							brother = left;
-						}
-						if (right->isBlack == false &&
-							(!left || left->isBlack == true || !some->left))
-							rotate_left(some, root);
-						else
-							some = some->parent;
-					}
-					else if (brother->isBlack == true &&
-							   some->isBlack == false){
-						some->isBlack = true;
-						brother->isBlack = false;
-						some = some->parent;
-					}
-					else
-						some = some->parent;
-				}
-				else
-					break;
+			while (cur != last && count < limit){
+				cur = next_node(cur);
+				++count;
+			}
+			if (cur == last){
+				while (first != last)
+					first = erase_node(root, first);
+				return count;
+			}
+			split(first, &left, &left_height, &middle, &middle_height);
+			if (last)
+				split(last, &middle, &middle_height, &right, &right_height);
+			count = clear(&middle);
+			if (!left || !right)
+				*root = left ? left : right;
+			else{
+				mid = min_node(right);
+				unlink_node(&right, mid);
+				*root = join(left, left_height, mid, right, black_height(right), &middle_height);
+			}
+			if (*root){
+				(*root)->parent = 0;
+				(*root)->isBlack = true;
 			}
+			return count;
 		}
 	private:
 		allocator_type 		allocator_;
 		key_compare 		compare_;
 	};
-}
\ No newline at end of file
+}
@@ -0,0 +1,348 @@
+#pragma once
+
+#include <new>
+#include <mutex>
+#include <memory>
+#include <cstddef>
+#include <cstdlib>
+#include <functional>
+#include "../utils/less.hpp"
+#include "../utils/pair.hpp"
+#include "../utils/cache_line.hpp"
+#include "../vector/vector.hpp"
+#include "../parallel/thread_pool.hpp"
+#include "map.hpp"
+
+namespace ft{
+    // Spreads keys evenly whatever their order; the shards then overlap in key range.
+    template <class Key>
+    struct hash_partition{
+        size_t operator()(const Key &key, size_t shards) const {
+            unsigned long long h = std::hash<Key>()(key);
+
+            h ^= h >> 33;
+            h *= 0xff51afd7ed558ccdULL;
+            h ^= h >> 33;
+            return static_cast<size_t>(h % shards);
+        }
+    };
+
+    // Shard i holds the keys in [bounds[i - 1], bounds[i]), so the shards are ordered slices of the key
+    // space and ordered iteration never interleaves them.
+    template <class Key, class Compare = ft::less<Key> >
+    struct range_partition{
+        ft::vector<Key> bounds;
+        Compare comp;
+
+        range_partition() {}
+
+        template <class InputIterator>
+        range_partition(InputIterator first, InputIterator last, const Compare &c = Compare()) : comp(c) {
+            for (; first != last; ++first)
+                bounds.push_back(*first);
+        }
+
+        size_t operator()(const Key &key, size_t shards) const {
+            size_t lo = 0;
+            size_t hi = bounds.size();
+
+            while (lo < hi) {
+                size_t mid = lo + (hi - lo) / 2;
+                if (comp(key, bounds[mid]))
+                    hi = mid;
+                else
+                    lo = mid + 1;
+            }
+            return lo < shards ? lo : shards - 1;
+        }
+    };
+
+    // Yields the values of every shard in key order by a k-way merge over the shard cursors, kept in a
+    // binary min-heap on the key.
+    template <class Map, size_t Shards>
+    class sharded_map_iterator{
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef typename Map::pair_type value_type;
+        typedef ptrdiff_t difference_type;
+        typedef const value_type *pointer;
+        typedef const value_type &reference;
+        typedef typename Map::const_iterator map_iterator;
+        typedef typename Map::key_compare key_compare;
+
+        sharded_map_iterator() : count_(0) {}
+
+        sharded_map_iterator(const Map *const *maps, const key_compare &comp) : count_(0), comp_(comp) {
+            for (size_t i = 0; i < Shards; ++i) {
+                if (maps[i]->empty())
+                    continue;
+                cursor c = {maps[i]->begin(), maps[i]->end()};
+                heap_[count_++] = c;
+            }
+            for (size_t i = count_ / 2; i-- > 0; )
+                sift_down(i);
+        }
+
+        reference operator*() const {
+            return *heap_[0].first.operator->();
+        }
+
+        pointer operator->() const {
+            return heap_[0].first.operator->();
+        }
+
+        sharded_map_iterator &operator++() {
+            if (++heap_[0].first == heap_[0].last)
+                heap_[0] = heap_[--count_];
+            if (count_)
+                sift_down(0);
+            return *this;
+        }
+
+        sharded_map_iterator operator++(int) {
+            sharded_map_iterator tmp = *this;
+            ++(*this);
+            return tmp;
+        }
+
+        bool operator==(const sharded_map_iterator &it) const {
+            if (!count_ || !it.count_)
+                return count_ == it.count_;
+            return heap_[0].first == it.heap_[0].first;
+        }
+
+        bool operator!=(const sharded_map_iterator &it) const {
+            return !(*this == it);
+        }
+
+    private:
+        struct cursor{
+            map_iterator first;
+            map_iterator last;
+        };
+
+        cursor heap_[Shards];
+        size_t count_;
+        key_compare comp_;
+
+        bool less(size_t a, size_t b) const {
+            return comp_(heap_[a].first->first, heap_[b].first->first);
+        }
+
+        void sift_down(size_t i) {
+            for (;;) {
+                size_t child = 2 * i + 1;
+                if (child >= count_)
+                    return;
+                if (child + 1 < count_ && less(child + 1, child))
+                    ++child;
+                if (!less(child, i))
+                    return;
+                cursor tmp = heap_[i];
+                heap_[i] = heap_[child];
+                heap_[child] = tmp;
+                i = child;
+            }
+        }
+    };
+
+    // Shards independent ft::maps, each behind its own lock on its own cache line, so writers to
+    // different shards never contend. Single-key operations lock one shard. Ordered iteration through
+    // begin()/end() merges the shards and needs the writers to be quiescent; ordered_for_each locks
+    // every shard for the duration instead.
+    template <class Key, class T, size_t Shards = 16, class Partition = ft::hash_partition<Key>,
+              class Compare = ft::less<Key>, class Alloc = std::allocator<ft::pair<const Key, T> > >
+    class sharded_map{
+        public:
+            typedef Key key_type;
+            typedef T mapped_type;
+            typedef ft::pair<const Key, T> value_type;
+            typedef Compare key_compare;
+            typedef Partition partition_type;
+            typedef ft::map<Key, T, Compare, Alloc> map_type;
+            typedef size_t size_type;
+            typedef ft::sharded_map_iterator<map_type, Shards> const_iterator;
+            typedef const_iterator iterator;
+
+            static const size_type shard_count = Shards;
+
+            explicit sharded_map(const partition_type &partition = partition_type(), const key_compare &comp = key_compare())
+                : shards_(make_shards(comp)), partition_(partition), comp_(comp) {}
+
+            ~sharded_map() {
+                destroy_shards(shards_, Shards);
+            }
+
+            bool insert(const value_type &val) {
+                shard &s = shards_[index(val.first)];
+                std::lock_guard<std::mutex> guard(s.lock);
+
+                return s.map.insert(val).second;
+            }
+
+            // Buckets the input by shard first, so each shard is locked once for the whole batch.
+            template <class InputIterator>
+            void insert(InputIterator first, InputIterator last) {
+                ft::vector<value_type> buckets[Shards];
+
+                for (; first != last; ++first)
+                    buckets[index((*first).first)].push_back(*first);
+                for (size_type i = 0; i < Shards; ++i) {
+                    if (buckets[i].empty())
+                        continue;
+                    std::lock_guard<std::mutex> guard(shards_[i].lock);
+                    shards_[i].map.insert(buckets[i].begin(), buckets[i].end());
+                }
+            }
+
+            // Inserts a default value when the key is missing, then applies f to the mapped value
+            // under the shard lock.
+            template <class F>
+            void update(const key_type &key, F f) {
+                shard &s = shards_[index(key)];
+                std::lock_guard<std::mutex> guard(s.lock);
+
+                f(s.map[key]);
+            }
+
+            size_type erase(const key_type &key) {
+                shard &s = shards_[index(key)];
+                std::lock_guard<std::mutex> guard(s.lock);
+
+                return s.map.erase(key);
+            }
+
+            // Copies the mapped value out, since a reference would outlive the lock.
+            bool find(const key_type &key, mapped_type &out) const {
+                const shard &s = shards_[index(key)];
+                std::lock_guard<std::mutex> guard(s.lock);
+                typename map_type::const_iterator it = s.map.find(key);
+
+                if (it == s.map.end())
+                    return false;
+                out = it->second;
+                return true;
+            }
+
+            size_type count(const key_type &key) const {
+                const shard &s = shards_[index(key)];
+                std::lock_guard<std::mutex> guard(s.lock);
+
+                return s.map.count(key);
+            }
+
+            size_type size() const {
+                size_type res = 0;
+
+                for (size_type i = 0; i < Shards; ++i) {
+                    std::lock_guard<std::mutex> guard(shards_[i].lock);
+                    res += shards_[i].map.size();
+                }
+                return res;
+            }
+
+            bool empty() const {
+                return !size();
+            }
+
+            void clear() {
+                for (size_type i = 0; i < Shards; ++i) {
+                    std::lock_guard<std::mutex> guard(shards_[i].lock);
+                    shards_[i].map.clear();
+                }
+            }
+
+            // Runs f(shard_index, map) for every shard on the default thread pool, each under its lock.
+            template <class F>
+            void for_each_shard(F f) {
+                ft::default_thread_pool().parallel_for(0, Shards, [&](size_t begin, size_t end) {
+                    for (size_t i = begin; i < end; ++i) {
+                        std::lock_guard<std::mutex> guard(shards_[i].lock);
+                        f(i, shards_[i].map);
+                    }
+                }, 1);
+            }
+
+            // Locks every shard in index order, then visits all values in key order.
+            template <class F>
+            void ordered_for_each(F f) const {
+                for (size_type i = 0; i < Shards; ++i)
+                    shards_[i].lock.lock();
+                try {
+                    for (const_iterator it = begin(); it != end(); ++it)
+                        f(*it);
+                }
+                catch (...) {
+                    unlock_all();
+                    throw;
+                }
+                unlock_all();
+            }
+
+            const_iterator begin() const {
+                const map_type *maps[Shards];
+
+                for (size_type i = 0; i < Shards; ++i)
+                    maps[i] = &shards_[i].map;
+                return const_iterator(maps, comp_);
+            }
+
+            const_iterator end() const {
+                return const_iterator();
+            }
+
+            size_type shard_of(const key_type &key) const {
+                return index(key);
+            }
+
+        private:
+            sharded_map(const sharded_map &);
+            sharded_map &operator=(const sharded_map &);
+
+            struct alignas(ft::cache_line_size) shard{
+                mutable std::mutex lock;
+                map_type map;
+
+                explicit shard(const key_compare &comp) : map(comp) {}
+            };
+
+            shard *shards_;
+            partition_type partition_;
+            key_compare comp_;
+
+            size_type index(const key_type &key) const {
+                return partition_(key, Shards);
+            }
+
+            // Each shard starts its own cache line, which plain new does not honour before C++17, so
+            // the shards get storage aligned by hand.
+            static shard *make_shards(const key_compare &comp) {
+                void *storage;
+                size_type built = 0;
+
+                if (posix_memalign(&storage, alignof(shard), sizeof(shard) * Shards))
+                    throw std::bad_alloc();
+                shard *shards = static_cast<shard *>(storage);
+                try {
+                    for (; built < Shards; ++built)
+                        new (shards + built) shard(comp);
+                }
+                catch (...) {
+                    destroy_shards(shards, built);
+                    throw;
+                }
+                return shards;
+            }
+
+            static void destroy_shards(shard *shards, size_type n) {
+                while (n)
+                    shards[--n].~shard();
+                free(shards);
+            }
+
+            void unlock_all() const {
+                for (size_type i = Shards; i-- > 0; )
+                    shards_[i].lock.unlock();
+            }
+    };
+}
@@ -0,0 +1,306 @@
+#pragma once
+
+#include <cstring>
+#include <cstddef>
+#include <utility>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include "../utils/pair.hpp"
+#include "../utils/sort.hpp"
+#include "../utils/external_sort.hpp"
+#include "../vector/vector.hpp"
+#include "../vector/vector_io.hpp"
+
+namespace ft{
+    struct sorted_input_t{};
+    struct spill_input_t{};
+
+    // Input already in key order is streamed into the tree; anything else is sorted in bounded runs
+    // spilled to temporary files and merged back. Either way the first of equal keys is kept.
+    static const sorted_input_t sorted_input = sorted_input_t();
+    static const spill_input_t spill_input = spill_input_t();
+
+    // Types whose bytes can be written out and read back: trivially copyable ones, and ft::pairs of
+    // them (ft::pair declares its copy operations, so the standard trait says no).
+    template <class T>
+    struct bitwise_copyable : std::is_trivially_copyable<T>{};
+
+    template <class A, class B>
+    struct bitwise_copyable<ft::pair<A, B> >
+        : std::integral_constant<bool, bitwise_copyable<typename std::remove_const<A>::type>::value
+                                       && bitwise_copyable<B>::value>{};
+
+    namespace stream_detail
+    {
+        static const size_t batch_records = 4096;
+        static const size_t run_records = 1 << 20;
+        static const size_t max_runs = 64;
+    }
+
+    // Reads fixed-size binary records from fd in batches of a fixed size, so memory stays constant
+    // whatever the file length. begin()/end() make it an input range for the sorted_input and
+    // spill_input constructors.
+    template <class Value>
+    class record_reader{
+        public:
+            class iterator{
+            public:
+                typedef std::input_iterator_tag iterator_category;
+                typedef Value value_type;
+                typedef ptrdiff_t difference_type;
+                typedef const Value *pointer;
+                typedef const Value &reference;
+
+                iterator() : reader_(0) {}
+
+                explicit iterator(record_reader *reader) : reader_(reader) {
+                    ++(*this);
+                }
+
+                reference operator*() const {
+                    return value_;
+                }
+
+                pointer operator->() const {
+                    return &value_;
+                }
+
+                iterator &operator++() {
+                    if (reader_ && !reader_->next(value_))
+                        reader_ = 0;
+                    return *this;
+                }
+
+                bool operator==(const iterator &it) const {
+                    return reader_ == it.reader_;
+                }
+
+                bool operator!=(const iterator &it) const {
+                    return reader_ != it.reader_;
+                }
+
+            private:
+                record_reader *reader_;
+                Value value_;
+            };
+
+            explicit record_reader(int fd, size_t batch = stream_detail::batch_records)
+                : fd_(fd), buffer_(batch * sizeof(Value)), pos_(0), end_(0) {
+                static_assert(ft::bitwise_copyable<Value>::value, "record_reader needs bitwise copyable records");
+            }
+
+            bool next(Value &out) {
+                if (pos_ == end_) {
+                    end_ = vector_io_detail::read_some(fd_, &buffer_[0], buffer_.size(), "ft::record_reader");
+                    pos_ = 0;
+                    if (end_ % sizeof(Value))
+                        throw std::runtime_error("ft::record_reader: truncated record");
+                    if (!end_)
+                        return false;
+                }
+                std::memcpy(static_cast<void *>(&out), &buffer_[pos_], sizeof(Value));
+                pos_ += sizeof(Value);
+                return true;
+            }
+
+            iterator begin() {
+                return iterator(this);
+            }
+
+            iterator end() {
+                return iterator();
+            }
+
+        private:
+            record_reader(const record_reader &);
+            record_reader &operator=(const record_reader &);
+
+            int fd_;
+            ft::vector<char> buffer_;
+            size_t pos_;
+            size_t end_;
+    };
+
+    // Builds a red-black tree from nodes pushed in key order, like a binary counter: the spine holds
+    // perfect all-black subtrees of strictly decreasing height, each followed by the node after it,
+    // and two equal heights are joined under that node. finish() joins the spine right to left. The
+    // spine is a fixed array, so the only memory beyond the nodes is O(log n).
+    template <class Tree>
+    class spine_builder{
+        public:
+            typedef typename Tree::p_node p_node;
+            typedef typename Tree::size_type size_type;
+
+            explicit spine_builder(Tree &tree) : tree_(tree), depth_(0), last_(0), last_height_(0), count_(0) {}
+
+            void push(p_node node) {
+                entry e = {last_, last_height_, node};
+
+                spine_[depth_++] = e;
+                last_ = 0;
+                last_height_ = 0;
+                while (depth_ && spine_[depth_ - 1].height == last_height_) {
+                    --depth_;
+                    last_ = tree_.attach(spine_[depth_].pivot, spine_[depth_].tree, last_, false);
+                    ++last_height_;
+                }
+                ++count_;
+            }
+
+            size_type size() const {
+                return count_;
+            }
+
+            // Returns the root of everything pushed and leaves the builder empty.
+            p_node finish() {
+                p_node root = last_;
+                size_type height = last_height_;
+
+                while (depth_) {
+                    --depth_;
+                    root = tree_.join(spine_[depth_].tree, spine_[depth_].height, spine_[depth_].pivot, root, height, &height);
+                }
+                if (root) {
+                    root->parent = 0;
+                    root->isBlack = true;
+                }
+                last_ = 0;
+                last_height_ = 0;
+                count_ = 0;
+                return root;
+            }
+
+        private:
+            struct entry{
+                p_node tree;
+                size_type height;
+                p_node pivot;
+            };
+
+            Tree &tree_;
+            entry spine_[8 * sizeof(size_type)];
+            size_type depth_;
+            p_node last_;
+            size_type last_height_;
+            size_type count_;
+    };
+
+    namespace stream_detail
+    {
+        // Feeds values in key order to a spine_builder, dropping repeats of the previous key. On
+        // an exception the nodes made so far are freed.
+        template <class Tree, class Less>
+        class sorted_sink{
+            public:
+                typedef typename Tree::p_node p_node;
+
+                sorted_sink(Tree &tree, const Less &less) : tree_(tree), less_(less), builder_(tree), prev_(0) {}
+
+                ~sorted_sink() {
+                    p_node root = builder_.finish();
+                    tree_.clear(&root);
+                }
+
+                template <class Value>
+                void push(const Value &val) {
+                    if (prev_ && !less_(prev_->value, val)) {
+                        if (less_(val, prev_->value))
+                            throw std::invalid_argument("ft::sorted_input: keys out of order");
+                        return;
+                    }
+                    prev_ = tree_.create_node(val);
+                    builder_.push(prev_);
+                }
+
+                p_node release(size_t *count) {
+                    *count = builder_.size();
+                    prev_ = 0;
+                    return builder_.finish();
+                }
+
+            private:
+                Tree &tree_;
+                const Less &less_;
+                ft::spine_builder<Tree> builder_;
+                p_node prev_;
+        };
+
+        // Owns the spilled runs: one temporary file they are appended to, and a spare one for
+        // external_sort's merge passes. Both vanish when closed.
+        template <class Value>
+        struct spill{
+            external_sort_detail::io_thread io;
+            external_sort_detail::temporary_file file;
+            external_sort_detail::temporary_file spare;
+            ft::vector<external_sort_detail::span> runs;
+            unsigned long long records;
+
+            spill() : records(0) {}
+
+            void write(const Value *data, size_t n) {
+                external_sort_detail::span s = {records, n};
+
+                vector_io_detail::write_all(file.fd(), data, n * sizeof(Value), "ft::spill_input");
+                runs.push_back(s);
+                records += n;
+            }
+
+            // Merges groups of max_runs runs a generation at a time, as external_sort does, so every
+            // record is rewritten once per pass, then merges the last max_runs into the sink.
+            template <class Sink, class Less>
+            void merge(Sink &sink, const Less &less) {
+                int from = file.fd();
+                int to = spare.fd();
+
+                external_sort_detail::merge_passes<Value>(io, from, to, runs, max_runs, batch_records, less);
+                external_sort_detail::merge<Value>(io, from, runs, 0, runs.size(), sink, batch_records, less);
+            }
+        };
+    }
+
+    // Returns the root of a tree holding the distinct keys of [first, last), which must be in key
+    // order, in one pass over the input; nothing but the nodes is kept.
+    template <class Value, class Tree, class InputIterator, class Less>
+    typename Tree::p_node stream_build(Tree &tree, InputIterator first, InputIterator last, const Less &less,
+                                       size_t *count) {
+        stream_detail::sorted_sink<Tree, Less> sink(tree, less);
+
+        for (; first != last; ++first)
+            sink.push(*first);
+        return sink.release(count);
+    }
+
+    // Same for input in any order: up to run_records values are buffered, stable sorted and spilled
+    // to a temporary file once the buffer fills, and the runs are merged straight into the tree.
+    template <class Value, class Tree, class InputIterator, class Less>
+    typename Tree::p_node spill_build(Tree &tree, InputIterator first, InputIterator last, const Less &less,
+                                      size_t run_records, size_t *count) {
+        static_assert(ft::bitwise_copyable<Value>::value, "ft::spill_input needs bitwise copyable values");
+        stream_detail::sorted_sink<Tree, Less> sink(tree, less);
+        ft::vector<Value> buffer;
+
+        buffer.reserve(run_records);
+        for (; first != last && buffer.size() < run_records; ++first)
+            buffer.push_back(Value(*first));
+        if (!buffer.empty())
+            ft::stable_sort(&buffer[0], &buffer[0] + buffer.size(), less);
+        if (first == last) {
+            for (size_t i = 0; i < buffer.size(); ++i)
+                sink.push(buffer[i]);
+            return sink.release(count);
+        }
+        stream_detail::spill<Value> spilled;
+        for (;;) {
+            spilled.write(&buffer[0], buffer.size());
+            buffer.clear();
+            for (; first != last && buffer.size() < run_records; ++first)
+                buffer.push_back(Value(*first));
+            if (buffer.empty())
+                break;
+            ft::stable_sort(&buffer[0], &buffer[0] + buffer.size(), less);
+        }
+        spilled.merge(sink, less);
+        return sink.release(count);
+    }
+}
@@ -0,0 +1,166 @@
+#pragma once
+
+#include <new>
+#include <limits>
+#include <cstddef>
+#include <sys/mman.h>
+#include <unistd.h>
+#ifdef FT_HAVE_LIBNUMA
+#include <numa.h>
+#endif
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+
+namespace ft{
+    // Where the pages of a large block go: wherever they are first touched, on the allocating thread's
+    // node, or spread round-robin over every node the process may use.
+    enum numa_policy{
+        numa_first_touch,
+        numa_local,
+        numa_interleave
+    };
+
+    namespace numa_detail
+    {
+        // Blocks below this come from operator new, placement only matters for huge arrays.
+        static const size_t map_threshold = 1 << 21;
+
+        inline size_t page_round(size_t bytes) {
+            size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+            return (bytes + page - 1) / page * page;
+        }
+
+#ifdef __linux__
+        static const int mpol_preferred = 1;
+        static const int mpol_interleave = 3;
+        static const unsigned long mpol_f_mems_allowed = 4;
+        static const unsigned long mask_bits = 1024;
+
+        // Raw mbind, so the fallback needs no libnuma. Failures (no NUMA support, seccomp) just leave
+        // the default first-touch placement.
+        inline void bind(void *address, size_t bytes, numa_policy policy) {
+            unsigned long mask[mask_bits / (8 * sizeof(unsigned long))] = {};
+            int mode = 0;
+
+            if (policy == numa_local) {
+                syscall(SYS_mbind, address, bytes, mpol_preferred, (unsigned long *)0, 0UL, 0U);
+                return;
+            }
+            if (syscall(SYS_get_mempolicy, &mode, mask, mask_bits, (void *)0, mpol_f_mems_allowed))
+                return;
+            syscall(SYS_mbind, address, bytes, mpol_interleave, mask, mask_bits, 0U);
+        }
+#else
+        inline void bind(void *, size_t, numa_policy) {}
+#endif
+
+        inline void *map(size_t bytes, numa_policy policy) {
+#ifdef FT_HAVE_LIBNUMA
+            if (policy != numa_first_touch && numa_available() >= 0) {
+                void *p = policy == numa_local ? numa_alloc_local(bytes) : numa_alloc_interleaved(bytes);
+                if (!p)
+                    throw std::bad_alloc();
+                return p;
+            }
+#endif
+            void *p = mmap(0, page_round(bytes), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0);
+            if (p == MAP_FAILED)
+                throw std::bad_alloc();
+            if (policy != numa_first_touch)
+                bind(p, page_round(bytes), policy);
+            return p;
+        }
+
+        inline void unmap(void *p, size_t bytes, numa_policy policy) {
+#ifdef FT_HAVE_LIBNUMA
+            if (policy != numa_first_touch && numa_available() >= 0) {
+                numa_free(p, bytes);
+                return;
+            }
+#endif
+            (void)policy;
+            munmap(p, page_round(bytes));
+        }
+    }
+
+    // Allocator for huge arrays: blocks from map_threshold bytes are fresh anonymous mappings placed by
+    // the policy (libnuma when built with FT_HAVE_LIBNUMA, mbind otherwise). Pair it with
+    // vector::assign(n, val, pool) so numa_first_touch pages are touched by the threads that use them.
+    template <class T>
+    class numa_allocator{
+        public:
+            typedef T value_type;
+            typedef T *pointer;
+            typedef const T *const_pointer;
+            typedef T &reference;
+            typedef const T &const_reference;
+            typedef size_t size_type;
+            typedef ptrdiff_t difference_type;
+
+            template <class U>
+            struct rebind{
+                typedef numa_allocator<U> other;
+            };
+
+            explicit numa_allocator(numa_policy policy = numa_first_touch) : policy_(policy) {}
+
+            template <class U>
+            numa_allocator(const numa_allocator<U> &src) : policy_(src.policy()) {}
+
+            numa_policy policy() const {
+                return policy_;
+            }
+
+            pointer address(reference x) const {
+                return &x;
+            }
+
+            const_pointer address(const_reference x) const {
+                return &x;
+            }
+
+            pointer allocate(size_type n, const void * = 0) {
+                if (n > max_size())
+                    throw std::bad_alloc();
+                if (n * sizeof(T) < numa_detail::map_threshold)
+                    return static_cast<pointer>(::operator new(n * sizeof(T)));
+                return static_cast<pointer>(numa_detail::map(n * sizeof(T), policy_));
+            }
+
+            void deallocate(pointer p, size_type n) {
+                if (!p)
+                    return;
+                if (n * sizeof(T) < numa_detail::map_threshold)
+                    ::operator delete(p);
+                else
+                    numa_detail::unmap(p, n * sizeof(T), policy_);
+            }
+
+            size_type max_size() const {
+                return std::numeric_limits<size_type>::max() / sizeof(T);
+            }
+
+            void construct(pointer p, const_reference val) {
+                new (p) T(val);
+            }
+
+            void destroy(pointer p) {
+                p->~T();
+            }
+
+        private:
+            numa_policy policy_;
+    };
+
+    // Policies only change placement, but libnuma blocks must go back through numa_free.
+    template <class T, class U>
+    bool operator==(const numa_allocator<T> &a, const numa_allocator<U> &b) {
+        return a.policy() == b.policy();
+    }
+
+    template <class T, class U>
+    bool operator!=(const numa_allocator<T> &a, const numa_allocator<U> &b) {
+        return !(a == b);
+    }
+}
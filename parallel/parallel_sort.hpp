@@ -0,0 +1,115 @@
+#pragma once
+
+#include <memory>
+#include <cstddef>
+#include <algorithm>
+#include <type_traits>
+#include "thread_pool.hpp"
+#include "../utils/sort.hpp"
+#include "../vector/vector.hpp"
+
+namespace ft{
+    namespace parallel_sort_detail
+    {
+        static const size_t merge_grain = 1 << 14;
+        static const size_t min_leaf = 1 << 15;
+
+        // Splits the longer run at its middle, finds the matching cut in the other one and merges the
+        // two halves independently.
+        template <class T, class Compare>
+        void merge(ft::thread_pool &pool, T *first1, T *last1, T *first2, T *last2, T *out, Compare &comp) {
+            if (last1 - first1 < last2 - first2) {
+                std::swap(first1, first2);
+                std::swap(last1, last2);
+            }
+            if (size_t((last1 - first1) + (last2 - first2)) <= merge_grain) {
+                std::merge(first1, last1, first2, last2, out, comp);
+                return;
+            }
+            T *mid1 = first1 + (last1 - first1) / 2;
+            T *mid2 = std::lower_bound(first2, last2, *mid1, comp);
+            T *split = out + (mid1 - first1) + (mid2 - first2);
+            *split = *mid1;
+            pool.invoke([&]() { merge(pool, first1, mid1, first2, mid2, out, comp); },
+                        [&]() { merge(pool, mid1 + 1, last1, mid2, last2, split + 1, comp); });
+        }
+
+        // Sorts data[0, n); the result lands in buffer when into_buffer is set. Children sort into the
+        // other array so every level costs one merge and no copy back.
+        template <class T, class Compare>
+        void sort(ft::thread_pool &pool, T *data, T *buffer, size_t n, bool into_buffer, size_t leaf, Compare &comp) {
+            if (n <= leaf) {
+                ft::sort(data, data + n, comp);
+                if (into_buffer)
+                    std::copy(data, data + n, buffer);
+                return;
+            }
+            size_t half = n / 2;
+            pool.invoke([&]() { sort(pool, data, buffer, half, !into_buffer, leaf, comp); },
+                        [&]() { sort(pool, data + half, buffer + half, n - half, !into_buffer, leaf, comp); });
+            if (into_buffer)
+                merge(pool, data, data + half, data + half, data + n, buffer, comp);
+            else
+                merge(pool, buffer, buffer + half, buffer + half, buffer + n, data, comp);
+        }
+
+        template <class T, class Compare>
+        void sort(ft::thread_pool &pool, T *data, size_t n, Compare comp) {
+            size_t leaf = n / (pool.size() * 4) + 1;
+            std::allocator<T> allocator;
+
+            if (leaf < min_leaf)
+                leaf = min_leaf;
+            if (pool.size() < 2 || n <= leaf) {
+                ft::sort(data, data + n, comp);
+                return;
+            }
+            T *buffer = allocator.allocate(n);
+            const bool trivial = std::is_trivially_copyable<T>::value;
+            if (!trivial)
+                pool.parallel_for(0, n, [&](size_t begin, size_t end) {
+                    std::uninitialized_copy(data + begin, data + end, buffer + begin);
+                });
+            sort(pool, data, buffer, n, false, leaf, comp);
+            if (!trivial)
+                pool.parallel_for(0, n, [&](size_t begin, size_t end) {
+                    for (size_t i = begin; i < end; ++i)
+                        buffer[i].~T();
+                });
+            allocator.deallocate(buffer, n);
+        }
+
+        template <class Iterator, class Compare>
+        void sort(ft::thread_pool &pool, Iterator first, Iterator last, Compare comp, std::true_type) {
+            sort(pool, ft::contiguous_iterator<Iterator>::address(first), last - first, comp);
+        }
+
+        template <class Iterator, class Compare>
+        void sort(ft::thread_pool &pool, Iterator first, Iterator last, Compare comp, std::false_type) {
+            ft::vector<typename ft::iterator_traits<Iterator>::value_type> work(first, last);
+
+            if (!work.empty())
+                sort(pool, &work[0], work.size(), comp);
+            std::copy(work.begin(), work.end(), first);
+        }
+    }
+
+    // Parallel merge sort: leaves of at least min_leaf elements go through ft::sort (so arithmetic keys
+    // are radix sorted), then the runs are merged pairwise with a parallel merge. Not stable.
+    template <class RandomIterator, class Compare>
+    void parallel_sort(RandomIterator first, RandomIterator last, Compare comp, ft::thread_pool &pool) {
+        if (last - first > 1)
+            parallel_sort_detail::sort(pool, first, last, comp,
+                                       std::integral_constant<bool, ft::contiguous_iterator<RandomIterator>::value>());
+    }
+
+    template <class RandomIterator, class Compare>
+    void parallel_sort(RandomIterator first, RandomIterator last, Compare comp) {
+        ft::parallel_sort(first, last, comp, ft::default_thread_pool());
+    }
+
+    template <class RandomIterator>
+    void parallel_sort(RandomIterator first, RandomIterator last) {
+        ft::parallel_sort(first, last, ft::less<typename ft::iterator_traits<RandomIterator>::value_type>());
+    }
+}
@@ -0,0 +1,337 @@
+#pragma once
+
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <new>
+#include <cstddef>
+#include <cstdlib>
+#include "work_stealing_deque.hpp"
+#include "../deque/deque.hpp"
+#include "../vector/vector.hpp"
+
+namespace ft{
+    // Unit of work for thread_pool; done flips once execute has returned or thrown.
+    struct pool_task{
+        std::atomic<bool> done;
+        std::exception_ptr error;
+
+        pool_task() : done(false) {}
+
+        virtual ~pool_task() {}
+
+        virtual void execute() = 0;
+
+        void run() {
+            try {
+                execute();
+            }
+            catch (...) {
+                error = std::current_exception();
+            }
+            done.store(true, std::memory_order_release);
+        }
+    };
+
+    // Refers to a callable on the forking frame, which always outlives the join.
+    template <class Function>
+    struct function_task : pool_task{
+        Function &function;
+
+        explicit function_task(Function &f) : function(f) {}
+
+        void execute() {
+            function();
+        }
+    };
+
+    // Fork/join pool: each worker owns a Chase-Lev deque, pushes forks to its bottom and steals from
+    // the top of the others when idle. Calls from outside the pool are queued and waited on.
+    class thread_pool
+    {
+        public:
+            typedef size_t size_type;
+
+            static const unsigned idle_spin = 64;
+
+            explicit thread_pool(size_type threads = default_threads()) : sleepers_(0), epoch_(0), injected_count_(0), stop_(false) {
+                if (!threads)
+                    threads = 1;
+                for (size_type i = 0; i < threads; ++i)
+                    workers_.push_back(make_worker(i));
+                for (size_type i = 0; i < threads; ++i)
+                    workers_[i]->thread = std::thread(&thread_pool::work, this, i);
+            }
+
+            ~thread_pool() {
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    stop_ = true;
+                    ++epoch_;
+                }
+                wake_.notify_all();
+                for (size_type i = 0; i < workers_.size(); ++i)
+                    workers_[i]->thread.join();
+                for (size_type i = 0; i < workers_.size(); ++i)
+                    destroy_worker(workers_[i]);
+            }
+
+            static size_type default_threads() {
+                return std::thread::hardware_concurrency() ? std::thread::hardware_concurrency() : 1;
+            }
+
+            size_type size() const {
+                return workers_.size();
+            }
+
+            // Runs f and g, possibly in parallel, and returns once both are done. The first exception wins.
+            template <class F, class G>
+            void invoke(F f, G g) {
+                worker *self = current();
+
+                if (!self) {
+                    struct both{
+                        thread_pool *pool;
+                        F &f;
+                        G &g;
+                        void operator()() { pool->invoke(f, g); }
+                    } call = {this, f, g};
+                    run_outside(call);
+                    return;
+                }
+                function_task<G> child(g);
+                std::exception_ptr error;
+                pool_task *taken;
+
+                self->tasks.push(&child);
+                notify();
+                try {
+                    f();
+                }
+                catch (...) {
+                    error = std::current_exception();
+                }
+                if (self->tasks.take(taken))
+                    child.run();
+                else
+                    join(self, child);
+                if (error)
+                    std::rethrow_exception(error);
+                if (child.error)
+                    std::rethrow_exception(child.error);
+            }
+
+            // Calls f(begin, end) on disjoint chunks of [first, last) of at most grain indices.
+            template <class F>
+            void parallel_for(size_type first, size_type last, F f, size_type grain = 0) {
+                if (first >= last)
+                    return;
+                if (!grain)
+                    grain = (last - first) / (size() * 8) + 1;
+                split_for(first, last, f, grain);
+            }
+
+        private:
+            thread_pool(const thread_pool &);
+            thread_pool &operator=(const thread_pool &);
+
+            struct worker{
+                ft::work_stealing_deque<pool_task *> tasks;
+                std::thread thread;
+                size_type index;
+                unsigned seed;
+
+                explicit worker(size_type i) : index(i), seed(static_cast<unsigned>(i) * 0x9e3779b9u + 1) {}
+            };
+
+            // The deque's indices sit on their own cache lines, which plain new does not honour
+            // before C++17, so workers get storage aligned by hand.
+            static worker *make_worker(size_type i) {
+                void *storage;
+
+                if (posix_memalign(&storage, alignof(worker), sizeof(worker)))
+                    throw std::bad_alloc();
+                try {
+                    return new (storage) worker(i);
+                }
+                catch (...) {
+                    free(storage);
+                    throw;
+                }
+            }
+
+            static void destroy_worker(worker *w) {
+                w->~worker();
+                free(w);
+            }
+
+            ft::vector<worker *> workers_;
+            std::atomic<unsigned> sleepers_;
+            std::atomic<unsigned> epoch_;
+            std::atomic<size_type> injected_count_;
+            ft::deque<pool_task *> injected_;
+            std::atomic<bool> stop_;
+            std::mutex mutex_;
+            std::condition_variable wake_;
+            std::condition_variable finished_;
+
+            static worker *&current_worker() {
+                static thread_local worker *self = 0;
+                return self;
+            }
+
+            static thread_pool *&current_pool() {
+                static thread_local thread_pool *pool = 0;
+                return pool;
+            }
+
+            worker *current() const {
+                return current_pool() == this ? current_worker() : 0;
+            }
+
+            template <class F>
+            void split_for(size_type first, size_type last, F &f, size_type grain) {
+                if (last - first <= grain) {
+                    f(first, last);
+                    return;
+                }
+                size_type middle = first + (last - first) / 2;
+                invoke([&]() { split_for(first, middle, f, grain); },
+                       [&]() { split_for(middle, last, f, grain); });
+            }
+
+            template <class F>
+            void run_outside(F &f) {
+                function_task<F> task(f);
+
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    injected_.push_back(&task);
+                    injected_count_.fetch_add(1, std::memory_order_relaxed);
+                    ++epoch_;
+                }
+                wake_.notify_one();
+                std::unique_lock<std::mutex> lock(mutex_);
+                while (!task.done.load(std::memory_order_acquire))
+                    finished_.wait(lock);
+                lock.unlock();
+                if (task.error)
+                    std::rethrow_exception(task.error);
+            }
+
+            // Wakes sleepers only when there are any; the fence pairs with the one in work() so that
+            // either the pusher sees the sleeper or the sleeper's rescan sees the task.
+            void notify() {
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (sleepers_.load(std::memory_order_relaxed)) {
+                    {
+                        std::lock_guard<std::mutex> lock(mutex_);
+                        ++epoch_;
+                    }
+                    wake_.notify_all();
+                }
+            }
+
+            bool steal(worker *self, pool_task *&out) {
+                size_type n = workers_.size();
+
+                self->seed ^= self->seed << 13;
+                self->seed ^= self->seed >> 17;
+                self->seed ^= self->seed << 5;
+                for (size_type i = 0, start = self->seed % n; i < n; ++i) {
+                    worker *victim = workers_[(start + i) % n];
+                    if (victim != self && victim->tasks.steal(out))
+                        return true;
+                }
+                return false;
+            }
+
+            bool take_injected(pool_task *&out) {
+                if (!injected_count_.load(std::memory_order_relaxed))
+                    return false;
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (injected_.empty())
+                    return false;
+                out = injected_.front();
+                injected_.pop_front();
+                injected_count_.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+
+            bool find(worker *self, pool_task *&out, bool &injected) {
+                injected = false;
+                if (self->tasks.take(out) || steal(self, out))
+                    return true;
+                return (injected = take_injected(out));
+            }
+
+            void run(pool_task *task, bool injected) {
+                task->run();
+                if (injected) {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    finished_.notify_all();
+                }
+            }
+
+            // A stolen child leaves the joiner's own deque empty, so it only steals while it waits.
+            void join(worker *self, pool_task &child) {
+                pool_task *task;
+
+                while (!child.done.load(std::memory_order_acquire)) {
+                    if (steal(self, task))
+                        task->run();
+                    else
+                        std::this_thread::yield();
+                }
+            }
+
+            void work(size_type index) {
+                worker *self = workers_[index];
+                pool_task *task;
+                bool injected;
+
+                current_pool() = this;
+                current_worker() = self;
+                for (;;) {
+                    bool found = false;
+                    for (unsigned i = 0; i < idle_spin && !found; ++i) {
+                        if (!(found = find(self, task, injected)))
+                            std::this_thread::yield();
+                    }
+                    if (!found) {
+                        unsigned epoch = epoch_.load(std::memory_order_seq_cst);
+                        sleepers_.fetch_add(1, std::memory_order_seq_cst);
+                        std::atomic_thread_fence(std::memory_order_seq_cst);
+                        found = find(self, task, injected);
+                        if (!found) {
+                            std::unique_lock<std::mutex> lock(mutex_);
+                            while (epoch_.load(std::memory_order_relaxed) == epoch && !stop_)
+                                wake_.wait(lock);
+                        }
+                        sleepers_.fetch_sub(1, std::memory_order_relaxed);
+                    }
+                    if (found)
+                        run(task, injected);
+                    else if (stop_)
+                        return;
+                }
+            }
+    };
+
+    inline thread_pool &default_thread_pool() {
+        static thread_pool pool;
+        return pool;
+    }
+
+    template <class F, class G>
+    void parallel_invoke(F f, G g) {
+        ft::default_thread_pool().invoke(f, g);
+    }
+
+    template <class F>
+    void parallel_for(size_t first, size_t last, F f, size_t grain = 0) {
+        ft::default_thread_pool().parallel_for(first, last, f, grain);
+    }
+}
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include "../vector/vector.hpp"
+#include "../utils/cache_line.hpp"
+
+namespace ft{
+    // Chase-Lev deque: the owner pushes and takes at the bottom, thieves steal from the top.
+    // T is expected to be a small trivially copyable handle such as a task pointer.
+    template <class T>
+    class work_stealing_deque
+    {
+        private:
+            struct slot{
+                std::atomic<T> value;
+
+                slot() : value(T()) {}
+
+                slot(const slot &x) : value(x.value.load(std::memory_order_relaxed)) {}
+
+                slot &operator=(const slot &x) {
+                    value.store(x.value.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                    return *this;
+                }
+            };
+
+            struct ring{
+                ft::vector<slot> slots;
+                ptrdiff_t mask;
+
+                explicit ring(ptrdiff_t size) : slots(size), mask(size - 1) {}
+
+                T get(ptrdiff_t i) const {
+                    return slots[i & mask].value.load(std::memory_order_relaxed);
+                }
+
+                void put(ptrdiff_t i, T val) {
+                    slots[i & mask].value.store(val, std::memory_order_relaxed);
+                }
+            };
+
+        public:
+            typedef T value_type;
+            typedef size_t size_type;
+
+            explicit work_stealing_deque(size_type capacity = 64) : top_(0), bottom_(0) {
+                ptrdiff_t size = 2;
+
+                while (size_type(size) < capacity)
+                    size <<= 1;
+                rings_.push_back(new ring(size));
+                ring_.store(rings_.back(), std::memory_order_relaxed);
+            }
+
+            ~work_stealing_deque() {
+                for (size_type i = 0; i < rings_.size(); ++i)
+                    delete rings_[i];
+            }
+
+            // Approximate unless called by the owner with no thieves around.
+            bool empty() const {
+                ptrdiff_t bottom = bottom_.load(std::memory_order_relaxed);
+
+                return bottom <= top_.load(std::memory_order_relaxed);
+            }
+
+            // Owner only.
+            void push(T val) {
+                ptrdiff_t bottom = bottom_.load(std::memory_order_relaxed);
+                ptrdiff_t top = top_.load(std::memory_order_acquire);
+                ring *current = ring_.load(std::memory_order_relaxed);
+
+                if (bottom - top > current->mask)
+                    current = grow(current, top, bottom);
+                current->put(bottom, val);
+                bottom_.store(bottom + 1, std::memory_order_release);
+            }
+
+            // Owner only; pops the most recently pushed value.
+            bool take(T &out) {
+                ptrdiff_t bottom = bottom_.load(std::memory_order_relaxed) - 1;
+                ring *current = ring_.load(std::memory_order_relaxed);
+
+                bottom_.store(bottom, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                ptrdiff_t top = top_.load(std::memory_order_relaxed);
+                if (top > bottom) {
+                    bottom_.store(bottom + 1, std::memory_order_relaxed);
+                    return false;
+                }
+                out = current->get(bottom);
+                if (top == bottom) {
+                    bool won = top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+                    bottom_.store(bottom + 1, std::memory_order_relaxed);
+                    return won;
+                }
+                return true;
+            }
+
+            // Any thread; fails when the deque is empty or another thief won the race.
+            bool steal(T &out) {
+                ptrdiff_t top = top_.load(std::memory_order_acquire);
+
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                ptrdiff_t bottom = bottom_.load(std::memory_order_acquire);
+                if (top >= bottom)
+                    return false;
+                out = ring_.load(std::memory_order_acquire)->get(top);
+                return top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+            }
+
+        private:
+            work_stealing_deque(const work_stealing_deque &);
+            work_stealing_deque &operator=(const work_stealing_deque &);
+
+            alignas(ft::cache_line_size) std::atomic<ptrdiff_t> top_;
+            alignas(ft::cache_line_size) std::atomic<ptrdiff_t> bottom_;
+            std::atomic<ring *> ring_;
+            // Outgrown rings stay alive until destruction because a thief may still be reading one.
+            ft::vector<ring *> rings_;
+
+            ring *grow(ring *current, ptrdiff_t top, ptrdiff_t bottom) {
+                ring *bigger = new ring((current->mask + 1) * 2);
+
+                for (ptrdiff_t i = top; i < bottom; ++i)
+                    bigger->put(i, current->get(i));
+                rings_.push_back(bigger);
+                ring_.store(bigger, std::memory_order_release);
+                return bigger;
+            }
+    };
+}
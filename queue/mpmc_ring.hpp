@@ -0,0 +1,272 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <new>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include "../utils/cache_line.hpp"
+
+namespace ft{
+    struct mpmc_tag{};
+    struct spsc_tag{};
+
+    // Bounded queue over a power-of-two ring. Every cell carries a sequence number: pos means free for
+    // the producer that claims pos, pos + 1 means full for the consumer that claims pos (Vyukov).
+    template <class T, class Mode = ft::mpmc_tag, class Alloc = std::allocator<T> >
+    class mpmc_ring
+    {
+        private:
+            struct cell{
+                std::atomic<size_t> sequence;
+                typename std::aligned_storage<sizeof(T), alignof(T)>::type value;
+            };
+
+        public:
+            typedef T value_type;
+            typedef size_t size_type;
+            typedef typename Alloc::template rebind<cell>::other cell_allocator_type;
+
+            explicit mpmc_ring(size_type capacity) : mask_(round_capacity(capacity) - 1) {
+                cells_ = allocator_.allocate(mask_ + 1);
+                for (size_type i = 0; i <= mask_; ++i) {
+                    new (cells_ + i) cell;
+                    cells_[i].sequence.store(i, std::memory_order_relaxed);
+                }
+                tail_.store(0, std::memory_order_relaxed);
+                head_.store(0, std::memory_order_relaxed);
+            }
+
+            ~mpmc_ring() {
+                size_type tail = tail_.load(std::memory_order_relaxed);
+
+                for (size_type pos = head_.load(std::memory_order_relaxed); pos != tail; ++pos)
+                    value_at(pos)->~T();
+                for (size_type i = 0; i <= mask_; ++i)
+                    cells_[i].~cell();
+                allocator_.deallocate(cells_, mask_ + 1);
+            }
+
+            size_type capacity() const {
+                return mask_ + 1;
+            }
+
+            // Approximate while other threads are running.
+            size_type size() const {
+                size_type head = head_.load(std::memory_order_relaxed);
+                size_type tail = tail_.load(std::memory_order_relaxed);
+
+                return tail > head ? tail - head : 0;
+            }
+
+            bool empty() const {
+                return !size();
+            }
+
+            bool try_push(const value_type &val) {
+                size_type pos = claim(tail_, 1, 0);
+
+                if (!pos--)
+                    return false;
+                publish(pos, val);
+                return true;
+            }
+
+            bool try_pop(value_type &out) {
+                size_type pos = claim(head_, 1, 1);
+
+                if (!pos--)
+                    return false;
+                consume(pos, out);
+                return true;
+            }
+
+            // Claims up to n consecutive free cells with one compare-exchange; returns how many were pushed.
+            template <class InputIterator>
+            size_type try_push_n(InputIterator first, size_type n) {
+                size_type pos = tail_.load(std::memory_order_relaxed);
+                size_type count = claim_run(tail_, pos, n, 0);
+
+                for (size_type i = 0; i < count; ++i, ++first)
+                    publish(pos + i, *first);
+                return count;
+            }
+
+            template <class OutputIterator>
+            size_type try_pop_n(OutputIterator out, size_type n) {
+                size_type pos = head_.load(std::memory_order_relaxed);
+                size_type count = claim_run(head_, pos, n, 1);
+
+                for (size_type i = 0; i < count; ++i, ++out)
+                    consume(pos + i, *out);
+                return count;
+            }
+
+        private:
+            mpmc_ring(const mpmc_ring &);
+            mpmc_ring &operator=(const mpmc_ring &);
+
+            cell_allocator_type allocator_;
+            cell *cells_;
+            size_type mask_;
+            alignas(ft::cache_line_size) std::atomic<size_t> tail_;
+            alignas(ft::cache_line_size) std::atomic<size_t> head_;
+
+            static size_type round_capacity(size_type n) {
+                size_type res = 2;
+
+                if (n > (~size_type(0) >> 1) + 1)
+                    throw std::length_error("mpmc_ring capacity");
+                while (res < n)
+                    res <<= 1;
+                return res;
+            }
+
+            value_type *value_at(size_type pos) const {
+                return reinterpret_cast<value_type *>(&cells_[pos & mask_].value);
+            }
+
+            // Signed distance between a cell's sequence and the one this side waits for.
+            static ptrdiff_t lag(size_type sequence, size_type pos, size_type ready) {
+                return static_cast<ptrdiff_t>(sequence - (pos + ready));
+            }
+
+            // Returns the claimed position plus one, or 0 when the ring is full (or empty for consumers).
+            size_type claim(std::atomic<size_t> &end, size_type n, size_type ready) {
+                size_type pos = end.load(std::memory_order_relaxed);
+
+                return claim_run(end, pos, n, ready) ? pos + 1 : 0;
+            }
+
+            // Cells past the claim point can only change after another thread moves `end`, which makes the
+            // compare-exchange fail, so the run counted here is still ready once it succeeds.
+            size_type claim_run(std::atomic<size_t> &end, size_type &pos, size_type n, size_type ready) {
+                for (;;) {
+                    size_type count = 0;
+                    while (count < n && count <= mask_
+                           && !lag(cells_[(pos + count) & mask_].sequence.load(std::memory_order_acquire), pos + count, ready))
+                        ++count;
+                    if (count) {
+                        if (end.compare_exchange_weak(pos, pos + count, std::memory_order_relaxed))
+                            return count;
+                        continue;
+                    }
+                    if (!n || lag(cells_[pos & mask_].sequence.load(std::memory_order_acquire), pos, ready) < 0)
+                        return 0;
+                    pos = end.load(std::memory_order_relaxed);
+                }
+            }
+
+            void publish(size_type pos, const value_type &val) {
+                new (value_at(pos)) T(val);
+                cells_[pos & mask_].sequence.store(pos + 1, std::memory_order_release);
+            }
+
+            void consume(size_type pos, value_type &out) {
+                value_type *value = value_at(pos);
+
+                out = *value;
+                value->~T();
+                cells_[pos & mask_].sequence.store(pos + mask_ + 1, std::memory_order_release);
+            }
+    };
+
+    // One producer, one consumer: each index is written by a single thread, so plain loads and stores
+    // replace the compare-exchange and the per-cell sequence numbers.
+    template <class T, class Alloc>
+    class mpmc_ring<T, ft::spsc_tag, Alloc>
+    {
+        public:
+            typedef T value_type;
+            typedef size_t size_type;
+            typedef Alloc allocator_type;
+
+            explicit mpmc_ring(size_type capacity)
+                : mask_(round_capacity(capacity) - 1), tail_(0), head_cache_(0), head_(0), tail_cache_(0) {
+                data_ = allocator_.allocate(mask_ + 1);
+            }
+
+            ~mpmc_ring() {
+                size_type tail = tail_.load(std::memory_order_relaxed);
+
+                for (size_type pos = head_.load(std::memory_order_relaxed); pos != tail; ++pos)
+                    allocator_.destroy(data_ + (pos & mask_));
+                allocator_.deallocate(data_, mask_ + 1);
+            }
+
+            size_type capacity() const {
+                return mask_ + 1;
+            }
+
+            size_type size() const {
+                size_type head = head_.load(std::memory_order_acquire);
+
+                return tail_.load(std::memory_order_acquire) - head;
+            }
+
+            bool empty() const {
+                return !size();
+            }
+
+            bool try_push(const value_type &val) {
+                return try_push_n(&val, 1) == 1;
+            }
+
+            bool try_pop(value_type &out) {
+                return try_pop_n(&out, 1) == 1;
+            }
+
+            template <class InputIterator>
+            size_type try_push_n(InputIterator first, size_type n) {
+                size_type tail = tail_.load(std::memory_order_relaxed);
+
+                if (tail - head_cache_ + n > mask_ + 1)
+                    head_cache_ = head_.load(std::memory_order_acquire);
+                if (n > mask_ + 1 - (tail - head_cache_))
+                    n = mask_ + 1 - (tail - head_cache_);
+                for (size_type i = 0; i < n; ++i, ++first)
+                    allocator_.construct(data_ + ((tail + i) & mask_), *first);
+                tail_.store(tail + n, std::memory_order_release);
+                return n;
+            }
+
+            template <class OutputIterator>
+            size_type try_pop_n(OutputIterator out, size_type n) {
+                size_type head = head_.load(std::memory_order_relaxed);
+
+                if (tail_cache_ - head < n)
+                    tail_cache_ = tail_.load(std::memory_order_acquire);
+                if (n > tail_cache_ - head)
+                    n = tail_cache_ - head;
+                for (size_type i = 0; i < n; ++i, ++out) {
+                    *out = data_[(head + i) & mask_];
+                    allocator_.destroy(data_ + ((head + i) & mask_));
+                }
+                head_.store(head + n, std::memory_order_release);
+                return n;
+            }
+
+        private:
+            mpmc_ring(const mpmc_ring &);
+            mpmc_ring &operator=(const mpmc_ring &);
+
+            allocator_type allocator_;
+            T *data_;
+            size_type mask_;
+            alignas(ft::cache_line_size) std::atomic<size_t> tail_;
+            size_type head_cache_;
+            alignas(ft::cache_line_size) std::atomic<size_t> head_;
+            size_type tail_cache_;
+
+            static size_type round_capacity(size_type n) {
+                size_type res = 2;
+
+                if (n > (~size_type(0) >> 1) + 1)
+                    throw std::length_error("mpmc_ring capacity");
+                while (res < n)
+                    res <<= 1;
+                return res;
+            }
+    };
+}
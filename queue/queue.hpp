@@ -0,0 +1,105 @@
+#pragma once
+
+#include "../utils/iterator_traits.hpp"
+#include "../utils/enable_if.hpp"
+#include "../utils/is_integral.hpp"
+#include "../utils/utils.hpp"
+#include "../deque/deque.hpp"
+namespace ft{
+    template <class T, class Container = ft::deque<T> >
+    class queue
+    {
+        public:
+            typedef T value_type;
+            typedef Container container_type;
+            typedef size_t size_type;
+
+            explicit queue(const container_type &cnr = container_type()) {
+                c = cnr;
+            }
+
+            bool empty() const {
+                return c.empty();
+            }
+
+            size_type size() const {
+                return c.size();
+            }
+
+            value_type &front() {
+                return c.front();
+            }
+
+            const value_type &front() const {
+                return c.front();
+            }
+
+            value_type &back() {
+                return c.back();
+            }
+
+            const value_type &back() const {
+                return c.back();
+            }
+
+            void push(const value_type &val) {
+                c.push_back(val);
+            }
+
+            void pop() {
+                c.pop_front();
+            }
+
+            template <class FT, class fContainer>
+            friend bool operator==(const ft::queue <FT, fContainer>&lhs, const ft::queue<FT, fContainer>&rhs);
+
+            template <class FT, class fContainer>
+            friend bool operator!=(const ft::queue <FT, fContainer>&lhs, const ft::queue<FT, fContainer>&rhs);
+
+            template <class FT, class fContainer>
+            friend bool operator<(const ft::queue <FT, fContainer>&lhs, const ft::queue<FT, fContainer>&rhs);
+
+            template <class FT, class fContainer>
+            friend bool operator<=(const ft::queue <FT, fContainer>&lhs, const ft::queue<FT, fContainer>&rhs);
+
+            template <class FT, class fContainer>
+            friend bool operator>(const ft::queue <FT, fContainer>&lhs, const ft::queue<FT, fContainer>&rhs);
+
+            template <class FT, class fContainer>
+            friend bool operator>=(const ft::queue <FT, fContainer>&lhs, const ft::queue<FT, fContainer>&rhs);
+
+        protected:
+            container_type c;
+    };
+
+    template <class T, class Container>
+    bool operator==(const ft::queue<T, Container>&lhs, const ft::queue<T, Container> &rhs) {
+        return lhs.c == rhs.c;
+    }
+
+    template <class T, class Container>
+    bool operator!=(const ft::queue<T, Container>&lhs, const ft::queue<T, Container> &rhs) {
+        return lhs.c != rhs.c;
+    }
+
+    template <class T, class Container>
+    bool operator<(const ft::queue<T, Container>&lhs, const ft::queue<T, Container> &rhs) {
+        return lhs.c < rhs.c;
+    }
+
+    template <class T, class Container>
+    bool operator>(const ft::queue<T, Container>&lhs, const ft::queue<T, Container> &rhs) {
+        return lhs.c > rhs.c;
+    }
+
+    template <class T, class Container>
+    bool operator<=(const ft::queue<T, Container>&lhs, const ft::queue<T, Container> &rhs) {
+        return lhs.c <= rhs.c;
+    }
+
+    template <class T, class Container>
+    bool operator>=(const ft::queue<T, Container>&lhs, const ft::queue<T, Container> &rhs) {
+        return lhs.c >= rhs.c;
+    }
+
+}
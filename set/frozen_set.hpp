@@ -0,0 +1,194 @@
+#pragma once
+
+#include <memory>
+#include "../utils/less.hpp"
+#include "../utils/pair.hpp"
+#include "../utils/utils.hpp"
+#include "../utils/iterator_traits.hpp"
+#include "../map/eytzinger.hpp"
+
+namespace ft{
+    template<class Key, class Compare = ft::less<Key>, class Alloc = std::allocator<Key> >
+    class frozen_set{
+    public:
+        typedef Key 											key_type;
+        typedef key_type 										value_type;
+        typedef Compare 										key_compare;
+        typedef key_compare 									value_compare;
+        typedef Alloc 											allocator_type;
+        typedef typename allocator_type::const_reference		const_reference;
+        typedef typename allocator_type::const_pointer			const_pointer;
+        typedef size_t 											size_type;
+        typedef ptrdiff_t 										difference_type;
+
+        class const_iterator{
+        public:
+            typedef std::bidirectional_iterator_tag	iterator_category;
+            typedef Key 							value_type;
+            typedef ptrdiff_t 						difference_type;
+            typedef const Key 						*pointer;
+            typedef const Key 						&reference;
+
+            const_iterator() : set_(0), index_(0){}
+
+            const_iterator(const frozen_set *set, size_type index) : set_(set), index_(index){}
+
+            reference operator*() const{
+                return set_->keys_[index_];}
+
+            pointer operator->() const{
+                return set_->keys_ + index_;}
+
+            const_iterator &operator++(){
+                index_ = eytzinger::next(index_, set_->size_);
+                return *this;
+            }
+
+            const_iterator operator++(int){
+                const_iterator temp = *this;
+                ++(*this);
+                return temp;
+            }
+
+            const_iterator &operator--(){
+                index_ = eytzinger::prev(index_, set_->size_);
+                return *this;
+            }
+
+            const_iterator operator--(int){
+                const_iterator temp = *this;
+                --(*this);
+                return temp;
+            }
+
+            bool operator==(const const_iterator &it) const{
+                return index_ == it.index_;}
+
+            bool operator!=(const const_iterator &it) const{
+                return index_ != it.index_;}
+
+        private:
+            const frozen_set 	*set_;
+            size_type 			index_;
+        };
+
+        typedef const_iterator iterator;
+
+        explicit frozen_set(const key_compare &comp = key_compare(), const allocator_type &allocator = allocator_type())
+            : allocator_(allocator), key_compare_(comp), keys_(0), size_(0){}
+
+        // [first, last) must be sorted by comp and free of duplicates, as an ft::set range is.
+        template<class ForwardIterator>
+        frozen_set(ForwardIterator first, ForwardIterator last, const key_compare &comp = key_compare(), const allocator_type &allocator = allocator_type())
+            : allocator_(allocator), key_compare_(comp), keys_(0), size_(0){
+            assign(first, last, ft::distance(first, last));
+        }
+
+        frozen_set(const frozen_set &src) : allocator_(src.allocator_), key_compare_(src.key_compare_), keys_(0), size_(0){
+            assign(src.begin(), src.end(), src.size_);
+        }
+
+        ~frozen_set(){
+            clear();}
+
+        frozen_set &operator=(const frozen_set &src){
+            if (this != &src){
+                frozen_set copy(src);
+                swap(copy);
+            }
+            return *this;
+        }
+
+        const_iterator begin() const{
+            return const_iterator(this, eytzinger::first(size_));}
+
+        const_iterator end() const{
+            return const_iterator(this, 0);}
+
+        bool empty() const{
+            return size_ == 0;}
+
+        size_type size() const{
+            return size_;}
+
+        const_iterator find(const key_type &k) const{
+            size_type index = eytzinger::lower_bound(keys_, size_, k, key_compare_);
+
+            if (index && key_compare_(k, keys_[index]))
+                index = 0;
+            return const_iterator(this, index);
+        }
+
+        size_type count(const key_type &k) const{
+            return find(k) != end();}
+
+        const_iterator lower_bound(const key_type &k) const{
+            return const_iterator(this, eytzinger::lower_bound(keys_, size_, k, key_compare_));}
+
+        const_iterator upper_bound(const key_type &k) const{
+            return const_iterator(this, eytzinger::upper_bound(keys_, size_, k, key_compare_));}
+
+        ft::pair<const_iterator, const_iterator> equal_range(const key_type &k) const{
+            return ft::make_pair(lower_bound(k), upper_bound(k));}
+
+        key_compare key_comp() const{
+            return key_compare_;}
+
+        value_compare value_comp() const{
+            return key_compare_;}
+
+        void swap(frozen_set &x){
+            ft::swap(x.key_compare_, key_compare_);
+            ft::swap(x.keys_, keys_);
+            ft::swap(x.size_, size_);
+        }
+
+        void clear(){
+            if (!keys_)
+                return;
+            for (size_type i = 1; i <= size_; ++i)
+                allocator_.destroy(keys_ + i);
+            allocator_.deallocate(keys_, size_ + 1);
+            keys_ = 0;
+            size_ = 0;
+        }
+
+        allocator_type get_allocator() const{
+            return allocator_;}
+
+    private:
+        allocator_type 	allocator_;
+        key_compare 	key_compare_;
+        Key 			*keys_;
+        size_type 		size_;
+
+        // Fills a fresh array and only then takes it, so an empty set stays empty if a copy throws:
+        // the slots filled so far, visited in the same order, are destroyed and the array freed.
+        template<class ForwardIterator>
+        void assign(ForwardIterator first, ForwardIterator last, size_type n){
+            if (!n)
+                return;
+            Key *keys = allocator_.allocate(n + 1);
+            size_type done = 0;
+
+            try{
+                for (size_type i = eytzinger::first(n); first != last; ++first, i = eytzinger::next(i, n)){
+                    allocator_.construct(keys + i, *first);
+                    ++done;
+                }
+            }
+            catch (...){
+                for (size_type i = eytzinger::first(n); done; --done, i = eytzinger::next(i, n))
+                    allocator_.destroy(keys + i);
+                allocator_.deallocate(keys, n + 1);
+                throw;
+            }
+            keys_ = keys;
+            size_ = n;
+        }
+    };
+
+    template<class Key, class Compare, class Allocator>
+    void swap(frozen_set<Key, Compare, Allocator> &x, frozen_set<Key, Compare, Allocator> &y){
+        x.swap(y);}
+}
@@ -0,0 +1,921 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include "../utils/bits.hpp"
+#include "../utils/less.hpp"
+#include "../utils/pair.hpp"
+#include "../utils/utils.hpp"
+#include "../utils/iterator_traits.hpp"
+#include "../vector/vector.hpp"
+
+namespace ft
+{
+    namespace roaring_detail
+    {
+        typedef unsigned long long word;
+
+        static const unsigned bitmap_words = 1024;
+        // An array of more than array_max values is bigger than the 8 KiB bitmap.
+        static const unsigned array_max = 4096;
+        // Same for runs, at four bytes each.
+        static const unsigned runs_max = 2048;
+        // Returned by next and prev when there is no such value.
+        static const unsigned none = 65536;
+
+        enum kind{
+            array_kind,
+            bitmap_kind,
+            run_kind
+        };
+
+        // Shifting by hand keeps the element moves to plain assignments.
+        template <class T>
+        void insert_at(ft::vector<T> &v, size_t i, const T &val) {
+            v.push_back(val);
+            for (size_t j = v.size() - 1; j > i; --j)
+                v[j] = v[j - 1];
+            v[i] = val;
+        }
+
+        template <class T>
+        void erase_at(ft::vector<T> &v, size_t i) {
+            for (; i + 1 < v.size(); ++i)
+                v[i] = v[i + 1];
+            v.pop_back();
+        }
+
+        // Inclusive range of low halves.
+        struct run{
+            unsigned short start;
+            unsigned short last;
+        };
+
+        // The low 16 bits of the values in one bucket, as a sorted array, a 2^16-bit bitmap or a
+        // sorted list of runs, whichever the contents need least memory for. Inserts and erases
+        // move between array and bitmap at array_max; runs are chosen by run_optimize.
+        struct container{
+            kind type;
+            unsigned card;
+            ft::vector<unsigned short> values;
+            ft::vector<word> words;
+            ft::vector<run> runs;
+
+            container() : type(array_kind), card(0) {}
+
+            size_t value_index(unsigned v) const {
+                size_t lo = 0;
+                size_t hi = values.size();
+
+                while (lo < hi) {
+                    size_t mid = lo + (hi - lo) / 2;
+                    if (values[mid] < v)
+                        lo = mid + 1;
+                    else
+                        hi = mid;
+                }
+                return lo;
+            }
+
+            // First run ending at or after v.
+            size_t run_index(unsigned v) const {
+                size_t lo = 0;
+                size_t hi = runs.size();
+
+                while (lo < hi) {
+                    size_t mid = lo + (hi - lo) / 2;
+                    if (runs[mid].last < v)
+                        lo = mid + 1;
+                    else
+                        hi = mid;
+                }
+                return lo;
+            }
+
+            bool contains(unsigned v) const {
+                if (type == bitmap_kind)
+                    return (words[v >> 6] >> (v & 63)) & 1;
+                if (type == array_kind) {
+                    size_t i = value_index(v);
+                    return i < values.size() && values[i] == v;
+                }
+                size_t i = run_index(v);
+                return i < runs.size() && runs[i].start <= v;
+            }
+
+            bool insert(unsigned v) {
+                if (type == bitmap_kind) {
+                    word bit = word(1) << (v & 63);
+                    if (words[v >> 6] & bit)
+                        return false;
+                    words[v >> 6] |= bit;
+                }
+                else if (type == array_kind) {
+                    size_t i = value_index(v);
+                    if (i < values.size() && values[i] == v)
+                        return false;
+                    if (card == array_max) {
+                        to_bitmap();
+                        return insert(v);
+                    }
+                    insert_at(values, i, static_cast<unsigned short>(v));
+                }
+                else {
+                    size_t i = run_index(v);
+                    if (i < runs.size() && runs[i].start <= v)
+                        return false;
+                    bool left = i > 0 && runs[i - 1].last + 1u == v;
+                    bool right = i < runs.size() && runs[i].start == v + 1;
+                    if (left && right) {
+                        runs[i - 1].last = runs[i].last;
+                        erase_at(runs, i);
+                    }
+                    else if (left)
+                        runs[i - 1].last = static_cast<unsigned short>(v);
+                    else if (right)
+                        runs[i].start = static_cast<unsigned short>(v);
+                    else {
+                        run r = {static_cast<unsigned short>(v), static_cast<unsigned short>(v)};
+                        insert_at(runs, i, r);
+                    }
+                }
+                ++card;
+                if (type == run_kind && runs.size() > runs_max)
+                    normalize();
+                return true;
+            }
+
+            bool erase(unsigned v) {
+                if (type == bitmap_kind) {
+                    word bit = word(1) << (v & 63);
+                    if (!(words[v >> 6] & bit))
+                        return false;
+                    words[v >> 6] &= ~bit;
+                    if (--card <= array_max)
+                        to_array();
+                    return true;
+                }
+                if (type == array_kind) {
+                    size_t i = value_index(v);
+                    if (i == values.size() || values[i] != v)
+                        return false;
+                    erase_at(values, i);
+                    --card;
+                    return true;
+                }
+                size_t i = run_index(v);
+                if (i == runs.size() || runs[i].start > v)
+                    return false;
+                run r = runs[i];
+                if (r.start == r.last)
+                    erase_at(runs, i);
+                else if (r.start == v)
+                    ++runs[i].start;
+                else if (r.last == v)
+                    --runs[i].last;
+                else {
+                    runs[i].last = static_cast<unsigned short>(v - 1);
+                    run tail = {static_cast<unsigned short>(v + 1), r.last};
+                    insert_at(runs, i + 1, tail);
+                }
+                --card;
+                if (runs.size() > runs_max)
+                    normalize();
+                return true;
+            }
+
+            // Smallest value not below v (v < 2^16), or none.
+            unsigned next(unsigned v) const {
+                if (type == bitmap_kind) {
+                    unsigned w = v >> 6;
+                    word bits = words[w] & (~word(0) << (v & 63));
+                    while (!bits) {
+                        if (++w == bitmap_words)
+                            return none;
+                        bits = words[w];
+                    }
+                    return w * 64 + ft::count_trailing_zeros(bits);
+                }
+                if (type == array_kind) {
+                    size_t i = value_index(v);
+                    return i < values.size() ? values[i] : none;
+                }
+                size_t i = run_index(v);
+                if (i == runs.size())
+                    return none;
+                return runs[i].start > v ? runs[i].start : v;
+            }
+
+            // Largest value not above v, or none.
+            unsigned prev(unsigned v) const {
+                if (type == bitmap_kind) {
+                    unsigned w = v >> 6;
+                    word bits = words[w] & (~word(0) >> (63 - (v & 63)));
+                    while (!bits) {
+                        if (!w)
+                            return none;
+                        bits = words[--w];
+                    }
+                    return w * 64 + ft::log2_floor(bits);
+                }
+                if (type == array_kind) {
+                    size_t i = value_index(v + 1);
+                    return i ? values[i - 1] : none;
+                }
+                size_t i = run_index(v);
+                if (i < runs.size() && runs[i].start <= v)
+                    return v;
+                return i ? runs[i - 1].last : none;
+            }
+
+            // Ors the contents into a bitmap.
+            void fill(word *out) const {
+                if (type == bitmap_kind) {
+                    for (unsigned i = 0; i < bitmap_words; ++i)
+                        out[i] |= words[i];
+                }
+                else if (type == array_kind) {
+                    for (size_t i = 0; i < values.size(); ++i)
+                        out[values[i] >> 6] |= word(1) << (values[i] & 63);
+                }
+                else {
+                    for (size_t i = 0; i < runs.size(); ++i)
+                        fill_range(out, runs[i].start, runs[i].last);
+                }
+            }
+
+            // Appends the contents to a sorted array.
+            void list(ft::vector<unsigned short> &out) const {
+                if (type == array_kind) {
+                    for (size_t i = 0; i < values.size(); ++i)
+                        out.push_back(values[i]);
+                    return;
+                }
+                for (unsigned v = next(0); v != none; v = v == 65535 ? none : next(v + 1))
+                    out.push_back(static_cast<unsigned short>(v));
+            }
+
+            void to_bitmap() {
+                ft::vector<word> bits(bitmap_words, 0);
+
+                fill(&bits[0]);
+                words.swap(bits);
+                ft::vector<unsigned short>().swap(values);
+                ft::vector<run>().swap(runs);
+                type = bitmap_kind;
+            }
+
+            void to_array() {
+                ft::vector<unsigned short> list_values;
+
+                list_values.reserve(card);
+                list(list_values);
+                values.swap(list_values);
+                ft::vector<word>().swap(words);
+                ft::vector<run>().swap(runs);
+                type = array_kind;
+            }
+
+            void to_runs() {
+                ft::vector<run> list_runs;
+
+                for (unsigned v = next(0); v != none; ) {
+                    run r = {static_cast<unsigned short>(v), static_cast<unsigned short>(v)};
+                    while (r.last != 65535 && contains(r.last + 1u))
+                        ++r.last;
+                    list_runs.push_back(r);
+                    v = r.last == 65535 ? none : next(r.last + 1u);
+                }
+                runs.swap(list_runs);
+                ft::vector<unsigned short>().swap(values);
+                ft::vector<word>().swap(words);
+                type = run_kind;
+            }
+
+            // Array or bitmap by cardinality, after an operation that may have crossed array_max.
+            void normalize() {
+                if (card > array_max) {
+                    if (type != bitmap_kind)
+                        to_bitmap();
+                }
+                else if (type != array_kind)
+                    to_array();
+            }
+
+            size_t count_runs() const {
+                if (type == run_kind)
+                    return runs.size();
+                if (type == array_kind) {
+                    size_t n = 0;
+                    for (size_t i = 0; i < values.size(); ++i)
+                        n += !i || values[i - 1] + 1u != values[i];
+                    return n;
+                }
+                // A run starts at every set bit whose lower neighbour is clear.
+                size_t n = 0;
+                word carry = 0;
+                for (unsigned i = 0; i < bitmap_words; ++i) {
+                    n += ft::popcount(words[i] & ~((words[i] << 1) | carry));
+                    carry = words[i] >> 63;
+                }
+                return n;
+            }
+
+            // Switches to runs when they are smaller than the current form, or back when not.
+            void run_optimize() {
+                size_t run_bytes = count_runs() * sizeof(run);
+                size_t other_bytes = card > array_max ? bitmap_words * sizeof(word) : card * sizeof(unsigned short);
+
+                if (run_bytes < other_bytes) {
+                    if (type != run_kind)
+                        to_runs();
+                }
+                else
+                    normalize();
+            }
+
+            size_t bytes() const {
+                return sizeof(container) + values.capacity() * sizeof(unsigned short)
+                    + words.capacity() * sizeof(word) + runs.capacity() * sizeof(run);
+            }
+
+            // Bitmap or large run container: set operations go through words.
+            bool dense() const {
+                return card > array_max;
+            }
+
+            static void fill_range(word *out, unsigned first, unsigned last) {
+                unsigned w = first >> 6;
+                unsigned end = last >> 6;
+                word low = ~word(0) << (first & 63);
+                word high = ~word(0) >> (63 - (last & 63));
+
+                if (w == end) {
+                    out[w] |= low & high;
+                    return;
+                }
+                out[w] |= low;
+                while (++w < end)
+                    out[w] = ~word(0);
+                out[end] |= high;
+            }
+        };
+
+        inline unsigned count_bits(const word *bits) {
+            unsigned n = 0;
+
+            for (unsigned i = 0; i < bitmap_words; ++i)
+                n += ft::popcount(bits[i]);
+            return n;
+        }
+
+        // Takes a bitmap result, keeping it only if the cardinality calls for one.
+        inline void adopt_bitmap(container &c, ft::vector<word> &bits) {
+            c.card = count_bits(&bits[0]);
+            c.words.swap(bits);
+            c.type = bitmap_kind;
+            if (c.card <= array_max)
+                c.to_array();
+        }
+
+        // The word loops below are plain element-wise operations over 1024 words, which the
+        // compiler turns into vector instructions.
+        inline container *unite(const container &a, const container &b) {
+            container *res = new container();
+
+            try {
+                if (a.dense() || b.dense() || a.card + b.card > array_max) {
+                    ft::vector<word> bits(bitmap_words, 0);
+                    a.fill(&bits[0]);
+                    b.fill(&bits[0]);
+                    adopt_bitmap(*res, bits);
+                    return res;
+                }
+                ft::vector<unsigned short> x, y;
+                a.list(x);
+                b.list(y);
+                res->values.reserve(x.size() + y.size());
+                size_t i = 0, j = 0;
+                while (i < x.size() && j < y.size()) {
+                    if (x[i] < y[j])
+                        res->values.push_back(x[i++]);
+                    else if (y[j] < x[i])
+                        res->values.push_back(y[j++]);
+                    else {
+                        res->values.push_back(x[i++]);
+                        ++j;
+                    }
+                }
+                for (; i < x.size(); ++i)
+                    res->values.push_back(x[i]);
+                for (; j < y.size(); ++j)
+                    res->values.push_back(y[j]);
+                res->card = res->values.size();
+            }
+            catch (...) {
+                delete res;
+                throw;
+            }
+            return res;
+        }
+
+        inline container *intersect(const container &a, const container &b) {
+            container *res = new container();
+
+            try {
+                if (a.dense() && b.dense()) {
+                    ft::vector<word> x(bitmap_words, 0), y(bitmap_words, 0);
+                    a.fill(&x[0]);
+                    b.fill(&y[0]);
+                    for (unsigned i = 0; i < bitmap_words; ++i)
+                        x[i] &= y[i];
+                    adopt_bitmap(*res, x);
+                    return res;
+                }
+                // The smaller side is listed and probed against the other.
+                const container &small = a.card <= b.card ? a : b;
+                const container &large = a.card <= b.card ? b : a;
+                ft::vector<unsigned short> x;
+                small.list(x);
+                for (size_t i = 0; i < x.size(); ++i)
+                    if (large.contains(x[i]))
+                        res->values.push_back(x[i]);
+                res->card = res->values.size();
+            }
+            catch (...) {
+                delete res;
+                throw;
+            }
+            return res;
+        }
+
+        inline container *subtract(const container &a, const container &b) {
+            container *res = new container();
+
+            try {
+                if (a.dense()) {
+                    ft::vector<word> x(bitmap_words, 0), y(bitmap_words, 0);
+                    a.fill(&x[0]);
+                    b.fill(&y[0]);
+                    for (unsigned i = 0; i < bitmap_words; ++i)
+                        x[i] &= ~y[i];
+                    adopt_bitmap(*res, x);
+                    return res;
+                }
+                ft::vector<unsigned short> x;
+                a.list(x);
+                for (size_t i = 0; i < x.size(); ++i)
+                    if (!b.contains(x[i]))
+                        res->values.push_back(x[i]);
+                res->card = res->values.size();
+            }
+            catch (...) {
+                delete res;
+                throw;
+            }
+            return res;
+        }
+    }
+
+    // Set of 32-bit unsigned integers in the roaring layout: values are bucketed by their high 16
+    // bits, and each bucket stores the low halves in whichever of a sorted array, a bitmap or a list
+    // of runs is smallest. A dense id set costs about a bit per value against the forty bytes of an
+    // ft::set node. The interface follows ft::set; iterators hand out values in ascending order and
+    // stay valid until the next insert or erase. |, & and - combine sets bucket by bucket.
+    class roaring_set{
+    public:
+        typedef unsigned key_type;
+        typedef key_type value_type;
+        typedef ft::less<key_type> key_compare;
+        typedef key_compare value_compare;
+        typedef size_t size_type;
+        typedef ptrdiff_t difference_type;
+
+        class const_iterator {
+        public:
+            typedef std::bidirectional_iterator_tag iterator_category;
+            typedef unsigned value_type;
+            typedef ptrdiff_t difference_type;
+            typedef const unsigned *pointer;
+            typedef unsigned reference;
+
+            const_iterator() : set_(0), bucket_(0), low_(0) {}
+
+            const_iterator(const roaring_set *set, size_type bucket, unsigned low) : set_(set), bucket_(bucket), low_(low) {}
+
+            reference operator*() const {
+                return (unsigned(set_->keys_[bucket_]) << 16) | low_;
+            }
+
+            const_iterator &operator++() {
+                unsigned next = low_ == 65535 ? roaring_detail::none : set_->containers_[bucket_]->next(low_ + 1);
+
+                if (next == roaring_detail::none) {
+                    ++bucket_;
+                    low_ = bucket_ < set_->keys_.size() ? set_->containers_[bucket_]->next(0) : 0;
+                }
+                else
+                    low_ = next;
+                return *this;
+            }
+
+            const_iterator operator++(int) {
+                const_iterator temp = *this;
+                ++(*this);
+                return temp;
+            }
+
+            const_iterator &operator--() {
+                unsigned prev = bucket_ == set_->keys_.size() || !low_ ? roaring_detail::none
+                                : set_->containers_[bucket_]->prev(low_ - 1);
+
+                if (prev == roaring_detail::none) {
+                    --bucket_;
+                    low_ = set_->containers_[bucket_]->prev(65535);
+                }
+                else
+                    low_ = prev;
+                return *this;
+            }
+
+            const_iterator operator--(int) {
+                const_iterator temp = *this;
+                --(*this);
+                return temp;
+            }
+
+            bool operator==(const const_iterator &it) const {
+                return bucket_ == it.bucket_ && low_ == it.low_;
+            }
+
+            bool operator!=(const const_iterator &it) const {
+                return !(*this == it);
+            }
+
+        private:
+            const roaring_set *set_;
+            size_type bucket_;
+            unsigned low_;
+        };
+
+        typedef const_iterator iterator;
+        typedef ft::reverse_iterator<const_iterator> const_reverse_iterator;
+        typedef const_reverse_iterator reverse_iterator;
+
+        roaring_set() : size_(0) {}
+
+        template <class TemplateIterator>
+        roaring_set(TemplateIterator first, TemplateIterator last) : size_(0) {
+            try {
+                insert(first, last);
+            }
+            catch (...) {
+                clear();
+                throw;
+            }
+        }
+
+        roaring_set(const roaring_set &src) : size_(0) {
+            try {
+                for (size_type i = 0; i < src.keys_.size(); ++i)
+                    append(src.keys_[i], new roaring_detail::container(*src.containers_[i]));
+            }
+            catch (...) {
+                clear();
+                throw;
+            }
+            size_ = src.size_;
+        }
+
+        ~roaring_set() {
+            clear();
+        }
+
+        roaring_set &operator=(const roaring_set &src) {
+            if (this != &src) {
+                roaring_set copy(src);
+                swap(copy);
+            }
+            return *this;
+        }
+
+        const_iterator begin() const {
+            return keys_.empty() ? end() : const_iterator(this, 0, containers_[0]->next(0));
+        }
+
+        const_iterator end() const {
+            return const_iterator(this, keys_.size(), 0);
+        }
+
+        const_reverse_iterator rbegin() const {
+            return const_reverse_iterator(end());
+        }
+
+        const_reverse_iterator rend() const {
+            return const_reverse_iterator(begin());
+        }
+
+        bool empty() const {
+            return !size_;
+        }
+
+        size_type size() const {
+            return size_;
+        }
+
+        size_type max_size() const {
+            return size_type(1) << 32;
+        }
+
+        ft::pair<iterator, bool> insert(const value_type &val) {
+            size_type bucket = bucket_index(val >> 16);
+
+            if (bucket == keys_.size() || keys_[bucket] != val >> 16)
+                add_bucket(bucket, val >> 16);
+            bool res;
+            try {
+                res = containers_[bucket]->insert(val & 65535);
+            }
+            catch (...) {
+                if (!containers_[bucket]->card)
+                    remove_bucket(bucket);
+                throw;
+            }
+            size_ += res;
+            return ft::pair<iterator, bool>(const_iterator(this, bucket, val & 65535), res);
+        }
+
+        iterator insert(iterator, const value_type &val) {
+            return insert(val).first;
+        }
+
+        template <class TemplateIterator>
+        void insert(TemplateIterator first, TemplateIterator last) {
+            for (; first != last; ++first)
+                insert(*first);
+        }
+
+        iterator erase(iterator position) {
+            value_type val = *position;
+
+            erase(val);
+            return lower_bound(val);
+        }
+
+        iterator erase(iterator first, iterator last) {
+            if (last == end()) {
+                while (first != end())
+                    first = erase(first);
+                return end();
+            }
+            value_type stop = *last;
+            while (*first != stop)
+                first = erase(first);
+            return first;
+        }
+
+        size_type erase(const key_type &k) {
+            size_type bucket = bucket_index(k >> 16);
+
+            if (bucket == keys_.size() || keys_[bucket] != k >> 16 || !containers_[bucket]->erase(k & 65535))
+                return 0;
+            --size_;
+            if (!containers_[bucket]->card)
+                remove_bucket(bucket);
+            return 1;
+        }
+
+        void swap(roaring_set &x) {
+            keys_.swap(x.keys_);
+            containers_.swap(x.containers_);
+            std::swap(size_, x.size_);
+        }
+
+        void clear() {
+            for (size_type i = 0; i < containers_.size(); ++i)
+                delete containers_[i];
+            keys_.clear();
+            containers_.clear();
+            size_ = 0;
+        }
+
+        key_compare key_comp() const {
+            return key_compare();
+        }
+
+        value_compare value_comp() const {
+            return value_compare();
+        }
+
+        const_iterator find(const key_type &k) const {
+            size_type bucket = bucket_index(k >> 16);
+
+            if (bucket < keys_.size() && keys_[bucket] == k >> 16 && containers_[bucket]->contains(k & 65535))
+                return const_iterator(this, bucket, k & 65535);
+            return end();
+        }
+
+        size_type count(const key_type &k) const {
+            size_type bucket = bucket_index(k >> 16);
+
+            return bucket < keys_.size() && keys_[bucket] == k >> 16 && containers_[bucket]->contains(k & 65535);
+        }
+
+        const_iterator lower_bound(const key_type &k) const {
+            size_type bucket = bucket_index(k >> 16);
+
+            if (bucket < keys_.size() && keys_[bucket] == k >> 16) {
+                unsigned low = containers_[bucket]->next(k & 65535);
+                if (low != roaring_detail::none)
+                    return const_iterator(this, bucket, low);
+                ++bucket;
+            }
+            if (bucket == keys_.size())
+                return end();
+            return const_iterator(this, bucket, containers_[bucket]->next(0));
+        }
+
+        const_iterator upper_bound(const key_type &k) const {
+            return k == ~key_type(0) ? end() : lower_bound(k + 1);
+        }
+
+        ft::pair<const_iterator, const_iterator> equal_range(const key_type &k) const {
+            return ft::make_pair(lower_bound(k), upper_bound(k));
+        }
+
+        roaring_set &operator|=(const roaring_set &x) {
+            roaring_set res;
+            size_type i = 0;
+            size_type j = 0;
+
+            while (i < keys_.size() || j < x.keys_.size()) {
+                if (j == x.keys_.size() || (i < keys_.size() && keys_[i] < x.keys_[j])) {
+                    res.append(keys_[i], new roaring_detail::container(*containers_[i]));
+                    ++i;
+                }
+                else if (i == keys_.size() || x.keys_[j] < keys_[i]) {
+                    res.append(x.keys_[j], new roaring_detail::container(*x.containers_[j]));
+                    ++j;
+                }
+                else {
+                    res.append(keys_[i], roaring_detail::unite(*containers_[i], *x.containers_[j]));
+                    ++i;
+                    ++j;
+                }
+            }
+            swap(res);
+            return *this;
+        }
+
+        roaring_set &operator&=(const roaring_set &x) {
+            roaring_set res;
+            size_type i = 0;
+            size_type j = 0;
+
+            while (i < keys_.size() && j < x.keys_.size()) {
+                if (keys_[i] < x.keys_[j])
+                    ++i;
+                else if (x.keys_[j] < keys_[i])
+                    ++j;
+                else {
+                    res.append(keys_[i], roaring_detail::intersect(*containers_[i], *x.containers_[j]));
+                    ++i;
+                    ++j;
+                }
+            }
+            swap(res);
+            return *this;
+        }
+
+        roaring_set &operator-=(const roaring_set &x) {
+            roaring_set res;
+            size_type j = 0;
+
+            for (size_type i = 0; i < keys_.size(); ++i) {
+                while (j < x.keys_.size() && x.keys_[j] < keys_[i])
+                    ++j;
+                if (j < x.keys_.size() && x.keys_[j] == keys_[i])
+                    res.append(keys_[i], roaring_detail::subtract(*containers_[i], *x.containers_[j]));
+                else
+                    res.append(keys_[i], new roaring_detail::container(*containers_[i]));
+            }
+            swap(res);
+            return *this;
+        }
+
+        // Converts every bucket whose values form few enough runs to a run list, and back.
+        void run_optimize() {
+            for (size_type i = 0; i < containers_.size(); ++i)
+                containers_[i]->run_optimize();
+        }
+
+        // Heap bytes held by the buckets and their containers.
+        size_type memory_bytes() const {
+            size_type res = keys_.capacity() * sizeof(unsigned short)
+                + containers_.capacity() * sizeof(roaring_detail::container *);
+
+            for (size_type i = 0; i < containers_.size(); ++i)
+                res += containers_[i]->bytes();
+            return res;
+        }
+
+        friend bool operator==(const roaring_set &lhs, const roaring_set &rhs) {
+            if (lhs.size_ != rhs.size_ || lhs.keys_.size() != rhs.keys_.size())
+                return false;
+            for (size_type i = 0; i < lhs.keys_.size(); ++i)
+                if (lhs.keys_[i] != rhs.keys_[i] || lhs.containers_[i]->card != rhs.containers_[i]->card)
+                    return false;
+            for (const_iterator a = lhs.begin(), b = rhs.begin(); a != lhs.end(); ++a, ++b)
+                if (*a != *b)
+                    return false;
+            return true;
+        }
+
+    private:
+        ft::vector<unsigned short> keys_;
+        ft::vector<roaring_detail::container *> containers_;
+        size_type size_;
+
+        size_type bucket_index(unsigned key) const {
+            size_type lo = 0;
+            size_type hi = keys_.size();
+
+            while (lo < hi) {
+                size_type mid = lo + (hi - lo) / 2;
+                if (keys_[mid] < key)
+                    lo = mid + 1;
+                else
+                    hi = mid;
+            }
+            return lo;
+        }
+
+        void add_bucket(size_type bucket, unsigned key) {
+            roaring_detail::container *c = new roaring_detail::container();
+
+            try {
+                roaring_detail::insert_at(containers_, bucket, c);
+            }
+            catch (...) {
+                delete c;
+                throw;
+            }
+            try {
+                roaring_detail::insert_at(keys_, bucket, static_cast<unsigned short>(key));
+            }
+            catch (...) {
+                roaring_detail::erase_at(containers_, bucket);
+                delete c;
+                throw;
+            }
+        }
+
+        void remove_bucket(size_type bucket) {
+            delete containers_[bucket];
+            roaring_detail::erase_at(containers_, bucket);
+            roaring_detail::erase_at(keys_, bucket);
+        }
+
+        // Takes ownership of c, which results of set operations may leave empty.
+        void append(unsigned key, roaring_detail::container *c) {
+            if (!c->card) {
+                delete c;
+                return;
+            }
+            try {
+                keys_.push_back(static_cast<unsigned short>(key));
+                containers_.push_back(c);
+            }
+            catch (...) {
+                if (keys_.size() > containers_.size())
+                    keys_.pop_back();
+                delete c;
+                throw;
+            }
+            size_ += c->card;
+        }
+    };
+
+    inline bool operator!=(const roaring_set &lhs, const roaring_set &rhs) {
+        return !(lhs == rhs);
+    }
+
+    inline roaring_set operator|(const roaring_set &lhs, const roaring_set &rhs) {
+        roaring_set res(lhs);
+        return res |= rhs;
+    }
+
+    inline roaring_set operator&(const roaring_set &lhs, const roaring_set &rhs) {
+        roaring_set res(lhs);
+        return res &= rhs;
+    }
+
+    inline roaring_set operator-(const roaring_set &lhs, const roaring_set &rhs) {
+        roaring_set res(lhs);
+        return res -= rhs;
+    }
+
+    inline void swap(roaring_set &x, roaring_set &y) {
+        x.swap(y);
+    }
+}
@@ -9,6 +9,9 @@
 #include "../utils/iterator_traits.hpp"
 #include "../map/red_black_tree.hpp"
 #include "../map/node.hpp"
+#include "../map/bulk_build.hpp"
+#include "../map/stream_build.hpp"
+#include "frozen_set.hpp"
 
 namespace ft
 {
@@ -36,6 +39,8 @@ namespace ft
         typedef red_black_tree<value_type, value_compare, node_allocator_type> tree_type;
 
     public:
+        // Every other constructor delegates here first, so once the header node exists ~set owns it
+        // and releases it, together with anything already linked, if the build step throws.
         explicit set(const key_compare &comp = key_compare(), const allocator_type &alloc = allocator_type()) {
             alloc_ = alloc;
             node_ = rb_tree_.create_node(value_type());
@@ -46,12 +51,45 @@ namespace ft
         template <class TemplateIterator>
         set(TemplateIterator first, TemplateIterator last,
                 const key_compare &comp = key_compare(),
-                const allocator_type &alloc = allocator_type()) {
-            alloc_ = alloc;
-            node_ = rb_tree_.create_node(value_type());
-            cmpr_ = comp;
-            sz_ = 0;
-            insert(first, last);
+                const allocator_type &alloc = allocator_type()) : set(comp, alloc) {
+            build(first, last, false, 0);
+        }
+
+        template <class TemplateIterator>
+        set(TemplateIterator first, TemplateIterator last, keep_first_t,
+                const key_compare &comp = key_compare(),
+                const allocator_type &alloc = allocator_type()) : set(comp, alloc) {
+            build(first, last, false, 0);
+        }
+
+        template <class TemplateIterator>
+        set(TemplateIterator first, TemplateIterator last, keep_last_t,
+                const key_compare &comp = key_compare(),
+                const allocator_type &alloc = allocator_type()) : set(comp, alloc) {
+            build(first, last, true, 0);
+        }
+
+        // Sorts and links inputs of bulk_detail::parallel_threshold elements or more on pool.
+        template <class TemplateIterator>
+        set(TemplateIterator first, TemplateIterator last, ft::thread_pool &pool,
+                const key_compare &comp = key_compare(),
+                const allocator_type &alloc = allocator_type()) : set(comp, alloc) {
+            build(first, last, false, &pool);
+        }
+
+        template <class TemplateIterator>
+        set(sorted_input_t, TemplateIterator first, TemplateIterator last,
+                const key_compare &comp = key_compare(),
+                const allocator_type &alloc = allocator_type()) : set(comp, alloc) {
+            stream(first, last);
+        }
+
+        template <class TemplateIterator>
+        set(spill_input_t, TemplateIterator first, TemplateIterator last,
+                size_t run_records = stream_detail::run_records,
+                const key_compare &comp = key_compare(),
+                const allocator_type &alloc = allocator_type()) : set(comp, alloc) {
+            spill(first, last, run_records ? run_records : 1);
         }
 
         ~set() {
@@ -59,11 +97,7 @@ namespace ft
             rb_tree_.clear(&node_);
         }
 
-        set(const set &src) {
-            alloc_ = src.alloc_;
-            node_ = rb_tree_.create_node(value_type());
-            cmpr_ = src.cmpr_;
-            sz_ = src.sz_;
+        set(const set &src) : set(src.cmpr_, src.alloc_) {
             *this = src;
         }
 
@@ -140,15 +174,15 @@ namespace ft
             return iterator(node_, ptr);
         }
 
-        void erase(iterator first, iterator last){
-            while(first != last)
-                erase(first++);
+        iterator erase(iterator first, iterator last){
+            sz_ -= rb_tree_.erase_range(&node_->parent, first.base(), last.base());
+            return last;
         }
 
-        void erase(iterator position){
-            bool res = rb_tree_.erase(&node_->parent, *position);
-            if (res)
-                --sz_;
+        iterator erase(iterator position){
+            p_node next = rb_tree_.erase_node(&node_->parent, position.base());
+            --sz_;
+            return iterator(node_, next);
         }
 
         size_type erase(const key_type &k){
@@ -195,6 +229,43 @@ namespace ft
             return 0;
         }
 
+        template<class KeyIterator, class OutputIterator>
+        OutputIterator find_many(KeyIterator first, KeyIterator last, OutputIterator out) {
+            p_node found[tree_type::batch_width];
+
+            while (first != last) {
+                KeyIterator next = rb_tree_.find_batch(node_->parent, first, last, found);
+                for (size_type i = 0; first != next; ++first, ++i)
+                    *out++ = iterator(node_, found[i]);
+            }
+            return out;
+        }
+
+        template<class KeyIterator, class OutputIterator>
+        OutputIterator find_many(KeyIterator first, KeyIterator last, OutputIterator out) const {
+            p_node found[tree_type::batch_width];
+
+            while (first != last) {
+                KeyIterator next = rb_tree_.find_batch(node_->parent, first, last, found);
+                for (size_type i = 0; first != next; ++first, ++i)
+                    *out++ = const_iterator(node_, found[i]);
+            }
+            return out;
+        }
+
+        template<class KeyIterator>
+        size_type count_many(KeyIterator first, KeyIterator last) const {
+            p_node found[tree_type::batch_width];
+            size_type res = 0;
+
+            while (first != last) {
+                KeyIterator next = rb_tree_.find_batch(node_->parent, first, last, found);
+                for (size_type i = 0; first != next; ++first, ++i)
+                    res += found[i] != 0;
+            }
+            return res;
+        }
+
         iterator lower_bound(const key_type &k) {
             return iterator(node_, rb_tree_.lowest_elem(node_->parent, k));
         }
@@ -232,12 +303,40 @@ namespace ft
             return alloc_;
         }
 
+        frozen_set<Key, Compare, Alloc> freeze() const {
+            return frozen_set<Key, Compare, Alloc>(begin(), end(), cmpr_, alloc_);
+        }
+
     private:
         tree_type		rb_tree_;
         allocator_type	alloc_;
         p_node			node_;
         key_compare		cmpr_;
         size_type		sz_;
+
+        template <class TemplateIterator>
+        void build(TemplateIterator first, TemplateIterator last, bool keep_last, ft::thread_pool *pool) {
+            size_t count;
+
+            node_->parent = ft::bulk_build<value_type>(rb_tree_, first, last, cmpr_, keep_last, &count, pool);
+            sz_ = count;
+        }
+
+        template <class TemplateIterator>
+        void stream(TemplateIterator first, TemplateIterator last) {
+            size_t count;
+
+            node_->parent = ft::stream_build<value_type>(rb_tree_, first, last, cmpr_, &count);
+            sz_ = count;
+        }
+
+        template <class TemplateIterator>
+        void spill(TemplateIterator first, TemplateIterator last, size_t run_records) {
+            size_t count;
+
+            node_->parent = ft::spill_build<value_type>(rb_tree_, first, last, cmpr_, run_records, &count);
+            sz_ = count;
+        }
     };
 
     template <class Key, class Compare, class Allocator>
@@ -0,0 +1,230 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <new>
+#include <cstddef>
+#include <type_traits>
+#include "../utils/bits.hpp"
+#include "../utils/cache_line.hpp"
+
+namespace ft{
+    // Treiber stack. Nodes are addressed by 32-bit index and never returned to the allocator before
+    // destruction, so each head word carries a 32-bit tag that makes a stale compare-exchange fail (ABA).
+    // A failed compare-exchange first tries to meet an opposite operation in the elimination array.
+    template <class T, class Alloc = std::allocator<T> >
+    class concurrent_stack
+    {
+        private:
+            struct node{
+                typename std::aligned_storage<sizeof(T), alignof(T)>::type value;
+                std::atomic<unsigned> next;
+            };
+
+        public:
+            typedef T value_type;
+            typedef size_t size_type;
+            typedef typename Alloc::template rebind<node>::other node_allocator_type;
+
+            static const size_type elimination_width = 16;
+            static const unsigned elimination_spin = 128;
+
+            concurrent_stack() : head_(0), free_(0), fresh_(0), ticket_(0) {
+                for (size_type i = 0; i < segment_count; ++i)
+                    segments_[i].store(0, std::memory_order_relaxed);
+                for (size_type i = 0; i < elimination_width; ++i)
+                    elimination_[i].store(0, std::memory_order_relaxed);
+            }
+
+            ~concurrent_stack() {
+                unsigned index = static_cast<unsigned>(head_.load(std::memory_order_relaxed));
+
+                while (index) {
+                    node *current = slot(index);
+                    index = current->next.load(std::memory_order_relaxed);
+                    reinterpret_cast<T *>(&current->value)->~T();
+                }
+                for (size_type i = 0; i < segment_count; ++i) {
+                    node *segment = segments_[i].load(std::memory_order_relaxed);
+                    if (segment)
+                        allocator_.deallocate(segment, segment_size(i));
+                }
+            }
+
+            bool empty() const {
+                return !static_cast<unsigned>(head_.load(std::memory_order_acquire));
+            }
+
+            void push(const value_type &val) {
+                unsigned index = make_node(val);
+
+                while (!try_link(head_, index, index))
+                    if (eliminate_push(index))
+                        return;
+            }
+
+            // Links [first, last) as one chain and publishes it with a single compare-exchange.
+            template <class InputIterator>
+            void push_bulk(InputIterator first, InputIterator last) {
+                unsigned top = 0;
+                unsigned bottom = 0;
+
+                for (; first != last; ++first) {
+                    unsigned index = make_node(*first);
+                    slot(index)->next.store(top, std::memory_order_relaxed);
+                    if (!bottom)
+                        bottom = index;
+                    top = index;
+                }
+                if (top)
+                    while (!try_link(head_, top, bottom))
+                        ;
+            }
+
+            bool try_pop(value_type &out) {
+                unsigned index;
+
+                for (;;) {
+                    unsigned long long old = head_.load(std::memory_order_acquire);
+                    if (!static_cast<unsigned>(old))
+                        return false;
+                    if (try_unlink(head_, old)) {
+                        index = static_cast<unsigned>(old);
+                        break;
+                    }
+                    if ((index = eliminate_pop()))
+                        break;
+                }
+                T *value = reinterpret_cast<T *>(&slot(index)->value);
+                out = *value;
+                value->~T();
+                free_node(index);
+                return true;
+            }
+
+        private:
+            concurrent_stack(const concurrent_stack &);
+            concurrent_stack &operator=(const concurrent_stack &);
+
+            static const unsigned base_shift = 6;
+            static const size_type segment_count = 32 - base_shift;
+            // Highest index the segments can hold: index - 1 + 2^base_shift must stay below 2^32.
+            static const unsigned max_nodes = ~0u - (1u << base_shift) + 1;
+            static const unsigned long long tag_one = 1ULL << 32;
+
+            alignas(ft::cache_line_size) std::atomic<unsigned long long> head_;
+            alignas(ft::cache_line_size) std::atomic<unsigned long long> free_;
+            alignas(ft::cache_line_size) std::atomic<unsigned> fresh_;
+            std::atomic<unsigned> ticket_;
+            std::atomic<node *> segments_[segment_count];
+            alignas(ft::cache_line_size) std::atomic<unsigned long long> elimination_[elimination_width];
+            node_allocator_type allocator_;
+
+            static size_type segment_size(size_type segment) {
+                return size_type(1) << (segment + base_shift);
+            }
+
+            // Index i >= 1 lives in segment s at offset o where i - 1 + 2^base_shift == 2^(s + base_shift) + o.
+            node *slot(unsigned index) const {
+                unsigned long long j = static_cast<unsigned long long>(index) - 1 + (1ULL << base_shift);
+                unsigned segment = ft::log2_floor(j) - base_shift;
+
+                return segments_[segment].load(std::memory_order_acquire) + (j - segment_size(segment));
+            }
+
+            bool try_link(std::atomic<unsigned long long> &head, unsigned top, unsigned bottom) {
+                unsigned long long old = head.load(std::memory_order_relaxed);
+
+                slot(bottom)->next.store(static_cast<unsigned>(old), std::memory_order_relaxed);
+                return head.compare_exchange_weak(old, ((old & ~0xffffffffULL) + tag_one) | top,
+                                                  std::memory_order_release, std::memory_order_relaxed);
+            }
+
+            bool try_unlink(std::atomic<unsigned long long> &head, unsigned long long old) {
+                unsigned next = slot(static_cast<unsigned>(old))->next.load(std::memory_order_relaxed);
+
+                return head.compare_exchange_weak(old, ((old & ~0xffffffffULL) + tag_one) | next,
+                                                  std::memory_order_acq_rel, std::memory_order_acquire);
+            }
+
+            unsigned make_node(const value_type &val) {
+                unsigned index = alloc_node();
+
+                try {
+                    new (&slot(index)->value) T(val);
+                }
+                catch (...) {
+                    free_node(index);
+                    throw;
+                }
+                return index;
+            }
+
+            unsigned alloc_node() {
+                for (;;) {
+                    unsigned long long old = free_.load(std::memory_order_acquire);
+                    if (!static_cast<unsigned>(old))
+                        break;
+                    if (try_unlink(free_, old))
+                        return static_cast<unsigned>(old);
+                }
+                // Claims the next fresh index only if one is left, so a full stack keeps throwing
+                // instead of wrapping round onto live nodes.
+                unsigned count = fresh_.load(std::memory_order_relaxed);
+                do {
+                    if (count >= max_nodes)
+                        throw std::bad_alloc();
+                } while (!fresh_.compare_exchange_weak(count, count + 1, std::memory_order_relaxed));
+                unsigned index = count + 1;
+                unsigned long long j = static_cast<unsigned long long>(index) - 1 + (1ULL << base_shift);
+                unsigned segment = ft::log2_floor(j) - base_shift;
+                if (!segments_[segment].load(std::memory_order_acquire)) {
+                    node *fresh = allocator_.allocate(segment_size(segment));
+                    node *expected = 0;
+                    if (!segments_[segment].compare_exchange_strong(expected, fresh, std::memory_order_acq_rel))
+                        allocator_.deallocate(fresh, segment_size(segment));
+                }
+                return index;
+            }
+
+            void free_node(unsigned index) {
+                while (!try_link(free_, index, index))
+                    ;
+            }
+
+            size_type pick_slot() {
+                static thread_local unsigned seed = 0;
+
+                if (!seed)
+                    seed = ticket_.fetch_add(0x9e3779b9u, std::memory_order_relaxed) | 1;
+                seed ^= seed << 13;
+                seed ^= seed >> 17;
+                seed ^= seed << 5;
+                return seed & (elimination_width - 1);
+            }
+
+            // Offers the node in a slot for a while; true if a concurrent pop took it.
+            bool eliminate_push(unsigned index) {
+                std::atomic<unsigned long long> &cell = elimination_[pick_slot()];
+                unsigned long long offer = (static_cast<unsigned long long>(ticket_.fetch_add(1, std::memory_order_relaxed)) << 32) | index;
+                unsigned long long expected = 0;
+
+                if (!cell.compare_exchange_strong(expected, offer, std::memory_order_release, std::memory_order_relaxed))
+                    return false;
+                for (unsigned i = 0; i < elimination_spin; ++i)
+                    if (cell.load(std::memory_order_relaxed) != offer)
+                        return true;
+                expected = offer;
+                return !cell.compare_exchange_strong(expected, 0, std::memory_order_relaxed, std::memory_order_relaxed);
+            }
+
+            unsigned eliminate_pop() {
+                std::atomic<unsigned long long> &cell = elimination_[pick_slot()];
+                unsigned long long offer = cell.load(std::memory_order_relaxed);
+
+                if (offer && cell.compare_exchange_strong(offer, 0, std::memory_order_acquire, std::memory_order_relaxed))
+                    return static_cast<unsigned>(offer);
+                return 0;
+            }
+    };
+}
@@ -5,13 +5,16 @@
 #include "../utils/is_integral.hpp"
 #include "../utils/utils.hpp"
 #include "../vector/vector.hpp"
+#include "../deque/deque.hpp"
 namespace ft{
-    template <class T, class Container = ft::vector<T> >
+    template <class T, class Container = ft::deque<T> >
     class stack
     {
         public:
             typedef T value_t;
             typedef Container container_t;
+            typedef T value_type;
+            typedef Container container_type;
             typedef size_t size_type;
 
             explicit stack(const container_t &cnr = container_t()) {
@@ -31,7 +34,7 @@ namespace ft{
             }
 
             const value_t &top() const {
-                return c.back_back();
+                return c.back();
             }
 
             void push(const value_t &val) {
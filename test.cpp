@@ -0,0 +1,2463 @@
+// Regression tests for the containers beyond main.cpp's smoke run. From the repository root:
+//
+//     c++ -std=c++11 -O1 -g -pthread -fsanitize=address,undefined -I. test.cpp -o test && ./test [seed]
+//     c++ -std=c++11 -O1 -g -pthread -fsanitize=thread -I. test.cpp -o test_tsan && ./test_tsan [seed]
+//
+// Every test checks the ft container against the std one, or against a replay of the same operations,
+// and stops at the first mismatch with the failing expression.
+#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <numeric>
+#include <queue>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <thread>
+#include <vector>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <csignal>
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "deque/deque.hpp"
+#include "map/map.hpp"
+#include "map/mmap_map.hpp"
+#include "map/sharded_map.hpp"
+#include "parallel/numa_allocator.hpp"
+#include "parallel/parallel_sort.hpp"
+#include "parallel/thread_pool.hpp"
+#include "parallel/work_stealing_deque.hpp"
+#include "queue/mpmc_ring.hpp"
+#include "queue/queue.hpp"
+#include "set/roaring_set.hpp"
+#include "set/set.hpp"
+#include "stack/concurrent_stack.hpp"
+#include "stack/stack.hpp"
+#include "vector/concurrent_vector.hpp"
+#include "vector/delta_vector.hpp"
+#include "vector/mapped_vector_view.hpp"
+#include "vector/packed_vector.hpp"
+#include "vector/segmented_vector.hpp"
+#include "vector/small_vector.hpp"
+#include "vector/soa_vector.hpp"
+#include "vector/span.hpp"
+#include "vector/static_vector.hpp"
+#include "vector/vector_io.hpp"
+#include "utils/algorithm.hpp"
+#include "utils/external_sort.hpp"
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": check failed: " #cond << std::endl; \
+            std::exit(1); \
+        } \
+    } while (0)
+
+namespace
+{
+    unsigned seed_value;
+
+    // Fresh path under /tmp, removed again by the caller.
+    std::string temp_path(const char *name) {
+        char buf[256];
+
+        std::snprintf(buf, sizeof(buf), "/tmp/ft_test_%s_%d", name, static_cast<int>(getpid()));
+        return buf;
+    }
+
+    template <class Key, class T>
+    bool same_map(const ft::map<Key, T> &m, const std::map<Key, T> &ref) {
+        typename ft::map<Key, T>::const_iterator it = m.begin();
+
+        if (static_cast<size_t>(m.size()) != ref.size())
+            return false;
+        for (typename std::map<Key, T>::const_iterator r = ref.begin(); r != ref.end(); ++r, ++it)
+            if (it == m.end() || it->first != r->first || it->second != r->second)
+                return false;
+        return it == m.end();
+    }
+
+    template <class Key>
+    bool same_set(const ft::set<Key> &s, const std::set<Key> &ref) {
+        return static_cast<size_t>(s.size()) == ref.size() && std::equal(ref.begin(), ref.end(), s.begin());
+    }
+
+    // Random inserts, lookups and every kind of erase on ft::map and std::map side by side, with
+    // find_many/count_many batches checked against one find per key.
+    void test_map_equivalence() {
+        ft::map<int, int> m;
+        std::map<int, int> ref;
+
+        std::srand(seed_value);
+        for (int i = 0; i < 60000; ++i) {
+            int key = std::rand() % 5000;
+            switch (std::rand() % 9) {
+                case 0:
+                case 1:
+                    CHECK(m.insert(ft::make_pair(key, i)).second == ref.insert(std::make_pair(key, i)).second);
+                    break;
+                case 2:
+                    m[key] = i;
+                    ref[key] = i;
+                    break;
+                case 3:
+                    CHECK(m.erase(key) == static_cast<int>(ref.erase(key)));
+                    break;
+                case 4: {
+                    ft::map<int, int>::iterator it = m.find(key);
+                    CHECK((it == m.end()) == !ref.count(key));
+                    if (it != m.end()) {
+                        CHECK(it->second == ref[key]);
+                        m.erase(it);
+                        ref.erase(key);
+                    }
+                    break;
+                }
+                case 5: {
+                    int hi = key + std::rand() % 300;
+                    m.erase(m.lower_bound(key), m.lower_bound(hi));
+                    ref.erase(ref.lower_bound(key), ref.lower_bound(hi));
+                    break;
+                }
+                case 6: {
+                    ft::map<int, int>::iterator lo = m.lower_bound(key);
+                    ft::map<int, int>::iterator up = m.upper_bound(key);
+                    std::map<int, int>::iterator rlo = ref.lower_bound(key);
+                    std::map<int, int>::iterator rup = ref.upper_bound(key);
+                    CHECK((lo == m.end()) == (rlo == ref.end()) && (lo == m.end() || lo->first == rlo->first));
+                    CHECK((up == m.end()) == (rup == ref.end()) && (up == m.end() || up->first == rup->first));
+                    break;
+                }
+                default: {
+                    std::vector<int> keys(1 + std::rand() % 200);
+                    std::vector<ft::map<int, int>::iterator> found;
+                    size_t present = 0;
+                    for (size_t k = 0; k < keys.size(); ++k) {
+                        keys[k] = std::rand() % 5000;
+                        present += ref.count(keys[k]);
+                    }
+                    m.find_many(keys.begin(), keys.end(), std::back_inserter(found));
+                    CHECK(found.size() == keys.size());
+                    for (size_t k = 0; k < keys.size(); ++k)
+                        CHECK(found[k] == m.find(keys[k]));
+                    CHECK(static_cast<size_t>(m.count_many(keys.begin(), keys.end())) == present);
+                }
+            }
+            if (i % 5000 == 0) {
+                CHECK(same_map(m, ref));
+                ft::map<int, int> copy(m);
+                ft::map<int, int> other;
+                other.swap(copy);
+                CHECK(same_map(other, ref) && copy.empty());
+            }
+        }
+        CHECK(same_map(m, ref));
+        m.clear();
+        CHECK(m.empty() && m.begin() == m.end());
+    }
+
+    // Every bulk constructor against std::map built by inserting the same elements, on either side
+    // of the size where a pool is used.
+    void test_map_bulk_build() {
+        const int sizes[] = {0, 1, 100, 20000, 70000};
+        ft::thread_pool pool(2);
+
+        std::srand(seed_value);
+        for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s) {
+            std::vector<ft::pair<int, int> > in;
+            std::map<int, int> first;
+            std::map<int, int> last;
+            for (int i = 0; i < sizes[s]; ++i) {
+                in.push_back(ft::make_pair(std::rand() % (sizes[s] + 1), i));
+                first.insert(std::make_pair(in.back().first, i));
+                last[in.back().first] = i;
+            }
+            CHECK(same_map(ft::map<int, int>(in.begin(), in.end()), first));
+            CHECK(same_map(ft::map<int, int>(in.begin(), in.end(), ft::keep_last), last));
+            CHECK(same_map(ft::map<int, int>(in.begin(), in.end(), pool), first));
+            CHECK(same_map(ft::map<int, int>(ft::spill_input, in.begin(), in.end(), 1000), first));
+            // Enough runs for two generations of merge passes before the last merge into the tree.
+            CHECK(same_map(ft::map<int, int>(ft::spill_input, in.begin(), in.end(), 17), first));
+            std::vector<ft::pair<int, int> > sorted;
+            for (std::map<int, int>::iterator it = first.begin(); it != first.end(); ++it)
+                sorted.push_back(ft::make_pair(it->first, it->second));
+            CHECK(same_map(ft::map<int, int>(ft::sorted_input, sorted.begin(), sorted.end()), first));
+
+            std::vector<int> keys;
+            for (size_t i = 0; i < in.size(); ++i)
+                keys.push_back(in[i].first);
+            std::set<int> unique(keys.begin(), keys.end());
+            CHECK(same_set(ft::set<int>(keys.begin(), keys.end()), unique));
+            CHECK(same_set(ft::set<int>(keys.begin(), keys.end(), pool), unique));
+            CHECK(same_set(ft::set<int>(ft::spill_input, keys.begin(), keys.end(), 777), unique));
+            CHECK(same_set(ft::set<int>(ft::spill_input, keys.begin(), keys.end(), 5), unique));
+        }
+    }
+
+    void test_set_equivalence() {
+        ft::set<int> s;
+        std::set<int> ref;
+
+        std::srand(seed_value + 1);
+        for (int i = 0; i < 60000; ++i) {
+            int key = std::rand() % 3000;
+            switch (std::rand() % 6) {
+                case 0:
+                case 1:
+                    CHECK(s.insert(key).second == ref.insert(key).second);
+                    break;
+                case 2:
+                    CHECK(s.erase(key) == static_cast<int>(ref.erase(key)));
+                    break;
+                case 3: {
+                    int hi = key + std::rand() % 200;
+                    s.erase(s.lower_bound(key), s.lower_bound(hi));
+                    ref.erase(ref.lower_bound(key), ref.lower_bound(hi));
+                    break;
+                }
+                case 4: {
+                    ft::set<int>::iterator it = s.find(key);
+                    CHECK((it == s.end()) == !ref.count(key));
+                    if (it != s.end()) {
+                        s.erase(it);
+                        ref.erase(key);
+                    }
+                    break;
+                }
+                default: {
+                    std::vector<int> keys(1 + std::rand() % 100);
+                    std::vector<ft::set<int>::iterator> found;
+                    for (size_t k = 0; k < keys.size(); ++k)
+                        keys[k] = std::rand() % 3000;
+                    s.find_many(keys.begin(), keys.end(), std::back_inserter(found));
+                    for (size_t k = 0; k < keys.size(); ++k)
+                        CHECK(found[k] == s.find(keys[k]));
+                }
+            }
+            if (i % 5000 == 0)
+                CHECK(same_set(s, ref));
+        }
+        CHECK(same_set(s, ref));
+    }
+
+    template <class Vector>
+    bool same_sequence(const Vector &v, const std::vector<std::string> &ref) {
+        return v.size() == ref.size() && std::equal(ref.begin(), ref.end(), v.begin());
+    }
+
+    // Strings, so construction and destruction are checked too, across the inline and heap states.
+    void test_small_vector() {
+        typedef ft::small_vector<std::string, 4> small;
+        small v;
+        std::vector<std::string> ref;
+
+        std::srand(seed_value);
+        for (int i = 0; i < 40000; ++i) {
+            std::string val(std::rand() % 24, static_cast<char>('a' + i % 26));
+            size_t at = ref.empty() ? 0 : std::rand() % (ref.size() + 1);
+            switch (std::rand() % 8) {
+                case 0:
+                case 1:
+                    v.push_back(val);
+                    ref.push_back(val);
+                    break;
+                case 2:
+                    if (!ref.empty()) {
+                        v.pop_back();
+                        ref.pop_back();
+                    }
+                    break;
+                case 3:
+                    v.insert(v.begin() + at, 1 + i % 3, val);
+                    ref.insert(ref.begin() + at, 1 + i % 3, val);
+                    break;
+                case 4:
+                    if (at < ref.size()) {
+                        size_t end = at + std::rand() % (ref.size() - at + 1);
+                        v.erase(v.begin() + at, v.begin() + end);
+                        ref.erase(ref.begin() + at, ref.begin() + end);
+                    }
+                    break;
+                case 5: {
+                    size_t n = std::rand() % 10;
+                    v.resize(n, val);
+                    ref.resize(n, val);
+                    break;
+                }
+                case 6: {
+                    small other(ref.begin(), ref.begin() + at);
+                    small copy(v);
+                    copy.swap(other);
+                    CHECK(same_sequence(other, ref));
+                    CHECK(copy.size() == at && std::equal(copy.begin(), copy.end(), ref.begin()));
+                    v = other;
+                    break;
+                }
+                default:
+                    if (ref.size() > 12) {
+                        v.clear();
+                        ref.clear();
+                    }
+            }
+            CHECK(same_sequence(v, ref));
+            CHECK(v.is_inline() == (v.capacity() == small::inline_capacity));
+        }
+
+        ft::stack<int, ft::small_vector<int, 8> > st;
+        for (int i = 0; i < 100; ++i)
+            st.push(i);
+        for (int i = 99; i >= 0; --i) {
+            CHECK(st.top() == i);
+            st.pop();
+        }
+        CHECK(st.empty());
+    }
+
+    template <class Deque>
+    bool same_deque(const Deque &d, const std::deque<std::string> &ref) {
+        if (d.size() != ref.size() || !std::equal(ref.begin(), ref.end(), d.begin()))
+            return false;
+        for (size_t i = 0; i < ref.size(); i += 1 + ref.size() / 8)
+            if (d[i] != ref[i] || d.end() - d.begin() != static_cast<long>(ref.size()))
+                return false;
+        return true;
+    }
+
+    // Both ends, the middle and whole-block runs, so the block map wraps, grows and recycles blocks.
+    void test_deque() {
+        ft::deque<std::string> d;
+        std::deque<std::string> ref;
+
+        std::srand(seed_value);
+        for (int i = 0; i < 60000; ++i) {
+            std::string val(std::rand() % 24, static_cast<char>('a' + i % 26));
+            size_t at = ref.empty() ? 0 : std::rand() % (ref.size() + 1);
+            switch (std::rand() % 12) {
+                case 0:
+                case 1:
+                    d.push_back(val);
+                    ref.push_back(val);
+                    break;
+                case 2:
+                case 3:
+                    d.push_front(val);
+                    ref.push_front(val);
+                    break;
+                case 4:
+                    if (!ref.empty()) {
+                        d.pop_back();
+                        ref.pop_back();
+                    }
+                    break;
+                case 5:
+                    if (!ref.empty()) {
+                        d.pop_front();
+                        ref.pop_front();
+                    }
+                    break;
+                case 6:
+                    CHECK(*d.insert(d.begin() + at, val) == val);
+                    ref.insert(ref.begin() + at, val);
+                    break;
+                case 7: {
+                    // Never zero: libstdc++ 12 std::deque moves an element out on an empty fill insert.
+                    size_t n = 1 + std::rand() % 600;
+                    d.insert(d.begin() + at, n, val);
+                    ref.insert(ref.begin() + at, n, val);
+                    break;
+                }
+                case 8:
+                    if (at < ref.size()) {
+                        size_t end = at + std::rand() % (ref.size() - at + 1);
+                        d.erase(d.begin() + at, d.begin() + end);
+                        ref.erase(ref.begin() + at, ref.begin() + end);
+                    }
+                    break;
+                case 9: {
+                    size_t n = std::rand() % 1200;
+                    d.resize(n, val);
+                    ref.resize(n, val);
+                    break;
+                }
+                case 10: {
+                    ft::deque<std::string> other(ref.begin(), ref.begin() + at);
+                    ft::deque<std::string> copy(d);
+                    copy.swap(other);
+                    CHECK(copy.size() == at && std::equal(copy.begin(), copy.end(), ref.begin()));
+                    CHECK(same_deque(other, ref));
+                    d = copy;
+                    ref.resize(at);
+                    break;
+                }
+                default:
+                    if (ref.size() > 3000) {
+                        d.clear();
+                        ref.clear();
+                    }
+            }
+            CHECK(same_deque(d, ref));
+        }
+
+        ft::stack<int> st;
+        for (int i = 0; i < 5000; ++i)
+            st.push(i);
+        for (int i = 4999; i >= 0; --i) {
+            CHECK(st.top() == i);
+            st.pop();
+        }
+        CHECK(st.empty());
+    }
+
+    // Producers push distinct values, alone and in bulk, while consumers pop; every value must come out
+    // exactly once. Popped nodes are reused at once, so this is where a lost ABA tag would show.
+    void test_concurrent_stack() {
+        const int threads = 4;
+        const int per_thread = 20000;
+        ft::concurrent_stack<int> st;
+        std::vector<std::atomic<int> > seen(threads * per_thread);
+        std::atomic<int> popped(0);
+        std::vector<std::thread> workers;
+
+        for (int t = 0; t < threads; ++t)
+            workers.push_back(std::thread([&, t]() {
+                std::vector<int> batch;
+                for (int i = 0; i < per_thread; ++i) {
+                    int value = t * per_thread + i;
+                    if (i % 3)
+                        st.push(value);
+                    else
+                        batch.push_back(value);
+                    if (batch.size() == 8 || (i + 1 == per_thread && !batch.empty())) {
+                        st.push_bulk(batch.begin(), batch.end());
+                        batch.clear();
+                    }
+                }
+            }));
+        for (int t = 0; t < threads; ++t)
+            workers.push_back(std::thread([&]() {
+                int value;
+                while (popped.load() < threads * per_thread)
+                    if (st.try_pop(value)) {
+                        seen[value].fetch_add(1);
+                        popped.fetch_add(1);
+                    }
+                    else
+                        std::this_thread::yield();
+            }));
+        for (size_t i = 0; i < workers.size(); ++i)
+            workers[i].join();
+        for (size_t i = 0; i < seen.size(); ++i)
+            CHECK(seen[i].load() == 1);
+
+        int value;
+        CHECK(st.empty() && !st.try_pop(value));
+        for (int i = 0; i < 100; ++i)
+            st.push(i);
+        for (int i = 99; i >= 0; --i)
+            CHECK(st.try_pop(value) && value == i);
+        CHECK(st.empty());
+    }
+
+    // Values carry their producer in the high bits, so each consumer can check that it sees every
+    // producer's values in the order they were pushed.
+    void test_mpmc_ring() {
+        const size_t producers = 3;
+        const size_t per_producer = 30000;
+        ft::mpmc_ring<size_t> ring(64);
+        std::vector<std::atomic<int> > seen(producers * per_producer);
+        std::atomic<size_t> popped(0);
+        std::atomic<bool> ordered(true);
+        std::vector<std::thread> workers;
+
+        for (size_t p = 0; p < producers; ++p)
+            workers.push_back(std::thread([&, p]() {
+                size_t batch[5];
+                for (size_t i = 0; i < per_producer; ) {
+                    size_t n = std::min<size_t>(i % 2 ? 5 : 1, per_producer - i);
+                    for (size_t k = 0; k < n; ++k)
+                        batch[k] = p * per_producer + i + k;
+                    n = n > 1 ? ring.try_push_n(batch, n) : ring.try_push(batch[0]);
+                    if (!n)
+                        std::this_thread::yield();
+                    i += n;
+                }
+            }));
+        for (size_t c = 0; c < producers; ++c)
+            workers.push_back(std::thread([&, c]() {
+                std::vector<size_t> last(producers, 0);
+                size_t batch[7];
+                while (popped.load() < producers * per_producer) {
+                    size_t n = c % 2 ? ring.try_pop_n(batch, 7) : ring.try_pop(batch[0]);
+                    if (!n)
+                        std::this_thread::yield();
+                    for (size_t k = 0; k < n; ++k) {
+                        size_t from = batch[k] / per_producer;
+                        if (batch[k] + 1 <= last[from])
+                            ordered.store(false);
+                        last[from] = batch[k] + 1;
+                        seen[batch[k]].fetch_add(1);
+                    }
+                    popped.fetch_add(n);
+                }
+            }));
+        for (size_t i = 0; i < workers.size(); ++i)
+            workers[i].join();
+        CHECK(ordered.load());
+        for (size_t i = 0; i < seen.size(); ++i)
+            CHECK(seen[i].load() == 1);
+        CHECK(ring.empty());
+    }
+
+    // One producer and one consumer with mixed batch sizes: the output must be the input, in order.
+    void test_spsc_ring() {
+        const size_t count = 200000;
+        ft::mpmc_ring<size_t, ft::spsc_tag> ring(16);
+        bool ordered = true;
+
+        std::thread producer([&]() {
+            size_t batch[9];
+            for (size_t i = 0; i < count; ) {
+                size_t n = std::min<size_t>(1 + i % 9, count - i);
+                for (size_t k = 0; k < n; ++k)
+                    batch[k] = i + k;
+                n = ring.try_push_n(batch, n);
+                if (!n)
+                    std::this_thread::yield();
+                i += n;
+            }
+        });
+        size_t batch[6];
+        for (size_t next = 0; next < count; ) {
+            size_t n = ring.try_pop_n(batch, 1 + next % 6);
+            for (size_t k = 0; k < n; ++k)
+                ordered &= batch[k] == next++;
+            if (!n)
+                std::this_thread::yield();
+        }
+        producer.join();
+        CHECK(ordered);
+        CHECK(ring.empty());
+
+        // Strings left in the ring are destroyed with it; ASan reports a leak otherwise.
+        ft::mpmc_ring<std::string> strings(4);
+        ft::mpmc_ring<std::string, ft::spsc_tag> spsc_strings(4);
+        std::string out;
+        for (int i = 0; i < 4; ++i) {
+            CHECK(strings.try_push(std::string(40, 'a' + i)));
+            CHECK(spsc_strings.try_push(std::string(40, 'a' + i)));
+        }
+        CHECK(!strings.try_push("full") && !spsc_strings.try_push("full"));
+        CHECK(strings.try_pop(out) && out == std::string(40, 'a'));
+        CHECK(spsc_strings.try_pop(out) && out == std::string(40, 'a'));
+
+        ft::queue<int> q;
+        std::queue<int> ref;
+        std::srand(seed_value);
+        for (int i = 0; i < 20000; ++i) {
+            if (std::rand() % 3 && !ref.empty()) {
+                CHECK(q.front() == ref.front() && q.back() == ref.back());
+                q.pop();
+                ref.pop();
+            }
+            else {
+                q.push(i);
+                ref.push(i);
+            }
+            CHECK(q.size() == ref.size());
+        }
+    }
+
+    // The owner pushes and takes while thieves steal, from a ring small enough to grow several times.
+    void test_work_stealing_deque() {
+        const size_t count = 100000;
+        ft::work_stealing_deque<size_t> tasks(4);
+        std::vector<std::atomic<int> > seen(count);
+        std::atomic<bool> done(false);
+        std::vector<std::thread> thieves;
+
+        for (int t = 0; t < 3; ++t)
+            thieves.push_back(std::thread([&]() {
+                size_t value;
+                while (!done.load())
+                    if (tasks.steal(value))
+                        seen[value].fetch_add(1);
+                    else
+                        std::this_thread::yield();
+            }));
+        size_t value;
+        for (size_t i = 0; i < count; ++i) {
+            tasks.push(i);
+            if (i % 3 == 0 && tasks.take(value))
+                seen[value].fetch_add(1);
+        }
+        while (tasks.take(value))
+            seen[value].fetch_add(1);
+        while (!tasks.empty())
+            std::this_thread::yield();
+        done.store(true);
+        for (size_t i = 0; i < thieves.size(); ++i)
+            thieves[i].join();
+        for (size_t i = 0; i < count; ++i)
+            CHECK(seen[i].load() == 1);
+    }
+
+    long fib(ft::thread_pool &pool, int n) {
+        if (n < 12)
+            return n < 2 ? n : fib(pool, n - 1) + fib(pool, n - 2);
+        long a;
+        long b;
+        pool.invoke([&]() { a = fib(pool, n - 1); }, [&]() { b = fib(pool, n - 2); });
+        return a + b;
+    }
+
+    // parallel_for must cover every index once, nested invoke must join correctly, and an exception
+    // from either side must reach the caller and leave the pool usable, also with several callers.
+    void test_thread_pool() {
+        ft::thread_pool pool(4);
+        std::vector<std::atomic<int> > seen(100000);
+
+        for (size_t grain = 0; grain < 2000; grain = grain * 7 + 1) {
+            for (size_t i = 0; i < seen.size(); ++i)
+                seen[i].store(0);
+            pool.parallel_for(3, seen.size(), [&](size_t first, size_t last) {
+                CHECK(first < last && (!grain || last - first <= grain));
+                for (size_t i = first; i < last; ++i)
+                    seen[i].fetch_add(1);
+            }, grain);
+            for (size_t i = 0; i < seen.size(); ++i)
+                CHECK(seen[i].load() == (i >= 3));
+        }
+        CHECK(fib(pool, 24) == 46368);
+
+        for (int side = 0; side < 2; ++side) {
+            bool caught = false;
+            try {
+                pool.invoke([&]() { if (!side) throw std::runtime_error("left"); },
+                            [&]() { if (side) throw std::runtime_error("right"); });
+            }
+            catch (const std::runtime_error &e) {
+                caught = std::string(e.what()) == (side ? "right" : "left");
+            }
+            CHECK(caught);
+        }
+        bool caught = false;
+        try {
+            pool.parallel_for(0, 1000, [](size_t first, size_t last) {
+                if (first <= 500 && 500 < last)
+                    throw std::out_of_range("chunk");
+            }, 10);
+        }
+        catch (const std::out_of_range &) {
+            caught = true;
+        }
+        CHECK(caught);
+
+        std::vector<std::thread> callers;
+        std::atomic<int> right(0);
+        for (int t = 0; t < 3; ++t)
+            callers.push_back(std::thread([&]() {
+                for (int i = 0; i < 20; ++i)
+                    right.fetch_add(fib(pool, 16) == 987);
+            }));
+        for (size_t i = 0; i < callers.size(); ++i)
+            callers[i].join();
+        CHECK(right.load() == 60);
+    }
+
+    // assign(n, val, pool) must fill every slot whichever policy placed the block, mapped or not, and
+    // the vector must keep working through the allocator afterwards.
+    void test_parallel_assign() {
+        const ft::numa_policy policies[] = {ft::numa_first_touch, ft::numa_local, ft::numa_interleave};
+        const size_t sizes[] = {1000, 1 << 20};
+        ft::thread_pool pool(3);
+
+        for (size_t p = 0; p < 3; ++p)
+            for (size_t k = 0; k < 2; ++k) {
+                ft::vector<size_t, ft::numa_allocator<size_t> > v((ft::numa_allocator<size_t>(policies[p])));
+                v.assign(sizes[k], p + 1, pool);
+                CHECK(v.size() == sizes[k] && std::count(v.begin(), v.end(), p + 1) == static_cast<long>(sizes[k]));
+                v.assign(sizes[k] / 2, k, pool);
+                CHECK(v.size() == sizes[k] / 2 && std::count(v.begin(), v.end(), k) == static_cast<long>(sizes[k] / 2));
+                for (size_t i = 0; i < sizes[k]; ++i)
+                    v.push_back(i);
+                CHECK(v.size() == sizes[k] / 2 * 3 && v.back() == sizes[k] - 1 && v[sizes[k] / 2] == 0);
+            }
+
+        ft::vector<std::string> strings;
+        strings.assign(5000, std::string(30, 's'), pool);
+        CHECK(strings.size() == 5000 && std::count(strings.begin(), strings.end(), std::string(30, 's')) == 5000);
+    }
+
+    // Writers append single values and runs while readers walk the ready prefix; nothing below the
+    // watermark may be unconstructed, and no element may move once written.
+    void test_concurrent_vector() {
+        const size_t writers = 4;
+        const size_t per_writer = 30000;
+        ft::concurrent_vector<std::string> v;
+        std::atomic<size_t> finished(0);
+        std::atomic<bool> consistent(true);
+        std::vector<size_t> appended(writers + 1, 0);
+        std::vector<std::thread> threads;
+
+        v.push_back("0 0");
+        const std::string *first = &v[0];
+        for (size_t w = 0; w < writers; ++w)
+            threads.push_back(std::thread([&, w]() {
+                std::vector<std::string> run;
+                size_t i = 0;
+                while (i < per_writer) {
+                    if (i % 4 == 1) {
+                        v.grow_by(1 + i % 3, std::to_string(w + 1) + " " + std::to_string(i));
+                        i += 1 + i % 3;
+                    }
+                    else if (i % 4 == 2) {
+                        run.clear();
+                        for (size_t k = 0; k < 5; ++k)
+                            run.push_back(std::to_string(w + 1) + " " + std::to_string(i + k));
+                        v.grow_by(run.begin(), run.end());
+                        i += 5;
+                    }
+                    else
+                        v.push_back(std::to_string(w + 1) + " " + std::to_string(i++));
+                }
+                appended[w + 1] = i;
+                finished.fetch_add(1);
+            }));
+        for (size_t r = 0; r < 2; ++r)
+            threads.push_back(std::thread([&]() {
+                while (finished.load() < writers) {
+                    size_t ready = v.ready();
+                    for (size_t i = ready > 64 ? ready - 64 : 0; i < ready; ++i)
+                        if (v[i].find(' ') == std::string::npos)
+                            consistent.store(false);
+                    if (&v[0] != first)
+                        consistent.store(false);
+                    std::this_thread::yield();
+                }
+            }));
+        for (size_t i = 0; i < threads.size(); ++i)
+            threads[i].join();
+        CHECK(consistent.load());
+        CHECK(v.ready() == v.size());
+
+        // Each writer claims its indices in order, so its values must rise along the vector.
+        std::vector<long> last(writers + 1, -1);
+        std::vector<size_t> found(writers + 1, 0);
+        for (size_t i = 1; i < v.size(); ++i) {
+            size_t w = std::strtoul(v[i].c_str(), 0, 10);
+            long seq = std::strtol(v[i].c_str() + v[i].find(' '), 0, 10);
+            CHECK(w >= 1 && w <= writers && seq >= last[w]);
+            last[w] = seq;
+            ++found[w];
+        }
+        CHECK(found == appended);
+        CHECK(&v[0] == first);
+    }
+
+    // Thread t owns the keys equal to t modulo threads and keeps its own std::map of them, while it
+    // also reads the others' keys. The merged iteration must then equal the union of the references.
+    template <class Sharded>
+    void sharded_round(Sharded &m) {
+        const int threads = 4;
+        std::vector<std::map<int, long> > refs(threads);
+        std::vector<std::thread> workers;
+
+        for (int t = 0; t < threads; ++t)
+            workers.push_back(std::thread([&, t]() {
+                std::map<int, long> &ref = refs[t];
+                unsigned state = seed_value + t;
+                long found;
+                for (int i = 0; i < 20000; ++i) {
+                    state = state * 1103515245u + 12345u;
+                    int key = static_cast<int>((state >> 8) % 5000) * threads + t;
+                    switch ((state >> 4) % 6) {
+                        case 0:
+                        case 1:
+                            CHECK(m.insert(ft::make_pair(key, long(i))) == ref.insert(std::make_pair(key, long(i))).second);
+                            break;
+                        case 2:
+                            m.update(key, [&](long &v) { v += i; });
+                            ref[key] += i;
+                            break;
+                        case 3:
+                            CHECK(m.erase(key) == ref.erase(key));
+                            break;
+                        case 4: {
+                            std::vector<ft::pair<int, long> > batch;
+                            for (int k = 0; k < 8; ++k) {
+                                batch.push_back(ft::make_pair(key + k * threads, long(k)));
+                                ref.insert(std::make_pair(key + k * threads, long(k)));
+                            }
+                            m.insert(batch.begin(), batch.end());
+                            break;
+                        }
+                        default:
+                            CHECK(m.find(key, found) == (ref.count(key) == 1));
+                            CHECK(ref.count(key) == 0 || found == ref[key]);
+                            m.count(key + 1);
+                    }
+                }
+            }));
+        for (int t = 0; t < threads; ++t)
+            workers[t].join();
+
+        std::map<int, long> all;
+        for (int t = 0; t < threads; ++t)
+            all.insert(refs[t].begin(), refs[t].end());
+        CHECK(m.size() == all.size());
+        std::map<int, long>::const_iterator ref = all.begin();
+        for (typename Sharded::const_iterator it = m.begin(); it != m.end(); ++it, ++ref)
+            CHECK(ref != all.end() && it->first == ref->first && it->second == ref->second);
+        CHECK(ref == all.end());
+
+        ref = all.begin();
+        m.ordered_for_each([&](const ft::pair<const int, long> &v) {
+            CHECK(v.first == ref->first && v.second == ref->second);
+            ++ref;
+        });
+        std::atomic<size_t> total(0);
+        m.for_each_shard([&](size_t i, typename Sharded::map_type &shard) {
+            for (typename Sharded::map_type::iterator it = shard.begin(); it != shard.end(); ++it)
+                CHECK(m.shard_of(it->first) == i);
+            total += shard.size();
+        });
+        CHECK(total.load() == all.size());
+    }
+
+    void test_sharded_map() {
+        ft::sharded_map<int, long, 8> hashed;
+        sharded_round(hashed);
+
+        const int bounds[] = {2500, 5000, 7500, 10000, 12500, 15000, 17500};
+        typedef ft::sharded_map<int, long, 8, ft::range_partition<int> > ranged_map;
+        ranged_map ranged((ft::range_partition<int>(bounds, bounds + 7)));
+        sharded_round(ranged);
+
+        // Neither container may need more alignment than plain new gives in C++11, and every shard of
+        // a heap-allocated map must still start at the same offset within a cache line.
+        static_assert(alignof(ft::sharded_map<int, long>) <= alignof(std::max_align_t), "");
+        static_assert(alignof(ft::concurrent_vector<int>) <= alignof(std::max_align_t), "");
+        std::vector<char *> spacers;
+        std::vector<ft::sharded_map<int, long, 4> *> heap;
+        std::mutex lock;
+        size_t offset = ft::cache_line_size;
+        for (int i = 0; i < 32; ++i) {
+            spacers.push_back(new char[1 + i * 24]);
+            heap.push_back(new ft::sharded_map<int, long, 4>());
+            heap.back()->for_each_shard([&](size_t, ft::map<int, long> &shard) {
+                size_t at = reinterpret_cast<size_t>(&shard) % ft::cache_line_size;
+                std::lock_guard<std::mutex> guard(lock);
+                CHECK(offset == ft::cache_line_size || offset == at);
+                offset = at;
+            });
+        }
+        for (size_t i = 0; i < heap.size(); ++i) {
+            delete heap[i];
+            delete[] spacers[i];
+        }
+    }
+
+    struct sample{
+        int id;
+        double weight;
+
+        bool operator==(const sample &x) const {
+            return id == x.id && weight == x.weight;
+        }
+    };
+
+    ft::vector<sample> make_samples(size_t n) {
+        ft::vector<sample> v;
+
+        for (size_t i = 0; i < n; ++i) {
+            sample s = {static_cast<int>(i * 7), i / 3.0};
+            v.push_back(s);
+        }
+        return v;
+    }
+
+    template <class A, class B>
+    bool same_samples(const A &a, const B &b) {
+        return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin());
+    }
+
+    // A header claiming count elements followed by payload bytes of data.
+    void write_raw(const std::string &path, const ft::vector_file_header &header, size_t payload) {
+        int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        char padding[64] = {};
+        std::vector<char> data(payload, 'x');
+
+        CHECK(fd >= 0);
+        std::memcpy(padding, &header, sizeof(header));
+        ft::vector_io_detail::write_all(fd, padding, sizeof(padding));
+        ft::vector_io_detail::write_all(fd, data.data(), data.size());
+        ::close(fd);
+    }
+
+    // The message load gives for the file at path, or "" when it loads; v must be left alone on error.
+    std::string load_error(const std::string &path) {
+        ft::vector<sample> v = make_samples(3);
+        int fd = ::open(path.c_str(), O_RDONLY);
+        std::string what;
+
+        CHECK(fd >= 0);
+        try {
+            ft::load(v, fd);
+        }
+        catch (const std::exception &e) {
+            what = e.what();
+            CHECK(same_samples(v, make_samples(3)));
+        }
+        ::close(fd);
+        return what;
+    }
+
+    std::string view_error(const std::string &path) {
+        try {
+            ft::mapped_vector_view<sample> view(path.c_str());
+        }
+        catch (const std::exception &e) {
+            return e.what();
+        }
+        return "";
+    }
+
+    // Round trips through a file, a pipe and a mapped view, then files whose header lies about the
+    // data: loads must fail before allocating for the claimed count and leave the target untouched.
+    void test_vector_io() {
+        const std::string path = temp_path("vector_io");
+        const size_t sizes[] = {0, 1, 300000};
+        int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+
+        CHECK(fd >= 0);
+        for (size_t k = 0; k < 3; ++k)
+            ft::save(make_samples(sizes[k]), fd);
+        CHECK(::lseek(fd, 0, SEEK_SET) == 0);
+        for (size_t k = 0; k < 3; ++k) {
+            ft::vector<sample> back = make_samples(5);
+            ft::load(back, fd);
+            CHECK(same_samples(back, make_samples(sizes[k])));
+        }
+        ::close(fd);
+
+        int ends[2];
+        CHECK(::pipe(ends) == 0);
+        pid_t writer = fork();
+        CHECK(writer >= 0);
+        if (!writer) {
+            ::close(ends[0]);
+            ft::save(make_samples(300000), ends[1]);
+            _exit(0);
+        }
+        ::close(ends[1]);
+        ft::vector<sample> piped;
+        ft::load(piped, ends[0]);
+        ::close(ends[0]);
+        int status;
+        CHECK(waitpid(writer, &status, 0) == writer && WIFEXITED(status) && !WEXITSTATUS(status));
+        CHECK(same_samples(piped, make_samples(300000)));
+
+        fd = ::open(path.c_str(), O_WRONLY | O_TRUNC);
+        ft::save(make_samples(300000), fd);
+        ::close(fd);
+        {
+            ft::mapped_vector_view<sample> view(path.c_str());
+            CHECK(same_samples(view, make_samples(300000)));
+            CHECK(view.back() == make_samples(300000).back());
+        }
+
+        ft::vector_file_header header = ft::vector_io_detail::make_header(sizeof(sample), 1000);
+        write_raw(path, header, 1000 * sizeof(sample));
+        CHECK(load_error(path).empty() && view_error(path).empty());
+        write_raw(path, header, 999 * sizeof(sample) + 5);
+        CHECK(load_error(path) == "ft::load: truncated file");
+        CHECK(view_error(path) == "ft::mapped_vector_view: truncated file");
+        header.count = 1ULL << 50;
+        write_raw(path, header, 64);
+        CHECK(load_error(path) == "ft::load: truncated file");
+        header.count = ~0ULL / 2;
+        write_raw(path, header, 64);
+        CHECK(load_error(path) == "ft::load: corrupt header");
+        header.count = 1;
+        header.data_offset = 8;
+        write_raw(path, header, 64);
+        CHECK(load_error(path) == "ft::load: corrupt header");
+        header.data_offset = 1ULL << 40;
+        write_raw(path, header, 64);
+        CHECK(load_error(path) == "ft::load: truncated file");
+        CHECK(view_error(path) == "ft::mapped_vector_view: truncated file");
+        header = ft::vector_io_detail::make_header(sizeof(int), 1);
+        write_raw(path, header, 64);
+        CHECK(load_error(path) == "ft::load: element size mismatch");
+        header.magic[0] = 'X';
+        write_raw(path, header, 64);
+        CHECK(load_error(path) == "ft::load: not a vector file");
+        write_raw(path, header, 0);
+        CHECK(::truncate(path.c_str(), 10) == 0);
+        CHECK(load_error(path) == "ft::load: truncated file");
+        CHECK(view_error(path) == "ft::mapped_vector_view: truncated file");
+
+        // Through a pipe the size cannot be checked up front, so a lying count must fail once the data
+        // runs out, having grown the vector only as far as the data went.
+        CHECK(::pipe(ends) == 0);
+        header = ft::vector_io_detail::make_header(sizeof(sample), 1ULL << 40);
+        char padding[64] = {};
+        std::memcpy(padding, &header, sizeof(header));
+        ft::vector_io_detail::write_all(ends[1], padding, sizeof(padding));
+        ft::vector_io_detail::write_all(ends[1], padding, sizeof(padding));
+        ::close(ends[1]);
+        ft::vector<sample> untouched = make_samples(3);
+        bool failed = false;
+        try {
+            ft::load(untouched, ends[0]);
+        }
+        catch (const std::runtime_error &e) {
+            failed = std::string(e.what()) == "ft::load: truncated file";
+        }
+        ::close(ends[0]);
+        CHECK(failed && same_samples(untouched, make_samples(3)));
+        std::remove(path.c_str());
+    }
+
+    bool same_roaring(const ft::roaring_set &r, const std::set<unsigned> &ref) {
+        if (r.size() != ref.size() || !std::equal(ref.begin(), ref.end(), r.begin()))
+            return false;
+        return std::equal(ref.rbegin(), ref.rend(), r.rbegin());
+    }
+
+    // Values drawn so that buckets pass through every form: a few scattered values (array), dense
+    // blocks (bitmap) and long stretches (runs), with set operations between differently shaped sets.
+    unsigned roaring_value(int shape) {
+        switch (shape) {
+            case 0:
+                return static_cast<unsigned>(std::rand()) * 2654435761u;
+            case 1:
+                return (3u << 16) + std::rand() % 30000;
+            default:
+                return (5u << 16) - 20000 + std::rand() % 60000;
+        }
+    }
+
+    std::set<unsigned> std_op(const std::set<unsigned> &a, const std::set<unsigned> &b, int op) {
+        std::set<unsigned> res;
+        std::insert_iterator<std::set<unsigned> > out(res, res.begin());
+
+        if (op == 0)
+            std::set_union(a.begin(), a.end(), b.begin(), b.end(), out);
+        else if (op == 1)
+            std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), out);
+        else
+            std::set_difference(a.begin(), a.end(), b.begin(), b.end(), out);
+        return res;
+    }
+
+    void test_roaring_set() {
+        ft::roaring_set sets[2];
+        std::set<unsigned> refs[2];
+
+        std::srand(seed_value);
+        for (int i = 0; i < 40000; ++i) {
+            int which = std::rand() % 2;
+            ft::roaring_set &r = sets[which];
+            std::set<unsigned> &ref = refs[which];
+            unsigned v = roaring_value(std::rand() % 3);
+            switch (std::rand() % 10) {
+                case 0:
+                case 1:
+                case 2:
+                case 3:
+                    CHECK(r.insert(v).second == ref.insert(v).second);
+                    break;
+                case 4:
+                    for (unsigned k = 0; k < 1000; ++k) {
+                        r.insert(v + k);
+                        ref.insert(v + k);
+                    }
+                    break;
+                case 5:
+                    CHECK(r.erase(v) == ref.erase(v));
+                    break;
+                case 6: {
+                    unsigned hi = v + std::rand() % 5000;
+                    if (hi >= v) {
+                        r.erase(r.lower_bound(v), r.lower_bound(hi));
+                        ref.erase(ref.lower_bound(v), ref.lower_bound(hi));
+                    }
+                    break;
+                }
+                case 7: {
+                    CHECK(r.count(v) == ref.count(v));
+                    std::set<unsigned>::iterator lb = ref.lower_bound(v);
+                    std::set<unsigned>::iterator ub = ref.upper_bound(v);
+                    CHECK(lb == ref.end() ? r.lower_bound(v) == r.end() : *r.lower_bound(v) == *lb);
+                    CHECK(ub == ref.end() ? r.upper_bound(v) == r.end() : *r.upper_bound(v) == *ub);
+                    CHECK((r.find(v) != r.end()) == (ref.find(v) != ref.end()));
+                    break;
+                }
+                case 8:
+                    r.run_optimize();
+                    break;
+                default:
+                    if (i % 50 == 9) {
+                        int op = std::rand() % 3;
+                        ft::roaring_set res = op == 0 ? sets[which] | sets[!which]
+                                            : op == 1 ? sets[which] & sets[!which] : sets[which] - sets[!which];
+                        std::set<unsigned> ref_res = std_op(refs[which], refs[!which], op);
+                        CHECK(same_roaring(res, ref_res));
+                        if (ref_res.size() < 100000) {
+                            sets[which] = res;
+                            refs[which] = ref_res;
+                        }
+                    }
+                    else if (ref.size() > 100000) {
+                        r.clear();
+                        ref.clear();
+                    }
+            }
+            if (i % 500 == 0) {
+                CHECK(same_roaring(sets[0], refs[0]) && same_roaring(sets[1], refs[1]));
+                CHECK((sets[0] == sets[1]) == (refs[0] == refs[1]));
+            }
+        }
+        CHECK(same_roaring(sets[0], refs[0]) && same_roaring(sets[1], refs[1]));
+    }
+
+    typedef std::tuple<int, std::string, double> soa_row;
+
+    template <class Soa>
+    bool same_soa(const Soa &v, const std::vector<soa_row> &ref) {
+        if (v.size() != ref.size())
+            return false;
+        typename Soa::const_iterator it = v.begin();
+        for (size_t i = 0; i < ref.size(); ++i, ++it)
+            if (soa_row(*it) != ref[i] || v.template field<1>()[i] != std::get<1>(ref[i]))
+                return false;
+        return it == v.end();
+    }
+
+    // Every field must stay in step with the others through each operation that adds or removes
+    // elements, and each field array must start on a cache line.
+    void test_soa_vector() {
+        typedef ft::soa_vector<int, std::string, double> soa;
+        soa v;
+        std::vector<soa_row> ref;
+
+        std::srand(seed_value);
+        for (int i = 0; i < 30000; ++i) {
+            soa_row row(i, std::string(std::rand() % 24, static_cast<char>('a' + i % 26)), i * 0.5);
+            size_t at = ref.empty() ? 0 : std::rand() % (ref.size() + 1);
+            switch (std::rand() % 8) {
+                case 0:
+                case 1:
+                case 2:
+                    v.push_back(std::get<0>(row), std::get<1>(row), std::get<2>(row));
+                    ref.push_back(row);
+                    break;
+                case 3:
+                    if (!ref.empty()) {
+                        v.pop_back();
+                        ref.pop_back();
+                    }
+                    break;
+                case 4:
+                    if (at < ref.size()) {
+                        size_t end = at + std::rand() % (ref.size() - at + 1);
+                        v.erase(v.begin() + at, v.begin() + end);
+                        ref.erase(ref.begin() + at, ref.begin() + end);
+                    }
+                    break;
+                case 5: {
+                    size_t n = std::rand() % 300;
+                    if (i % 2)
+                        v.resize(n, std::get<0>(row), std::get<1>(row), std::get<2>(row));
+                    else {
+                        v.resize(n);
+                        row = soa_row();
+                    }
+                    ref.resize(n, row);
+                    break;
+                }
+                case 6: {
+                    soa copy(v);
+                    soa other;
+                    other.push_back(1, "one", 1.0);
+                    copy.swap(other);
+                    CHECK(other.size() == ref.size() && copy.size() == 1 && std::get<1>(copy[0]) == "one");
+                    v = other;
+                    if (!ref.empty()) {
+                        std::get<1>(v.back()) = "changed";
+                        std::get<1>(ref.back()) = "changed";
+                        v.field<2>()[0] += 1;
+                        std::get<2>(ref.front()) += 1;
+                    }
+                    break;
+                }
+                default:
+                    if (ref.size() > 400) {
+                        v.clear();
+                        ref.clear();
+                    }
+            }
+            CHECK(same_soa(v, ref));
+            if (!v.empty()) {
+                CHECK(reinterpret_cast<size_t>(v.data<0>()) % ft::cache_line_size == 0);
+                CHECK(reinterpret_cast<size_t>(v.data<1>()) % ft::cache_line_size == 0);
+                CHECK(reinterpret_cast<size_t>(v.data<2>()) % ft::cache_line_size == 0);
+            }
+        }
+    }
+
+    // Copies succeed until copies_left runs out, then throw; live counts the objects alive.
+    struct fragile{
+        static int copies_left;
+        static int live;
+        int value;
+
+        fragile() : value(0) { ++live; }
+
+        explicit fragile(int v) : value(v) { ++live; }
+
+        fragile(const fragile &src) : value(src.value) {
+            if (copies_left-- == 0)
+                throw std::runtime_error("fragile copy");
+            ++live;
+        }
+
+        ~fragile() { --live; }
+
+        bool operator<(const fragile &x) const { return value < x.value; }
+    };
+
+    int fragile::copies_left = -1;
+    int fragile::live = 0;
+
+    // Lookups and in-order walks in both directions against std::map/std::set, for sizes around
+    // the complete-tree boundaries of the Eytzinger layout; then copies that throw part way through,
+    // which must leave nothing alive and the copy-assigned target unchanged.
+    void test_frozen_map_set() {
+        const int sizes[] = {0, 1, 2, 3, 7, 8, 9, 100, 1023, 1024, 5000};
+
+        std::srand(seed_value);
+        for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s) {
+            ft::map<int, int> m;
+            std::map<int, int> ref;
+            std::set<int> ref_keys;
+            while (ref.size() < static_cast<size_t>(sizes[s])) {
+                int key = 2 * (std::rand() % (4 * sizes[s]));
+                m[key] = key + 1;
+                ref[key] = key + 1;
+                ref_keys.insert(key);
+            }
+            ft::set<int> keys(ref_keys.begin(), ref_keys.end());
+            ft::frozen_map<int, int> fm = m.freeze();
+            ft::frozen_set<int> fs = keys.freeze();
+            CHECK(fm.size() == ref.size() && fs.size() == ref_keys.size());
+
+            ft::frozen_map<int, int>::const_iterator it = fm.begin();
+            for (std::map<int, int>::iterator r = ref.begin(); r != ref.end(); ++r, ++it)
+                CHECK(it != fm.end() && it->first == r->first && it->second == r->second);
+            CHECK(it == fm.end());
+            for (std::map<int, int>::reverse_iterator r = ref.rbegin(); r != ref.rend(); ++r)
+                CHECK((*--it).first == r->first);
+            CHECK(it == fm.begin());
+            CHECK(std::equal(ref_keys.begin(), ref_keys.end(), fs.begin()));
+            CHECK(std::equal(ref_keys.rbegin(), ref_keys.rend(), std::reverse_iterator<ft::frozen_set<int>::const_iterator>(fs.end())));
+
+            for (int key = -1; key <= 8 * sizes[s] + 1; ++key) {
+                std::map<int, int>::iterator lo = ref.lower_bound(key);
+                std::map<int, int>::iterator up = ref.upper_bound(key);
+                ft::frozen_map<int, int>::const_iterator flo = fm.lower_bound(key);
+                ft::frozen_map<int, int>::const_iterator fup = fm.upper_bound(key);
+                CHECK((fm.find(key) == fm.end()) == !ref.count(key) && fm.count(key) == ref.count(key));
+                CHECK((flo == fm.end()) == (lo == ref.end()) && (flo == fm.end() || flo->first == lo->first));
+                CHECK((fup == fm.end()) == (up == ref.end()) && (fup == fm.end() || fup->first == up->first));
+                if (ref.count(key))
+                    CHECK(fm.at(key) == key + 1);
+                std::set<int>::iterator slo = ref_keys.lower_bound(key);
+                std::set<int>::iterator sup = ref_keys.upper_bound(key);
+                CHECK(fs.count(key) == ref_keys.count(key));
+                CHECK((fs.lower_bound(key) == fs.end()) == (slo == ref_keys.end()));
+                CHECK(fs.lower_bound(key) == fs.end() || *fs.lower_bound(key) == *slo);
+                CHECK((fs.upper_bound(key) == fs.end()) == (sup == ref_keys.end()));
+                CHECK(fs.upper_bound(key) == fs.end() || *fs.upper_bound(key) == *sup);
+            }
+        }
+
+        std::vector<fragile> values;
+        std::vector<ft::pair<fragile, fragile> > pairs;
+        for (int i = 0; i < 50; ++i) {
+            values.push_back(fragile(i));
+            pairs.push_back(ft::make_pair(fragile(i), fragile(-i)));
+        }
+        const int before = fragile::live;
+        ft::frozen_set<fragile> fs(values.begin(), values.begin() + 3);
+        ft::frozen_set<fragile> whole(values.begin(), values.end());
+        ft::frozen_map<fragile, fragile> fm(pairs.begin(), pairs.begin() + 3);
+        ft::frozen_map<fragile, fragile> whole_map(pairs.begin(), pairs.end());
+        const int built = fragile::live;
+        for (int fail = 0; fail < 100; fail += 7) {
+            fragile::copies_left = fail % 50;
+            try {
+                ft::frozen_set<fragile> broken(values.begin(), values.end());
+                CHECK(false);
+            } catch (const std::runtime_error &) {}
+            CHECK(fragile::live == built);
+            fragile::copies_left = fail;
+            try {
+                ft::frozen_map<fragile, fragile> broken(pairs.begin(), pairs.end());
+                CHECK(false);
+            } catch (const std::runtime_error &) {}
+            CHECK(fragile::live == built);
+            fragile::copies_left = fail % 50;
+            try {
+                fs = whole;
+                CHECK(false);
+            } catch (const std::runtime_error &) {}
+            fragile::copies_left = fail;
+            try {
+                fm = whole_map;
+                CHECK(false);
+            } catch (const std::runtime_error &) {}
+            fragile::copies_left = -1;
+            CHECK(fragile::live == built && fs.size() == 3 && fm.size() == 3);
+            CHECK((*fs.begin()).value == 0 && (*--fs.end()).value == 2 && (*--fm.end()).second.value == -2);
+        }
+        fs = whole;
+        fm = whole_map;
+        CHECK(fs.size() == 50 && fm.size() == 50 && fm.find(fragile(49)) != fm.end());
+        fs.clear();
+        fm.clear();
+        whole.clear();
+        whole_map.clear();
+        CHECK(fragile::live == before);
+    }
+
+    // Random edits against std::vector with strings, so the non-trivial storage is exercised; every
+    // operation that would pass the capacity must throw before touching the contents.
+    void test_static_vector() {
+        typedef ft::static_vector<std::string, 64> fixed;
+        static_assert(!std::is_trivially_copyable<fixed>::value, "");
+        fixed v;
+        std::vector<std::string> ref;
+
+        std::srand(seed_value);
+        for (int i = 0; i < 40000; ++i) {
+            std::string s(std::rand() % 24, static_cast<char>('a' + i % 26));
+            size_t at = std::rand() % (ref.size() + 1);
+            size_t n = std::rand() % 8;
+            bool fits = ref.size() + n <= 64;
+            switch (std::rand() % 9) {
+                case 0:
+                case 1:
+                    if (ref.size() < 64) {
+                        v.push_back(s);
+                        ref.push_back(s);
+                    } else {
+                        try {
+                            v.push_back(s);
+                            CHECK(false);
+                        } catch (const std::length_error &) {}
+                    }
+                    break;
+                case 2:
+                    v.pop_back();
+                    if (!ref.empty())
+                        ref.pop_back();
+                    break;
+                case 3:
+                    if (ref.size() < 64) {
+                        CHECK(*v.insert(v.begin() + at, s) == s);
+                        ref.insert(ref.begin() + at, s);
+                    }
+                    break;
+                case 4:
+                    try {
+                        v.insert(v.begin() + at, n, s);
+                        CHECK(fits);
+                        ref.insert(ref.begin() + at, n, s);
+                    } catch (const std::length_error &) {
+                        CHECK(!fits);
+                    }
+                    break;
+                case 5: {
+                    std::vector<std::string> in(n, s);
+                    try {
+                        v.insert(v.begin() + at, in.begin(), in.end());
+                        CHECK(fits);
+                        ref.insert(ref.begin() + at, in.begin(), in.end());
+                    } catch (const std::length_error &) {
+                        CHECK(!fits);
+                    }
+                    break;
+                }
+                case 6:
+                    if (at < ref.size()) {
+                        size_t end = at + std::rand() % (ref.size() - at + 1);
+                        CHECK(v.erase(v.begin() + at, v.begin() + end) == v.begin() + at);
+                        ref.erase(ref.begin() + at, ref.begin() + end);
+                    }
+                    break;
+                case 7: {
+                    size_t size = std::rand() % 70;
+                    try {
+                        v.resize(size, s);
+                        CHECK(size <= 64);
+                        ref.resize(size, s);
+                    } catch (const std::length_error &) {
+                        CHECK(size > 64);
+                    }
+                    break;
+                }
+                default: {
+                    fixed copy(v);
+                    fixed other(3, s);
+                    CHECK(copy == v && same_sequence(copy, ref));
+                    copy.swap(other);
+                    CHECK(same_sequence(other, ref) && copy.size() == 3);
+                    v = copy;
+                    v = other;
+                    CHECK(!(v != other));
+                }
+            }
+            CHECK(same_sequence(v, ref));
+            CHECK(v.full() == (ref.size() == 64));
+        }
+        try {
+            v.reserve(65);
+            CHECK(false);
+        } catch (const std::length_error &) {}
+        try {
+            v.at(v.size());
+            CHECK(false);
+        } catch (const std::out_of_range &) {}
+
+        ft::static_vector<int, 8> a(5, 7);
+        ft::static_vector<int, 8> b;
+        std::memcpy(static_cast<void *>(&b), &a, sizeof(a));
+        CHECK(b == a && b.size() == 5 && b.back() == 7);
+        ft::static_vector<int, 4, ft::overflow_unchecked> unchecked;
+        unchecked.reserve(100);
+        CHECK(unchecked.capacity() == 4 && unchecked.empty());
+    }
+
+    // Addresses taken while growing must still hold their elements after many more chunks are added,
+    // popping to empty must give every chunk back, and a throwing copy at a chunk boundary or inside
+    // a copy must leave nothing alive and the assignment target unchanged.
+    void test_segmented_vector() {
+        typedef ft::segmented_vector<std::string, 4> strings;
+        strings v;
+        std::vector<std::string> ref;
+        std::vector<const std::string *> addresses;
+
+        for (int round = 0; round < 3; ++round) {
+            for (int i = 0; i < 1000; ++i) {
+                v.push_back(std::string(i % 30, static_cast<char>('a' + round)));
+                ref.push_back(v.back());
+                addresses.push_back(&v.back());
+                if (i % 97 == 0)
+                    for (size_t k = 0; k < addresses.size(); ++k)
+                        CHECK(addresses[k] == &v[k] && *addresses[k] == ref[k]);
+            }
+            CHECK(same_sequence(v, ref) && v.capacity() == (ref.size() + 15) / 16 * 16);
+            strings copy(v);
+            CHECK(copy == v);
+            while (!v.empty()) {
+                v.pop_back();
+                ref.pop_back();
+                addresses.pop_back();
+                CHECK(v.capacity() == (ref.size() + 15) / 16 * 16);
+            }
+            v.pop_back();
+            CHECK(v.empty() && v.capacity() == 0 && v.begin() == v.end());
+            v = copy;
+            CHECK(v == copy);
+            v.resize(0);
+            CHECK(v.capacity() == 0);
+        }
+
+        typedef ft::segmented_vector<fragile, 3> fragiles;
+        const int before = fragile::live;
+        {
+            fragiles f;
+            fragiles other;
+            for (int i = 0; i < 8; ++i)
+                f.push_back(fragile(i));
+            other.push_back(fragile(-1));
+            const int built = fragile::live;
+            fragile::copies_left = 0;
+            try {
+                f.push_back(fragile(8));
+                CHECK(false);
+            } catch (const std::runtime_error &) {}
+            CHECK(fragile::live == built && f.size() == 8 && f.capacity() == 8);
+            for (int fail = 0; fail < 8; ++fail) {
+                fragile::copies_left = fail;
+                try {
+                    fragiles broken(f);
+                    CHECK(false);
+                } catch (const std::runtime_error &) {}
+                CHECK(fragile::live == built);
+                fragile::copies_left = fail;
+                try {
+                    other = f;
+                    CHECK(false);
+                } catch (const std::runtime_error &) {}
+                CHECK(fragile::live == built && other.size() == 1 && other[0].value == -1);
+            }
+            fragile::copies_left = -1;
+            f.push_back(fragile(8));
+            other = f;
+            CHECK(other.size() == 9 && other.back().value == 8 && other.capacity() == 16);
+        }
+        CHECK(fragile::live == before);
+    }
+
+    // Copies that throw part way through each constructor; whatever was built, header node included,
+    // must be released again.
+    void test_map_set_construction_throws() {
+        std::vector<fragile> keys;
+        std::vector<fragile> ordered;
+        std::vector<ft::pair<fragile, int> > pairs;
+        ft::thread_pool pool(2);
+
+        for (int i = 0; i < 300; ++i) {
+            keys.push_back(fragile((i * 7919) % 300));
+            ordered.push_back(fragile(i));
+            pairs.push_back(ft::make_pair(keys.back(), i));
+        }
+        const int before = fragile::live;
+        for (int fail = 0; fail < 600; fail += 37) {
+            for (int kind = 0; kind < 7; ++kind) {
+                fragile::copies_left = fail;
+                try {
+                    switch (kind) {
+                        case 0: { ft::set<fragile> s(keys.begin(), keys.end()); break; }
+                        case 1: { ft::set<fragile> s(keys.begin(), keys.end(), pool); break; }
+                        case 2: { ft::set<fragile> s(keys.begin(), keys.end(), ft::keep_last); break; }
+                        case 3: { ft::map<fragile, int> m(pairs.begin(), pairs.end(), ft::keep_last); break; }
+                        case 4: { ft::map<fragile, int> m(pairs.begin(), pairs.end(), pool); break; }
+                        case 5: { ft::set<fragile> s(ft::sorted_input, ordered.begin(), ordered.end()); break; }
+                        default: {
+                            fragile::copies_left = -1;
+                            ft::map<fragile, int> m(pairs.begin(), pairs.end());
+                            fragile::copies_left = fail;
+                            ft::map<fragile, int> copy(m);
+                        }
+                    }
+                } catch (const std::runtime_error &) {}
+                fragile::copies_left = -1;
+                CHECK(fragile::live == before);
+            }
+        }
+    }
+
+    struct sort_record{
+        int key;
+        int seq;
+    };
+
+    bool key_less(const sort_record &a, const sort_record &b) {
+        return a.key < b.key;
+    }
+
+    bool same_records(const std::vector<sort_record> &a, const std::vector<sort_record> &b) {
+        for (size_t i = 0; i < a.size(); ++i)
+            if (a[i].key != b[i].key || a[i].seq != b[i].seq)
+                return false;
+        return a.size() == b.size();
+    }
+
+    // One arithmetic type through every path: radix (ft::vector, pointers, default order) and
+    // comparison (std::vector iterators, or std::greater) against std::sort.
+    template <class T>
+    void check_sort(const std::vector<T> &in) {
+        std::vector<T> expected(in);
+        std::vector<T> greater(in);
+        std::sort(expected.begin(), expected.end());
+        std::sort(greater.begin(), greater.end(), std::greater<T>());
+
+        ft::vector<T> v(in.begin(), in.end());
+        ft::sort(v.begin(), v.end());
+        CHECK(std::equal(expected.begin(), expected.end(), v.begin()));
+        v.assign(in.begin(), in.end());
+        ft::stable_sort(v.begin(), v.end());
+        CHECK(std::equal(expected.begin(), expected.end(), v.begin()));
+        v.assign(in.begin(), in.end());
+        ft::sort(v.begin(), v.end(), std::greater<T>());
+        CHECK(std::equal(greater.begin(), greater.end(), v.begin()));
+
+        std::vector<T> s(in);
+        ft::sort(s.begin(), s.end());
+        CHECK(s == expected);
+        s = in;
+        if (!s.empty())
+            ft::stable_sort(&s[0], &s[0] + s.size());
+        CHECK(s == expected);
+        s = in;
+        ft::stable_sort(s.begin(), s.end(), std::greater<T>());
+        CHECK(s == greater);
+    }
+
+    // Sizes on both sides of the insertion and radix thresholds; stable_sort must keep equal keys in
+    // input order; parallel_sort runs on an explicit pool, large enough to split into leaves.
+    void test_sort() {
+        const size_t sizes[] = {0, 1, 2, 15, 16, 17, 100, 255, 256, 257, 1000, 10000};
+
+        std::srand(seed_value);
+        for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s) {
+            std::vector<int> ints;
+            std::vector<unsigned long long> words;
+            std::vector<double> doubles;
+            std::vector<sort_record> records;
+            for (size_t i = 0; i < sizes[s]; ++i) {
+                ints.push_back(std::rand() % 2001 - 1000);
+                words.push_back(static_cast<unsigned long long>(std::rand()) << (std::rand() % 40));
+                doubles.push_back(i % 50 == 7 ? -0.0 : (std::rand() % 20001 - 10000) / 7.0);
+                sort_record r = {std::rand() % 8, static_cast<int>(i)};
+                records.push_back(r);
+            }
+            if (sizes[s] > 3) {
+                ints[0] = -2147483647 - 1;
+                ints[1] = 2147483647;
+                words[2] = ~0ULL;
+                doubles[3] = -1e300;
+            }
+            check_sort(ints);
+            check_sort(words);
+            check_sort(doubles);
+
+            std::vector<sort_record> expected(records);
+            std::stable_sort(expected.begin(), expected.end(), key_less);
+            std::vector<sort_record> got(records);
+            ft::stable_sort(got.begin(), got.end(), key_less);
+            CHECK(same_records(got, expected));
+            ft::vector<sort_record> contiguous(records.begin(), records.end());
+            ft::stable_sort(contiguous.begin(), contiguous.end(), key_less);
+            CHECK(same_records(std::vector<sort_record>(contiguous.begin(), contiguous.end()), expected));
+        }
+
+        ft::thread_pool pool(4);
+        std::vector<int> big;
+        std::vector<std::string> strings;
+        for (int i = 0; i < 200000; ++i)
+            big.push_back(std::rand() - RAND_MAX / 2);
+        for (int i = 0; i < 40000; ++i)
+            strings.push_back(std::string(std::rand() % 6, static_cast<char>('a' + std::rand() % 4)));
+        std::vector<int> expected(big);
+        std::sort(expected.begin(), expected.end());
+        ft::vector<int> v(big.begin(), big.end());
+        ft::parallel_sort(v.begin(), v.end(), ft::less<int>(), pool);
+        CHECK(std::equal(expected.begin(), expected.end(), v.begin()));
+        std::vector<int> copy(big);
+        ft::parallel_sort(copy.begin(), copy.end(), std::greater<int>(), pool);
+        CHECK(std::equal(expected.rbegin(), expected.rend(), copy.begin()));
+        std::deque<int> d(big.begin(), big.end());
+        ft::parallel_sort(d.begin(), d.end(), ft::less<int>(), pool);
+        CHECK(std::equal(expected.begin(), expected.end(), d.begin()));
+        std::vector<std::string> sorted_strings(strings);
+        std::sort(sorted_strings.begin(), sorted_strings.end());
+        ft::parallel_sort(&strings[0], &strings[0] + strings.size(), ft::less<std::string>(), pool);
+        CHECK(strings == sorted_strings);
+    }
+
+    struct value_sum{
+        long long operator()(long long acc, const ft::pair<const int, int> &x) const {
+            return acc + x.second;
+        }
+    };
+
+    // One policy over a vector, over sub-ranges of a map and of a set, each result against the
+    // sequential std algorithm on a copy of the same elements.
+    template <class Policy>
+    void check_algorithms(const Policy &policy) {
+        ft::vector<int> v;
+        for (int i = 0; i < 100000; ++i)
+            v.push_back(std::rand() % 100000 - 50000);
+        std::vector<int> ref(v.begin(), v.end());
+
+        ft::for_each(policy, v.begin(), v.end(), [](int &x) { x += 3; });
+        for (size_t i = 0; i < ref.size(); ++i)
+            ref[i] += 3;
+        CHECK(std::equal(ref.begin(), ref.end(), v.begin()));
+        std::vector<long> doubled(v.size());
+        CHECK(ft::transform(policy, v.begin(), v.end(), doubled.begin(), [](int x) { return 2L * x; }) == doubled.end());
+        for (size_t i = 0; i < ref.size(); ++i)
+            CHECK(doubled[i] == 2L * ref[i]);
+        long long sum = 0;
+        long long squares = 0;
+        for (size_t i = 0; i < ref.size(); ++i) {
+            sum += ref[i];
+            squares += static_cast<long long>(ref[i]) * ref[i];
+        }
+        CHECK(ft::reduce(policy, v.begin(), v.end(), 7LL) == sum + 7);
+        CHECK(ft::reduce(policy, &v[0], &v[0] + 5000, 0LL) == std::accumulate(ref.begin(), ref.begin() + 5000, 0LL));
+        CHECK(ft::transform_reduce(policy, v.begin(), v.end(), 0LL, std::plus<long long>(),
+                                   [](int x) { return static_cast<long long>(x) * x; }) == squares);
+        CHECK(ft::transform_reduce(policy, ft::span<int>(v), 1LL, std::plus<long long>(),
+                                   [](int x) { return static_cast<long long>(x) * x; }) == squares + 1);
+        CHECK(ft::count_if(policy, v.begin(), v.end(), [](int x) { return x % 3 == 0; })
+              == std::count_if(ref.begin(), ref.end(), [](int x) { return x % 3 == 0; }));
+        const int needle = ref[ref.size() * 3 / 4];
+        CHECK(ft::find_if(policy, v.begin(), v.end(), [needle](int x) { return x == needle; }) - v.begin()
+              == std::find(ref.begin(), ref.end(), needle) - ref.begin());
+        CHECK(ft::find_if(policy, v.begin(), v.end(), [](int x) { return x > 60000; }) == v.end());
+
+        ft::map<int, int> m;
+        std::map<int, int> mref;
+        ft::set<int> s;
+        std::set<int> sref;
+        for (int i = 0; i < 20000; ++i) {
+            int key = std::rand() % 60000;
+            m[key] = i;
+            mref[key] = i;
+            s.insert(key);
+            sref.insert(key);
+        }
+        for (int round = 0; round < 12; ++round) {
+            int lo = round == 0 ? -1 : std::rand() % 60000;
+            int hi = round == 0 ? 60000 : round == 1 ? lo : lo + std::rand() % (60000 - lo);
+            ft::map<int, int>::iterator first = m.lower_bound(lo);
+            ft::map<int, int>::iterator last = m.lower_bound(hi);
+            std::map<int, int>::iterator rfirst = mref.lower_bound(lo);
+            std::map<int, int>::iterator rlast = mref.lower_bound(hi);
+            const size_t n = std::distance(rfirst, rlast);
+
+            ft::for_each(policy, first, last, [](ft::pair<const int, int> &x) { x.second += 1; });
+            long long values = 0;
+            long long keys = 0;
+            for (std::map<int, int>::iterator it = rfirst; it != rlast; ++it) {
+                it->second += 1;
+                values += it->second;
+                keys += it->first;
+            }
+            CHECK(same_map(m, mref));
+            std::vector<int> out(n);
+            CHECK(ft::transform(policy, first, last, out.begin(), [](const ft::pair<const int, int> &x) { return x.first; }) == out.end());
+            CHECK(std::equal(out.begin(), out.end(), sref.lower_bound(lo)));
+            CHECK(ft::reduce(policy, first, last, 0LL, value_sum()) == values);
+            CHECK(ft::transform_reduce(policy, first, last, 0LL, std::plus<long long>(),
+                                       [](const ft::pair<const int, int> &x) { return static_cast<long long>(x.second); }) == values);
+            CHECK(static_cast<size_t>(ft::count_if(policy, first, last, [](const ft::pair<const int, int> &x) { return x.second % 2 == 0; }))
+                  == static_cast<size_t>(std::count_if(rfirst, rlast, [](const std::pair<const int, int> &x) { return x.second % 2 == 0; })));
+            ft::map<int, int>::iterator found = ft::find_if(policy, first, last, [](const ft::pair<const int, int> &x) { return x.second % 7 == 0; });
+            std::map<int, int>::iterator rfound = std::find_if(rfirst, rlast, [](const std::pair<const int, int> &x) { return x.second % 7 == 0; });
+            CHECK((found == last) == (rfound == rlast) && (found == last || found->first == rfound->first));
+
+            ft::set<int>::iterator sfirst = s.lower_bound(lo);
+            ft::set<int>::iterator slast = s.lower_bound(hi);
+            CHECK(ft::reduce(policy, sfirst, slast, 0LL) == keys);
+            CHECK(static_cast<size_t>(ft::count_if(policy, sfirst, slast, [](int x) { return x % 5 == 1; }))
+                  == static_cast<size_t>(std::count_if(sref.lower_bound(lo), sref.lower_bound(hi), [](int x) { return x % 5 == 1; })));
+            std::vector<int> keys_out(n);
+            ft::transform(policy, sfirst, slast, keys_out.begin(), [](int x) { return x; });
+            CHECK(std::equal(keys_out.begin(), keys_out.end(), out.begin()));
+            ft::set<int>::iterator sfound = ft::find_if(policy, sfirst, slast, [hi](int x) { return x > hi - 100; });
+            std::set<int>::iterator rsfound = std::find_if(sref.lower_bound(lo), sref.lower_bound(hi), [hi](int x) { return x > hi - 100; });
+            CHECK((sfound == slast) == (rsfound == sref.lower_bound(hi)) && (sfound == slast || *sfound == *rsfound));
+        }
+    }
+
+    void test_execution_policies() {
+        std::srand(seed_value);
+        check_algorithms(ft::execution::seq);
+        check_algorithms(ft::execution::par);
+        check_algorithms(ft::execution::par_unseq);
+    }
+
+    template <class Policy>
+    void check_span_algorithms(const Policy &policy, const ft::span<int> &s, const std::vector<int> &ref) {
+        long long sum = std::accumulate(ref.begin(), ref.end(), 0LL);
+
+        CHECK(ft::reduce(policy, s, 0LL) == sum);
+        CHECK(ft::reduce(policy, s, 0LL, std::plus<long long>()) == sum);
+        CHECK(ft::transform_reduce(policy, s, 0LL, std::plus<long long>(), [](int x) { return 2LL * x; }) == 2 * sum);
+        CHECK(static_cast<size_t>(ft::count_if(policy, s, [](int x) { return x % 3 == 0; }))
+              == static_cast<size_t>(std::count_if(ref.begin(), ref.end(), [](int x) { return x % 3 == 0; })));
+        ft::span<int>::iterator found = ft::find_if(policy, s, [](int x) { return x > 900; });
+        std::vector<int>::const_iterator rfound = std::find_if(ref.begin(), ref.end(), [](int x) { return x > 900; });
+        CHECK(found - s.begin() == rfound - ref.begin());
+        std::vector<int> out(s.size());
+        CHECK(ft::transform(policy, s, out.begin(), [](int x) { return x + 1; }) == out.end());
+        for (size_t i = 0; i < out.size(); ++i)
+            CHECK(out[i] == ref[i] + 1);
+        ft::for_each(policy, s, [](int &x) { x += 1; });
+        ft::for_each(policy, s, [](int &x) { x -= 1; });
+        CHECK(std::equal(s.begin(), s.end(), ref.begin()));
+    }
+
+    // Every way to make a span, slicing with fixed and runtime counts, and the span forms of the
+    // algorithms against the same work done over a std::vector.
+    void test_span() {
+        ft::vector<int> v;
+        std::vector<int> ref;
+
+        std::srand(seed_value);
+        for (int i = 0; i < 5000; ++i) {
+            v.push_back(std::rand() % 1000);
+            ref.push_back(v.back());
+        }
+        ft::span<int> s(v);
+        CHECK(s.data() == &v[0] && s.size() == v.size() && s.size_bytes() == v.size() * sizeof(int));
+        s[3] = -1;
+        CHECK(v[3] == -1);
+        s[3] = ref[3];
+        const ft::vector<int> &cv = v;
+        ft::span<const int> cs(cv);
+        CHECK(cs.data() == s.data() && cs.size() == s.size() && ft::span<const int>(s).data() == s.data());
+        CHECK(ft::make_span(v).size() == v.size() && ft::make_span(cv).data() == cs.data());
+        ft::vector<int> none;
+        CHECK(ft::span<int>(none).empty() && !ft::span<int>(none).data());
+
+        int *p = &v[0];
+        CHECK(ft::span<int>(p, 0).empty() && ft::span<int>(p, 0).data() == p);
+        CHECK(ft::span<int>(p, p + 10).size() == 10 && ft::make_span(p, 10).size() == 10);
+        CHECK((ft::span<int, 10>(p, 10).size() == 10 && sizeof(ft::span<int, 10>) == sizeof(int *)));
+
+        int array[6] = {5, 4, 3, 2, 1, 0};
+        ft::span<int, 6> fixed(array);
+        ft::span<int> dynamic(array);
+        CHECK(fixed.size() == 6 && dynamic.size() == 6 && ft::make_span(array).data() == array);
+        ft::span<int, 6> back(dynamic);
+        CHECK(back.data() == array);
+        try {
+            ft::span<int, 5> wrong(dynamic);
+            CHECK(false);
+        } catch (const std::length_error &) {}
+        CHECK(ft::as_bytes(fixed).size() == sizeof(array) && ft::as_writable_bytes(dynamic).size() == sizeof(array));
+
+        ft::static_vector<int, 8> sv;
+        for (int i = 0; i < 5; ++i)
+            sv.push_back(i * i);
+        const ft::static_vector<int, 8> &csv = sv;
+        CHECK(ft::span<int>(sv).size() == 5 && ft::span<int>(sv).data() == sv.data() && ft::span<const int>(csv)[4] == 16);
+
+        static_assert(std::is_same<decltype(fixed.first<2>()), ft::span<int, 2> >::value, "first<2> has extent 2");
+        static_assert(std::is_same<decltype(fixed.subspan<2>()), ft::span<int, 4> >::value, "subspan<2> of 6 has extent 4");
+        static_assert(std::is_same<decltype(fixed.subspan<1, 3>()), ft::span<int, 3> >::value, "subspan<1, 3> has extent 3");
+        static_assert(std::is_same<decltype(dynamic.subspan<2>()), ft::span<int> >::value, "subspan<2> of a dynamic span is dynamic");
+        CHECK((fixed.first<2>()[1] == 4 && fixed.last<2>()[0] == 1 && fixed.subspan<2>()[0] == 3 && fixed.subspan<1, 3>().back() == 2));
+        CHECK(dynamic.first<6>().size() == 6 && dynamic.last<0>().empty() && dynamic.subspan<6>().empty());
+        CHECK(dynamic.first(3).back() == 3 && dynamic.last(3).front() == 2 && dynamic.subspan(2, 2).size() == 2
+              && dynamic.subspan(4).size() == 2 && dynamic.subspan(6).empty());
+        CHECK(fixed.at(5) == 0 && *fixed.rbegin() == 0 && fixed.end() - fixed.begin() == 6);
+        int throws = 0;
+        try { dynamic.first<7>(); } catch (const std::out_of_range &) { ++throws; }
+        try { dynamic.last<7>(); } catch (const std::out_of_range &) { ++throws; }
+        try { dynamic.subspan<7>(); } catch (const std::out_of_range &) { ++throws; }
+        try { dynamic.subspan<4, 3>(); } catch (const std::out_of_range &) { ++throws; }
+        try { dynamic.first(7); } catch (const std::out_of_range &) { ++throws; }
+        try { dynamic.last(7); } catch (const std::out_of_range &) { ++throws; }
+        try { dynamic.subspan(7); } catch (const std::out_of_range &) { ++throws; }
+        try { dynamic.subspan(3, 4); } catch (const std::out_of_range &) { ++throws; }
+        try { fixed.at(6); } catch (const std::out_of_range &) { ++throws; }
+        CHECK(throws == 9);
+
+        check_span_algorithms(ft::execution::seq, s, ref);
+        check_span_algorithms(ft::execution::par, s, ref);
+        ft::span<int> window = s.subspan(100, 3000);
+        CHECK(ft::reduce(window, 0LL) == std::accumulate(ref.begin() + 100, ref.begin() + 3100, 0LL));
+        CHECK(ft::transform_reduce(window, 0LL, std::plus<long long>(), [](int x) { return static_cast<long long>(x); })
+              == ft::reduce(window, 0LL, std::plus<long long>()));
+        CHECK(ft::count_if(window, [](int x) { return x < 0; }) == 0 && ft::find_if(window, [](int x) { return x < 0; }) == window.end());
+        int seen = 0;
+        ft::for_each(window, [&seen](int) { ++seen; });
+        std::vector<int> copy(window.size());
+        ft::transform(window, copy.begin(), [](int x) { return x; });
+        CHECK(seen == 3000 && std::equal(copy.begin(), copy.end(), ref.begin() + 100));
+        ft::sort(window);
+        std::sort(ref.begin() + 100, ref.begin() + 3100);
+        CHECK(std::equal(s.begin(), s.end(), ref.begin()));
+        ft::sort(s, std::greater<int>());
+        std::sort(ref.begin(), ref.end(), std::greater<int>());
+        CHECK(std::equal(s.begin(), s.end(), ref.begin()));
+    }
+
+    unsigned long long random_word() {
+        return (static_cast<unsigned long long>(std::rand()) << 42) ^ (static_cast<unsigned long long>(std::rand()) << 21)
+            ^ static_cast<unsigned long long>(std::rand());
+    }
+
+    template <unsigned Bits, class Ref>
+    bool same_packed(const ft::packed_vector<Bits> &v, const Ref &ref) {
+        if (v.size() != ref.size() || !std::equal(v.begin(), v.end(), ref.begin()))
+            return false;
+        for (size_t i = 0; i < ref.size(); ++i)
+            if (v[i] != ref[i] || v.at(i) != ref[i])
+                return false;
+        return true;
+    }
+
+    // Random edits against a std::vector of the same values. Shrinking and growing again must bring
+    // back zeros, so the bits a shrink leaves behind have to be cleared.
+    template <unsigned Bits, class Ref>
+    void check_packed_vector() {
+        typedef ft::packed_vector<Bits> packed;
+        typedef typename packed::value_type value_type;
+        const value_type top = static_cast<value_type>(ft::packed_detail::mask(Bits));
+        packed v;
+        Ref ref;
+
+        for (int i = 0; i < 20000; ++i) {
+            value_type val = static_cast<value_type>(random_word()) & top;
+            switch (std::rand() % 10) {
+                case 0:
+                    if (!ref.empty()) {
+                        size_t n = std::rand() % ref.size();
+                        v.set(n, val);
+                        ref[n] = val;
+                    }
+                    break;
+                case 1:
+                case 2:
+                    if (!ref.empty()) {
+                        v.pop_back();
+                        ref.pop_back();
+                    }
+                    break;
+                case 3:
+                    if (std::rand() % 20 == 0) {
+                        size_t shrink = ref.size() / 2 + (ref.empty() ? 0 : std::rand() % (ref.size() / 2 + 1));
+                        size_t grow = shrink + std::rand() % 200;
+                        v.resize(shrink);
+                        ref.resize(shrink);
+                        v.resize(grow);
+                        ref.resize(grow, 0);
+                        CHECK(same_packed(v, ref));
+                    }
+                    break;
+                case 4:
+                    if (std::rand() % 50 == 0) {
+                        size_t n = ref.size() + std::rand() % 100;
+                        v.resize(n, val);
+                        ref.resize(n, val);
+                    }
+                    break;
+                default:
+                    v.push_back(val);
+                    ref.push_back(val);
+            }
+            if (i % 1000 == 0)
+                CHECK(same_packed(v, ref));
+        }
+        CHECK(same_packed(v, ref));
+
+        ft::vector<value_type> batch;
+        for (int i = 0; i < 333; ++i)
+            batch.push_back(static_cast<value_type>(random_word()) & top);
+        v.append(ft::span<const value_type>(batch));
+        ref.insert(ref.end(), batch.begin(), batch.end());
+        CHECK(same_packed(v, ref));
+
+        ft::vector<value_type> out(ref.size());
+        for (int round = 0; round < 50; ++round) {
+            size_t first = std::rand() % (ref.size() + 1);
+            size_t count = std::rand() % (ref.size() - first + 1);
+            v.decode(first, ft::span<value_type>(&out[0], count));
+            CHECK(std::equal(out.begin(), out.begin() + count, ref.begin() + first));
+        }
+        v.decode(0, ft::span<value_type>(out));
+        CHECK(std::equal(out.begin(), out.end(), ref.begin()));
+        try {
+            v.decode(ref.size(), ft::span<value_type>(&out[0], 1));
+            CHECK(false);
+        } catch (const std::out_of_range &) {}
+
+        if (Bits < 64) {
+            const value_type wide = static_cast<value_type>(static_cast<unsigned long long>(top) + 1);
+            int throws = 0;
+            try { v.push_back(wide); } catch (const std::out_of_range &) { ++throws; }
+            try { v.set(0, wide); } catch (const std::out_of_range &) { ++throws; }
+            try { v.resize(ref.size() + 5, wide); } catch (const std::out_of_range &) { ++throws; }
+            batch.push_back(wide);
+            try { v.append(ft::span<const value_type>(batch)); } catch (const std::out_of_range &) { ++throws; }
+            CHECK(throws == 4 && same_packed(v, ref));
+        }
+        v.clear();
+        CHECK(v.empty() && v.begin() == v.end());
+    }
+
+    // Runs of one value fill whole blocks, which pack at width 0; the rest climb in small and large
+    // steps so block widths vary.
+    void check_delta_vector() {
+        ft::delta_vector<unsigned> d;
+        std::vector<unsigned> ref;
+        const size_t block = ft::delta_vector<unsigned>::block_size;
+        unsigned value = 7;
+
+        for (int i = 0; i < 6000; ++i) {
+            switch (i / 700 % 3) {
+                case 0:
+                    break;
+                case 1:
+                    value += std::rand() % 4;
+                    break;
+                default:
+                    value += std::rand() % 100000;
+            }
+            d.push_back(value);
+            ref.push_back(value);
+        }
+        CHECK(d.size() == ref.size() && std::equal(d.begin(), d.end(), ref.begin()) && d.back() == ref.back());
+        for (size_t i = 0; i < ref.size(); ++i)
+            CHECK(d[i] == ref[i]);
+        CHECK(ft::delta_vector<unsigned>(ref.begin(), ref.end()).size() == ref.size());
+
+        ft::delta_vector<unsigned> constant;
+        for (size_t i = 0; i < block; ++i)
+            constant.push_back(42);
+        const size_t one = constant.storage_bytes();
+        for (size_t i = 0; i < 2 * block; ++i)
+            constant.push_back(42);
+        CHECK(constant.storage_bytes() - 2 * sizeof(unsigned long long) == 3 * (one - 2 * sizeof(unsigned long long)));
+        CHECK(constant[3 * block - 1] == 42 && constant.lower_bound(42) == constant.begin() && constant.lower_bound(43) == constant.end());
+
+        std::vector<unsigned> probes;
+        for (size_t b = 0; b * block < ref.size(); ++b)
+            for (int k = -1; k <= 1; ++k) {
+                probes.push_back(ref[b * block] + k);
+                probes.push_back(ref[b * block + block - 1 < ref.size() ? b * block + block - 1 : ref.size() - 1] + k);
+            }
+        for (int i = 0; i < 500; ++i)
+            probes.push_back(std::rand() % (ref.back() + 2));
+        for (size_t i = 0; i < probes.size(); ++i) {
+            ft::delta_vector<unsigned>::const_iterator it = d.lower_bound(probes[i]);
+            std::vector<unsigned>::iterator rit = std::lower_bound(ref.begin(), ref.end(), probes[i]);
+            CHECK(it.index() == static_cast<size_t>(rit - ref.begin()));
+            CHECK(d.contains(probes[i]) == std::binary_search(ref.begin(), ref.end(), probes[i]));
+        }
+
+        // The open block holds size() % block values; decode from inside the last sealed block.
+        std::vector<unsigned> out(ref.size());
+        size_t sealed = ref.size() / block * block;
+        size_t first = sealed - block / 2;
+        d.decode(first, ft::span<unsigned>(&out[0], ref.size() - first));
+        CHECK(sealed < ref.size() && std::equal(out.begin(), out.begin() + (ref.size() - first), ref.begin() + first));
+        for (int round = 0; round < 50; ++round) {
+            size_t from = std::rand() % (ref.size() + 1);
+            size_t count = std::rand() % (ref.size() - from + 1);
+            d.decode(from, ft::span<unsigned>(&out[0], count));
+            CHECK(std::equal(out.begin(), out.begin() + count, ref.begin() + from));
+        }
+        try {
+            d.decode(1, ft::span<unsigned>(&out[0], ref.size()));
+            CHECK(false);
+        } catch (const std::out_of_range &) {}
+
+        try {
+            d.push_back(ref.back() - 1);
+            CHECK(false);
+        } catch (const std::invalid_argument &) {}
+        CHECK(d.size() == ref.size() && d.back() == ref.back());
+        d.clear();
+        CHECK(d.empty());
+    }
+
+    void test_packed_delta_vector() {
+        std::srand(seed_value);
+        check_packed_vector<1, std::vector<unsigned> >();
+        check_packed_vector<13, std::vector<unsigned> >();
+        check_packed_vector<64, std::vector<unsigned long long> >();
+        check_delta_vector();
+    }
+
+    // Besides the values: count and find agree with them, and the bits past size() in the last
+    // word are clear, which count, == and the bitwise operators rely on.
+    bool same_bits(const ft::vector<bool> &v, const std::vector<bool> &ref) {
+        if (v.size() != ref.size() || v.count() != static_cast<size_t>(std::count(ref.begin(), ref.end(), true)))
+            return false;
+        if (v.size() % 64 && v.words()[v.size() / 64] >> (v.size() % 64))
+            return false;
+        if (!std::equal(v.begin(), v.end(), ref.begin()))
+            return false;
+        size_t pos = v.find_first();
+        for (size_t i = 0; i < ref.size(); ++i) {
+            if (v[i] != ref[i])
+                return false;
+            if (ref[i]) {
+                if (pos != i)
+                    return false;
+                pos = v.find_next(pos);
+            }
+        }
+        return pos == ft::vector<bool>::npos;
+    }
+
+    void test_vector_bool() {
+        ft::vector<bool> v;
+        std::vector<bool> ref;
+
+        std::srand(seed_value);
+        CHECK(v.find_first() == ft::vector<bool>::npos && v.count() == 0);
+        for (int i = 0; i < 20000; ++i) {
+            bool bit = std::rand() % 3 == 0;
+            size_t at = ref.empty() ? 0 : std::rand() % ref.size();
+            switch (std::rand() % 12) {
+                case 0:
+                    v.insert(v.begin() + at, bit);
+                    ref.insert(ref.begin() + at, bit);
+                    break;
+                case 1: {
+                    size_t n = std::rand() % 130;
+                    v.insert(v.begin() + at, n, bit);
+                    ref.insert(ref.begin() + at, n, bit);
+                    break;
+                }
+                case 2: {
+                    std::vector<bool> range(std::rand() % 100);
+                    for (size_t k = 0; k < range.size(); ++k)
+                        range[k] = std::rand() % 2;
+                    v.insert(v.begin() + at, range.begin(), range.end());
+                    ref.insert(ref.begin() + at, range.begin(), range.end());
+                    break;
+                }
+                case 3:
+                    if (!ref.empty()) {
+                        ft::vector<bool>::iterator next = v.erase(v.begin() + at);
+                        CHECK(next == v.begin() + at);
+                        ref.erase(ref.begin() + at);
+                    }
+                    break;
+                case 4: {
+                    size_t n = std::rand() % (ref.size() - at + 1);
+                    v.erase(v.begin() + at, v.begin() + at + n);
+                    ref.erase(ref.begin() + at, ref.begin() + at + n);
+                    break;
+                }
+                case 5: {
+                    size_t n = std::rand() % 2 ? at : ref.size() + std::rand() % 200;
+                    v.resize(n, bit);
+                    ref.resize(n, bit);
+                    break;
+                }
+                case 6:
+                    v.pop_back();
+                    if (!ref.empty())
+                        ref.pop_back();
+                    break;
+                case 7:
+                    if (std::rand() % 10 == 0) {
+                        v.flip();
+                        ref.flip();
+                    }
+                    break;
+                case 8:
+                    if (!ref.empty()) {
+                        v[at].flip();
+                        ref[at].flip();
+                        size_t other = std::rand() % ref.size();
+                        ft::vector<bool>::swap(v[at], v[other]);
+                        std::vector<bool>::swap(ref[at], ref[other]);
+                        v.at(other) = bit;
+                        ref[other] = bit;
+                    }
+                    break;
+                default:
+                    v.push_back(bit);
+                    ref.push_back(bit);
+            }
+            if (ref.size() % 64 && v.words()[ref.size() / 64] >> (ref.size() % 64))
+                CHECK(false);
+            if (i % 500 == 0)
+                CHECK(same_bits(v, ref));
+        }
+        CHECK(same_bits(v, ref));
+        CHECK(same_bits(ft::vector<bool>(v), ref) && ft::vector<bool>(v) == v);
+        try {
+            v.at(ref.size());
+            CHECK(false);
+        } catch (const std::out_of_range &) {}
+
+        for (size_t n = 0; n < 300; n += 37) {
+            ft::vector<bool> a, b;
+            std::vector<bool> ra, rb;
+            for (size_t i = 0; i < n; ++i) {
+                a.push_back(std::rand() % 2);
+                b.push_back(std::rand() % 2);
+                ra.push_back(a.back());
+                rb.push_back(b.back());
+            }
+            ft::vector<bool> x(a), y(a), z(a);
+            std::vector<bool> rx(n), ry(n), rz(n);
+            x &= b;
+            y |= b;
+            z ^= b;
+            for (size_t i = 0; i < n; ++i) {
+                rx[i] = ra[i] && rb[i];
+                ry[i] = ra[i] || rb[i];
+                rz[i] = ra[i] != rb[i];
+            }
+            CHECK(same_bits(x, rx) && same_bits(y, ry) && same_bits(z, rz));
+            z ^= z;
+            CHECK(z.count() == 0 && z.find_first() == ft::vector<bool>::npos);
+            z.flip();
+            CHECK(z.count() == n && (n ? z.find_first() == 0 && z.find_next(n - 1) == ft::vector<bool>::npos : true));
+
+            b.push_back(true);
+            int throws = 0;
+            try { x &= b; } catch (const std::invalid_argument &) { ++throws; }
+            try { y |= b; } catch (const std::invalid_argument &) { ++throws; }
+            try { z ^= b; } catch (const std::invalid_argument &) { ++throws; }
+            CHECK(throws == 3 && same_bits(x, rx) && same_bits(y, ry) && z.count() == n);
+        }
+    }
+
+    typedef ft::mmap_map<int, long> disk_map;
+
+    struct map_op{
+        int kind;
+        int key;
+        long value;
+    };
+
+    // A random insert, assignment or erase; half the erases walk forwards from the smallest key, the
+    // order that used to shrink the committed free list.
+    map_op next_op(unsigned &rng, const std::map<int, long> &ref) {
+        rng = rng * 1103515245u + 12345u;
+        map_op op = {static_cast<int>((rng >> 4) % 8), static_cast<int>((rng >> 8) % 4000), long(rng >> 1)};
+
+        if (op.kind >= 6 && !ref.empty())
+            op.key = ref.begin()->first;
+        return op;
+    }
+
+    void apply(std::map<int, long> &ref, const map_op &op) {
+        if (op.kind < 3)
+            ref.insert(std::make_pair(op.key, op.value));
+        else if (op.kind < 4)
+            ref[op.key] = op.value;
+        else
+            ref.erase(op.key);
+    }
+
+    template <class Map>
+    void apply(Map &m, std::map<int, long> &ref, const map_op &op) {
+        if (op.kind < 3)
+            CHECK(m.insert(ft::make_pair(op.key, op.value)) == !ref.count(op.key));
+        else if (op.kind < 4)
+            CHECK(m.insert_or_assign(op.key, op.value) == !ref.count(op.key));
+        else
+            CHECK(m.erase(op.key) == ref.count(op.key));
+        apply(ref, op);
+    }
+
+    template <class Map>
+    bool same_contents(const Map &m, const std::map<int, long> &ref) {
+        typename Map::const_iterator it = m.begin();
+
+        if (m.size() != ref.size())
+            return false;
+        for (std::map<int, long>::const_iterator r = ref.begin(); r != ref.end(); ++r, ++it)
+            if (it == m.end() || it->first != r->first || it->second != r->second)
+                return false;
+        return it == m.end();
+    }
+
+    // A forked writer checkpoints, keeps changing the map and is killed before the next checkpoint.
+    // The file must reopen at that checkpoint with a sound free list and keep working afterwards.
+    void test_mmap_map_crash() {
+        std::string path = temp_path("mmap_map");
+        std::map<int, long> ref;
+        unsigned rng = seed_value;
+
+        std::remove(path.c_str());
+        for (int round = 0; round < 8; ++round) {
+            int fds[2];
+            CHECK(pipe(fds) == 0);
+            pid_t child = fork();
+            CHECK(child >= 0);
+            if (!child) {
+                close(fds[0]);
+                disk_map m(path.c_str());
+                std::map<int, long> mirror = ref;
+                unsigned r = rng;
+                for (int i = 0; i < 3000; ++i)
+                    apply(m, mirror, next_op(r, mirror));
+                m.checkpoint();
+                size_t state[2] = {m.free_nodes(), static_cast<size_t>(r)};
+                if (write(fds[1], state, sizeof(state)) != static_cast<ssize_t>(sizeof(state)))
+                    _exit(2);
+                for (int i = 0; i < 2000 + round * 500; ++i)
+                    apply(m, mirror, next_op(r, mirror));
+                raise(SIGKILL);
+                _exit(3);
+            }
+            close(fds[1]);
+            size_t state[2];
+            CHECK(read(fds[0], state, sizeof(state)) == static_cast<ssize_t>(sizeof(state)));
+            close(fds[0]);
+            int status;
+            CHECK(waitpid(child, &status, 0) == child);
+            CHECK(WIFSIGNALED(status) && WTERMSIG(status) == SIGKILL);
+
+            // The reference replays only the writer's committed prefix.
+            for (int i = 0; i < 3000; ++i)
+                apply(ref, next_op(rng, ref));
+            CHECK(rng == static_cast<unsigned>(state[1]));
+
+            disk_map m(path.c_str());
+            CHECK(m.verify());
+            CHECK(same_contents(m, ref));
+            CHECK(m.free_nodes() == state[0]);
+            for (int i = 0; i < 2000; ++i)
+                apply(m, ref, next_op(rng, ref));
+            CHECK(m.verify());
+            CHECK(same_contents(m, ref));
+            m.checkpoint();
+            CHECK(m.verify());
+        }
+        {
+            disk_map m(path.c_str());
+            CHECK(m.verify());
+            CHECK(same_contents(m, ref));
+        }
+        std::remove(path.c_str());
+    }
+
+    struct record{
+        int key;
+        int tag;
+    };
+
+    struct record_greater{
+        bool operator()(const record &a, const record &b) const {
+            return a.key > b.key;
+        }
+    };
+
+    bool operator<(const record &a, const record &b) {
+        return a.key < b.key || (a.key == b.key && a.tag < b.tag);
+    }
+
+    // Writes in to a temporary file, sorts it into another and returns what came out.
+    template <class T, class Compare>
+    std::vector<T> external_sorted(const std::vector<T> &in, size_t budget, Compare comp, bool pipe_input) {
+        std::string in_path = temp_path("sort_in");
+        std::string out_path = temp_path("sort_out");
+        int out = open(out_path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        CHECK(out >= 0);
+        if (pipe_input) {
+            int fds[2];
+            CHECK(pipe(fds) == 0);
+            pid_t child = fork();
+            CHECK(child >= 0);
+            if (!child) {
+                close(fds[0]);
+                size_t bytes = in.size() * sizeof(T);
+                const char *p = reinterpret_cast<const char *>(in.empty() ? 0 : &in[0]);
+                for (ssize_t done; bytes; p += done, bytes -= done)
+                    if ((done = write(fds[1], p, bytes)) <= 0)
+                        _exit(2);
+                _exit(0);
+            }
+            close(fds[1]);
+            ft::external_sort<T>(fds[0], out, budget, comp);
+            close(fds[0]);
+            int status;
+            CHECK(waitpid(child, &status, 0) == child && WIFEXITED(status) && !WEXITSTATUS(status));
+        }
+        else {
+            int fd = open(in_path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+            CHECK(fd >= 0);
+            if (!in.empty())
+                CHECK(write(fd, &in[0], in.size() * sizeof(T)) == static_cast<ssize_t>(in.size() * sizeof(T)));
+            CHECK(lseek(fd, 0, SEEK_SET) == 0);
+            ft::external_sort<T>(fd, out, budget, comp);
+            close(fd);
+        }
+        std::vector<T> result(in.size() + 1);
+        CHECK(lseek(out, 0, SEEK_SET) == 0);
+        ssize_t got = read(out, &result[0], result.size() * sizeof(T));
+        CHECK(got == static_cast<ssize_t>(in.size() * sizeof(T)));
+        result.pop_back();
+        close(out);
+        std::remove(in_path.c_str());
+        std::remove(out_path.c_str());
+        return result;
+    }
+
+    // Budgets of a few merge blocks allow only two-way merges, so these inputs go through several
+    // passes between the temporary files; the one-run and empty inputs skip merging altogether.
+    void test_external_sort() {
+        const size_t budget = 4 * ft::external_sort_detail::min_block_bytes;
+        const size_t sizes[] = {0, 1, 1000, 30000, 300000};
+
+        std::srand(seed_value);
+        for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s) {
+            std::vector<long long> keys(sizes[s]);
+            for (size_t i = 0; i < keys.size(); ++i)
+                keys[i] = (static_cast<long long>(std::rand()) << 20) - std::rand();
+            std::vector<long long> sorted = external_sorted(keys, budget, ft::less<long long>(), s & 1);
+            std::sort(keys.begin(), keys.end());
+            CHECK(sorted == keys);
+
+            std::vector<record> records(sizes[s]);
+            for (size_t i = 0; i < records.size(); ++i) {
+                records[i].key = std::rand() % 5000;
+                records[i].tag = static_cast<int>(i);
+            }
+            std::vector<record> by_key = external_sorted(records, budget, record_greater(), !(s & 1));
+            for (size_t i = 1; i < by_key.size(); ++i)
+                CHECK(by_key[i - 1].key >= by_key[i].key);
+            std::sort(by_key.begin(), by_key.end());
+            std::sort(records.begin(), records.end());
+            for (size_t i = 0; i < records.size(); ++i)
+                CHECK(by_key[i].key == records[i].key && by_key[i].tag == records[i].tag);
+        }
+    }
+
+    struct test_case{
+        const char *name;
+        void (*run)();
+    };
+
+    const test_case tests[] = {
+        {"map against std::map", test_map_equivalence},
+        {"set against std::set", test_set_equivalence},
+        {"map/set bulk construction", test_map_bulk_build},
+        {"small_vector against std::vector", test_small_vector},
+        {"deque against std::deque", test_deque},
+        {"concurrent_stack stress", test_concurrent_stack},
+        {"mpmc_ring stress", test_mpmc_ring},
+        {"spsc ring and ft::queue", test_spsc_ring},
+        {"work_stealing_deque stress", test_work_stealing_deque},
+        {"thread_pool fork/join", test_thread_pool},
+        {"parallel first-touch assign", test_parallel_assign},
+        {"concurrent_vector stress", test_concurrent_vector},
+        {"sharded_map against std::map", test_sharded_map},
+        {"save/load round trips", test_vector_io},
+        {"roaring_set against std::set", test_roaring_set},
+        {"soa_vector against a vector of tuples", test_soa_vector},
+        {"frozen_map/frozen_set against std::map/std::set", test_frozen_map_set},
+        {"map/set constructors under throwing copies", test_map_set_construction_throws},
+        {"static_vector against std::vector", test_static_vector},
+        {"segmented_vector stability and exception safety", test_segmented_vector},
+        {"sort, stable_sort and parallel_sort against std::sort", test_sort},
+        {"execution-policy algorithms over vectors, maps and sets", test_execution_policies},
+        {"span construction, slicing and algorithms", test_span},
+        {"packed_vector and delta_vector against std::vector", test_packed_delta_vector},
+        {"vector<bool> against std::vector<bool>", test_vector_bool},
+        {"mmap_map crash recovery", test_mmap_map_crash},
+        {"external_sort multi-pass merges", test_external_sort},
+    };
+}
+
+int main(int argc, char **argv) {
+    seed_value = argc > 1 ? static_cast<unsigned>(std::atoi(argv[1])) : 42;
+    for (size_t i = 0; i < sizeof(tests) / sizeof(tests[0]); ++i) {
+        std::cout << tests[i].name << "... " << std::flush;
+        tests[i].run();
+        std::cout << "ok" << std::endl;
+    }
+    return 0;
+}
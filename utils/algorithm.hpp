@@ -0,0 +1,545 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <functional>
+#include <type_traits>
+#include "enable_if.hpp"
+#include "iterator_traits.hpp"
+#include "map_iterator.hpp"
+#include "sort.hpp"
+#include "../vector/vector.hpp"
+#include "../vector/span.hpp"
+#include "../parallel/thread_pool.hpp"
+
+namespace ft
+{
+    namespace execution
+    {
+        struct sequenced_policy{};
+        struct parallel_policy{};
+        // Parallel, and each chunk may also be vectorised: the callable must not synchronise.
+        struct parallel_unsequenced_policy{};
+
+        static const sequenced_policy seq = sequenced_policy();
+        static const parallel_policy par = parallel_policy();
+        static const parallel_unsequenced_policy par_unseq = parallel_unsequenced_policy();
+    }
+
+    template <class T> struct is_execution_policy : std::false_type{};
+    template <> struct is_execution_policy<execution::sequenced_policy> : std::true_type{};
+    template <> struct is_execution_policy<execution::parallel_policy> : std::true_type{};
+    template <> struct is_execution_policy<execution::parallel_unsequenced_policy> : std::true_type{};
+
+    template <class Iterator>
+    struct is_tree_iterator : std::false_type{};
+
+    template <class T>
+    struct is_tree_iterator<ft::rbt_iterator<T> > : std::true_type{};
+
+    namespace algorithm_detail
+    {
+        static const size_t min_chunk = 1 << 12;
+        static const size_t chunks_per_thread = 8;
+
+        template <class Iterator>
+        struct leaf{
+            Iterator first;
+            Iterator last;
+        };
+
+        // Vector-like ranges: equal chunks of at least min_chunk elements.
+        template <class Iterator>
+        void split(Iterator first, Iterator last, size_t threads, ft::vector<leaf<Iterator> > &leaves, std::false_type) {
+            size_t n = last - first;
+            size_t chunk = n / (threads * chunks_per_thread) + 1;
+
+            if (chunk < min_chunk)
+                chunk = min_chunk;
+            for (size_t i = 0; i < n; i += chunk) {
+                leaf<Iterator> piece = {first + i, first + (i + chunk < n ? i + chunk : n)};
+                leaves.push_back(piece);
+            }
+        }
+
+        template <class Node>
+        Node *subtree_min(Node *node) {
+            while (node->left)
+                node = node->left;
+            return node;
+        }
+
+        // In-order successor of the last node of the subtree rooted at `node`, or 0 for the end.
+        template <class Node>
+        Node *after_subtree(Node *node) {
+            while (node->right)
+                node = node->right;
+            while (node->parent && node->parent->right == node)
+                node = node->parent;
+            return node->parent;
+        }
+
+        template <class Iterator>
+        struct tree_leaves{
+            typedef typename Iterator::p_node p_node;
+
+            ft::vector<leaf<Iterator> > &leaves;
+            p_node root;
+            ft::vector<p_node> last_path;
+            size_t depth_budget;
+
+            tree_leaves(ft::vector<leaf<Iterator> > &out, p_node r, p_node last, size_t budget)
+                : leaves(out), root(r), depth_budget(budget) {
+                for (; last; last = last->parent)
+                    last_path.push_back(last);
+            }
+
+            bool holds_last(p_node node) const {
+                for (size_t i = 0; i < last_path.size(); ++i)
+                    if (last_path[i] == node)
+                        return true;
+                return false;
+            }
+
+            void emit(p_node first, p_node last) {
+                leaf<Iterator> piece = {Iterator(root, first), Iterator(root, last)};
+                leaves.push_back(piece);
+            }
+
+            void node(p_node node) {
+                p_node next = node->right ? subtree_min(node->right) : after_subtree(node);
+                emit(node, next);
+            }
+
+            // A whole subtree, cut at shallow nodes until the depth budget is spent.
+            void subtree(p_node node, size_t budget) {
+                if (!node)
+                    return;
+                if (!budget || (!node->left && !node->right)) {
+                    emit(subtree_min(node), after_subtree(node));
+                    return;
+                }
+                subtree(node->left, budget - 1);
+                this->node(node);
+                subtree(node->right, budget - 1);
+            }
+
+            // Walks the in-order spine from first: each step yields a node and its right subtree, until
+            // the subtree that holds last, which is entered down the path to last.
+            void split(p_node first, p_node last) {
+                p_node x = first;
+
+                while (x && x != last) {
+                    node(x);
+                    p_node right = x->right;
+                    if (right && holds_last(right)) {
+                        for (p_node z = right; ; ) {
+                            if (z == last) {
+                                subtree(z->left, depth_budget);
+                                return;
+                            }
+                            if (holds_last(z->left))
+                                z = z->left;
+                            else {
+                                subtree(z->left, depth_budget);
+                                node(z);
+                                z = z->right;
+                            }
+                        }
+                    }
+                    subtree(right, depth_budget);
+                    while (x->parent && x->parent->right == x)
+                        x = x->parent;
+                    x = x->parent;
+                }
+            }
+        };
+
+        template <class Iterator>
+        void split(Iterator first, Iterator last, size_t threads, ft::vector<leaf<Iterator> > &leaves, std::true_type) {
+            size_t budget = 3;
+
+            for (size_t t = threads; t > 1; t >>= 1)
+                ++budget;
+            if (first == last)
+                return;
+            tree_leaves<Iterator> splitter(leaves, first.root(), last.base(), budget);
+            splitter.split(first.base(), last.base());
+        }
+
+        template <class Iterator>
+        ft::vector<leaf<Iterator> > split(Iterator first, Iterator last, size_t threads) {
+            ft::vector<leaf<Iterator> > leaves;
+
+            split(first, last, threads, leaves, ft::is_tree_iterator<Iterator>());
+            return leaves;
+        }
+
+        template <class F>
+        void for_leaves(size_t count, F f) {
+            if (count < 2) {
+                for (size_t i = 0; i < count; ++i)
+                    f(i);
+                return;
+            }
+            ft::default_thread_pool().parallel_for(0, count, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i)
+                    f(i);
+            }, 1);
+        }
+
+        template <class Iterator>
+        struct contiguous_leaf : std::integral_constant<bool, ft::contiguous_iterator<Iterator>::value>{};
+
+        template <class Iterator, class Function>
+        void leaf_for_each(Iterator first, Iterator last, Function &f, std::false_type) {
+            for (; first != last; ++first)
+                f(*first);
+        }
+
+        template <class Iterator, class Function>
+        void leaf_for_each(Iterator first, Iterator last, Function &f, std::true_type) {
+            typename std::iterator_traits<Iterator>::pointer data = ft::contiguous_iterator<Iterator>::address(first);
+            const ptrdiff_t n = last - first;
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC ivdep
+#endif
+            for (ptrdiff_t i = 0; i < n; ++i)
+                f(data[i]);
+        }
+
+        struct identity{
+            template <class U>
+            const U &operator()(const U &x) const {
+                return x;
+            }
+        };
+
+        // Each leaf starts from its own first element, mapped through transform, so the partial sums
+        // need no identity value for op.
+        template <class Iterator, class T, class BinaryOperation, class UnaryOperation>
+        T leaf_reduce(Iterator first, Iterator last, BinaryOperation &op, UnaryOperation &transform, std::false_type) {
+            T acc = transform(*first);
+
+            for (++first; first != last; ++first)
+                acc = op(acc, transform(*first));
+            return acc;
+        }
+
+        // Four independent accumulators, so the loop is not one serial dependency chain.
+        template <class Iterator, class T, class BinaryOperation, class UnaryOperation>
+        T leaf_reduce(Iterator first, Iterator last, BinaryOperation &op, UnaryOperation &transform, std::true_type) {
+            ptrdiff_t n = last - first;
+
+            if (n < 8)
+                return leaf_reduce<Iterator, T>(first, last, op, transform, std::false_type());
+            typename std::iterator_traits<Iterator>::pointer data = ft::contiguous_iterator<Iterator>::address(first);
+            T a0 = transform(data[0]), a1 = transform(data[1]), a2 = transform(data[2]), a3 = transform(data[3]);
+            ptrdiff_t i = 4;
+            for (; i + 4 <= n; i += 4) {
+                a0 = op(a0, transform(data[i]));
+                a1 = op(a1, transform(data[i + 1]));
+                a2 = op(a2, transform(data[i + 2]));
+                a3 = op(a3, transform(data[i + 3]));
+            }
+            for (; i < n; ++i)
+                a0 = op(a0, transform(data[i]));
+            return op(op(a0, a1), op(a2, a3));
+        }
+
+        template <class Policy, class Iterator>
+        struct unsequenced : std::integral_constant<bool,
+            std::is_same<Policy, execution::parallel_unsequenced_policy>::value && contiguous_leaf<Iterator>::value>{};
+
+        template <class Iterator>
+        size_t leaf_size(const leaf<Iterator> &piece, std::random_access_iterator_tag) {
+            return piece.last - piece.first;
+        }
+
+        template <class Iterator>
+        size_t leaf_size(leaf<Iterator> piece, std::bidirectional_iterator_tag) {
+            size_t n = 0;
+
+            for (; piece.first != piece.last; ++piece.first)
+                ++n;
+            return n;
+        }
+    }
+
+    template <class InputIterator, class Function>
+    Function for_each(InputIterator first, InputIterator last, Function f) {
+        for (; first != last; ++first)
+            f(*first);
+        return f;
+    }
+
+    template <class ExecutionPolicy, class Iterator, class Function>
+    typename ft::enable_if<ft::is_execution_policy<ExecutionPolicy>::value>::type
+    for_each(const ExecutionPolicy &, Iterator first, Iterator last, Function f) {
+        typedef algorithm_detail::leaf<Iterator> leaf;
+
+        if (std::is_same<ExecutionPolicy, execution::sequenced_policy>::value) {
+            ft::for_each(first, last, f);
+            return;
+        }
+        ft::vector<leaf> leaves = algorithm_detail::split(first, last, ft::default_thread_pool().size());
+        algorithm_detail::for_leaves(leaves.size(), [&](size_t i) {
+            algorithm_detail::leaf_for_each(leaves[i].first, leaves[i].last, f,
+                                            algorithm_detail::unsequenced<ExecutionPolicy, Iterator>());
+        });
+    }
+
+    template <class InputIterator, class OutputIterator, class UnaryOperation>
+    OutputIterator transform(InputIterator first, InputIterator last, OutputIterator out, UnaryOperation op) {
+        for (; first != last; ++first, ++out)
+            *out = op(*first);
+        return out;
+    }
+
+    // The parallel form writes through out[offset], so the output must be random access.
+    template <class ExecutionPolicy, class Iterator, class OutputIterator, class UnaryOperation>
+    typename ft::enable_if<ft::is_execution_policy<ExecutionPolicy>::value, OutputIterator>::type
+    transform(const ExecutionPolicy &, Iterator first, Iterator last, OutputIterator out, UnaryOperation op) {
+        typedef algorithm_detail::leaf<Iterator> leaf;
+        typedef typename std::iterator_traits<Iterator>::iterator_category category;
+
+        if (std::is_same<ExecutionPolicy, execution::sequenced_policy>::value)
+            return ft::transform(first, last, out, op);
+        ft::vector<leaf> leaves = algorithm_detail::split(first, last, ft::default_thread_pool().size());
+        ft::vector<size_t> offsets(leaves.size() + 1, 0);
+        algorithm_detail::for_leaves(leaves.size(), [&](size_t i) {
+            offsets[i + 1] = algorithm_detail::leaf_size(leaves[i], category());
+        });
+        for (size_t i = 0; i < leaves.size(); ++i)
+            offsets[i + 1] += offsets[i];
+        algorithm_detail::for_leaves(leaves.size(), [&](size_t i) {
+            OutputIterator dest = out + offsets[i];
+            for (Iterator it = leaves[i].first; it != leaves[i].last; ++it, ++dest)
+                *dest = op(*it);
+        });
+        return out + offsets[leaves.size()];
+    }
+
+    template <class InputIterator, class T, class BinaryOperation>
+    typename ft::enable_if<!ft::is_execution_policy<InputIterator>::value, T>::type
+    reduce(InputIterator first, InputIterator last, T init, BinaryOperation op) {
+        for (; first != last; ++first)
+            init = op(init, *first);
+        return init;
+    }
+
+    template <class InputIterator, class T>
+    typename ft::enable_if<!ft::is_execution_policy<InputIterator>::value, T>::type
+    reduce(InputIterator first, InputIterator last, T init) {
+        return ft::reduce(first, last, init, std::plus<T>());
+    }
+
+    template <class InputIterator, class T, class BinaryOperation, class UnaryOperation>
+    typename ft::enable_if<!ft::is_execution_policy<InputIterator>::value, T>::type
+    transform_reduce(InputIterator first, InputIterator last, T init, BinaryOperation reduce_op, UnaryOperation transform_op) {
+        for (; first != last; ++first)
+            init = reduce_op(init, transform_op(*first));
+        return init;
+    }
+
+    // reduce_op must be associative and commutative over T: each chunk folds its transformed elements
+    // into a T of its own, then the chunk results are folded in order into init.
+    template <class ExecutionPolicy, class Iterator, class T, class BinaryOperation, class UnaryOperation>
+    typename ft::enable_if<ft::is_execution_policy<ExecutionPolicy>::value, T>::type
+    transform_reduce(const ExecutionPolicy &, Iterator first, Iterator last, T init, BinaryOperation reduce_op, UnaryOperation transform_op) {
+        typedef algorithm_detail::leaf<Iterator> leaf;
+
+        if (std::is_same<ExecutionPolicy, execution::sequenced_policy>::value)
+            return ft::transform_reduce(first, last, init, reduce_op, transform_op);
+        ft::vector<leaf> leaves = algorithm_detail::split(first, last, ft::default_thread_pool().size());
+        ft::vector<T> partial(leaves.size(), init);
+        algorithm_detail::for_leaves(leaves.size(), [&](size_t i) {
+            partial[i] = algorithm_detail::leaf_reduce<Iterator, T>(leaves[i].first, leaves[i].last, reduce_op, transform_op,
+                                                                    algorithm_detail::unsequenced<ExecutionPolicy, Iterator>());
+        });
+        for (size_t i = 0; i < partial.size(); ++i)
+            init = reduce_op(init, partial[i]);
+        return init;
+    }
+
+    namespace algorithm_detail
+    {
+        template <class ExecutionPolicy, class Iterator, class T, class BinaryOperation>
+        T reduce(const ExecutionPolicy &policy, Iterator first, Iterator last, T init, BinaryOperation &op, std::true_type) {
+            return ft::transform_reduce(policy, first, last, init, op, identity());
+        }
+
+        template <class ExecutionPolicy, class Iterator, class T, class BinaryOperation>
+        T reduce(const ExecutionPolicy &, Iterator first, Iterator last, T init, BinaryOperation &op, std::false_type) {
+            return ft::reduce(first, last, init, op);
+        }
+    }
+
+    // op must be associative and commutative: chunks are folded independently, then in order into init.
+    // Elements that cannot start a T of their own (a map's pairs summed into a total) are folded in
+    // order instead; transform_reduce maps them to T first and keeps the parallel split.
+    template <class ExecutionPolicy, class Iterator, class T, class BinaryOperation>
+    typename ft::enable_if<ft::is_execution_policy<ExecutionPolicy>::value, T>::type
+    reduce(const ExecutionPolicy &policy, Iterator first, Iterator last, T init, BinaryOperation op) {
+        return algorithm_detail::reduce(policy, first, last, init, op,
+                                        std::is_convertible<typename std::iterator_traits<Iterator>::reference, T>());
+    }
+
+    template <class ExecutionPolicy, class Iterator, class T>
+    typename ft::enable_if<ft::is_execution_policy<ExecutionPolicy>::value, T>::type
+    reduce(const ExecutionPolicy &policy, Iterator first, Iterator last, T init) {
+        return ft::reduce(policy, first, last, init, std::plus<T>());
+    }
+
+    template <class InputIterator, class Predicate>
+    typename std::iterator_traits<InputIterator>::difference_type
+    count_if(InputIterator first, InputIterator last, Predicate pred) {
+        typename std::iterator_traits<InputIterator>::difference_type res = 0;
+
+        for (; first != last; ++first)
+            res += pred(*first) ? 1 : 0;
+        return res;
+    }
+
+    template <class ExecutionPolicy, class Iterator, class Predicate>
+    typename ft::enable_if<ft::is_execution_policy<ExecutionPolicy>::value,
+                           typename std::iterator_traits<Iterator>::difference_type>::type
+    count_if(const ExecutionPolicy &, Iterator first, Iterator last, Predicate pred) {
+        typedef algorithm_detail::leaf<Iterator> leaf;
+        typedef typename std::iterator_traits<Iterator>::difference_type difference_type;
+
+        if (std::is_same<ExecutionPolicy, execution::sequenced_policy>::value)
+            return ft::count_if(first, last, pred);
+        ft::vector<leaf> leaves = algorithm_detail::split(first, last, ft::default_thread_pool().size());
+        ft::vector<difference_type> counts(leaves.size(), 0);
+        algorithm_detail::for_leaves(leaves.size(), [&](size_t i) {
+            counts[i] = ft::count_if(leaves[i].first, leaves[i].last, pred);
+        });
+        difference_type res = 0;
+        for (size_t i = 0; i < counts.size(); ++i)
+            res += counts[i];
+        return res;
+    }
+
+    template <class InputIterator, class Predicate>
+    InputIterator find_if(InputIterator first, InputIterator last, Predicate pred) {
+        while (first != last && !pred(*first))
+            ++first;
+        return first;
+    }
+
+    // Returns the first match in range order; chunks after the best match found so far are skipped.
+    template <class ExecutionPolicy, class Iterator, class Predicate>
+    typename ft::enable_if<ft::is_execution_policy<ExecutionPolicy>::value, Iterator>::type
+    find_if(const ExecutionPolicy &, Iterator first, Iterator last, Predicate pred) {
+        typedef algorithm_detail::leaf<Iterator> leaf;
+
+        if (std::is_same<ExecutionPolicy, execution::sequenced_policy>::value)
+            return ft::find_if(first, last, pred);
+        ft::vector<leaf> leaves = algorithm_detail::split(first, last, ft::default_thread_pool().size());
+        ft::vector<Iterator> found(leaves.size(), last);
+        std::atomic<size_t> best(leaves.size());
+        algorithm_detail::for_leaves(leaves.size(), [&](size_t i) {
+            if (i > best.load(std::memory_order_relaxed))
+                return;
+            Iterator it = ft::find_if(leaves[i].first, leaves[i].last, pred);
+            if (it == leaves[i].last)
+                return;
+            found[i] = it;
+            size_t current = best.load(std::memory_order_relaxed);
+            while (i < current && !best.compare_exchange_weak(current, i, std::memory_order_relaxed))
+                ;
+        });
+        return best.load() < leaves.size() ? found[best.load()] : last;
+    }
+
+    // Span forms: the range goes through as raw pointers, so the contiguous leaf paths apply.
+    template <class T, size_t Extent, class Function>
+    Function for_each(const ft::span<T, Extent> &s, Function f) {
+        return ft::for_each(s.data(), s.data() + s.size(), f);
+    }
+
+    template <class ExecutionPolicy, class T, size_t Extent, class Function>
+    typename ft::enable_if<ft::is_execution_policy<ExecutionPolicy>::value>::type
+    for_each(const ExecutionPolicy &policy, const ft::span<T, Extent> &s, Function f) {
+        ft::for_each(policy, s.data(), s.data() + s.size(), f);
+    }
+
+    template <class T, size_t Extent, class OutputIterator, class UnaryOperation>
+    OutputIterator transform(const ft::span<T, Extent> &s, OutputIterator out, UnaryOperation op) {
+        return ft::transform(s.data(), s.data() + s.size(), out, op);
+    }
+
+    template <class ExecutionPolicy, class T, size_t Extent, class OutputIterator, class UnaryOperation>
+    typename ft::enable_if<ft::is_execution_policy<ExecutionPolicy>::value, OutputIterator>::type
+    transform(const ExecutionPolicy &policy, const ft::span<T, Extent> &s, OutputIterator out, UnaryOperation op) {
+        return ft::transform(policy, s.data(), s.data() + s.size(), out, op);
+    }
+
+    template <class T, size_t Extent, class U, class BinaryOperation>
+    U reduce(const ft::span<T, Extent> &s, U init, BinaryOperation op) {
+        return ft::reduce(s.data(), s.data() + s.size(), init, op);
+    }
+
+    template <class T, size_t Extent, class U>
+    U reduce(const ft::span<T, Extent> &s, U init) {
+        return ft::reduce(s.data(), s.data() + s.size(), init);
+    }
+
+    template <class ExecutionPolicy, class T, size_t Extent, class U, class BinaryOperation>
+    typename ft::enable_if<ft::is_execution_policy<ExecutionPolicy>::value, U>::type
+    reduce(const ExecutionPolicy &policy, const ft::span<T, Extent> &s, U init, BinaryOperation op) {
+        return ft::reduce(policy, s.data(), s.data() + s.size(), init, op);
+    }
+
+    template <class ExecutionPolicy, class T, size_t Extent, class U>
+    typename ft::enable_if<ft::is_execution_policy<ExecutionPolicy>::value, U>::type
+    reduce(const ExecutionPolicy &policy, const ft::span<T, Extent> &s, U init) {
+        return ft::reduce(policy, s.data(), s.data() + s.size(), init);
+    }
+
+    template <class T, size_t Extent, class U, class BinaryOperation, class UnaryOperation>
+    U transform_reduce(const ft::span<T, Extent> &s, U init, BinaryOperation reduce_op, UnaryOperation transform_op) {
+        return ft::transform_reduce(s.data(), s.data() + s.size(), init, reduce_op, transform_op);
+    }
+
+    template <class ExecutionPolicy, class T, size_t Extent, class U, class BinaryOperation, class UnaryOperation>
+    typename ft::enable_if<ft::is_execution_policy<ExecutionPolicy>::value, U>::type
+    transform_reduce(const ExecutionPolicy &policy, const ft::span<T, Extent> &s, U init, BinaryOperation reduce_op, UnaryOperation transform_op) {
+        return ft::transform_reduce(policy, s.data(), s.data() + s.size(), init, reduce_op, transform_op);
+    }
+
+    template <class T, size_t Extent, class Predicate>
+    ptrdiff_t count_if(const ft::span<T, Extent> &s, Predicate pred) {
+        return ft::count_if(s.data(), s.data() + s.size(), pred);
+    }
+
+    template <class ExecutionPolicy, class T, size_t Extent, class Predicate>
+    typename ft::enable_if<ft::is_execution_policy<ExecutionPolicy>::value, ptrdiff_t>::type
+    count_if(const ExecutionPolicy &policy, const ft::span<T, Extent> &s, Predicate pred) {
+        return ft::count_if(policy, s.data(), s.data() + s.size(), pred);
+    }
+
+    template <class T, size_t Extent, class Predicate>
+    typename ft::span<T, Extent>::iterator find_if(const ft::span<T, Extent> &s, Predicate pred) {
+        return s.begin() + (ft::find_if(s.data(), s.data() + s.size(), pred) - s.data());
+    }
+
+    template <class ExecutionPolicy, class T, size_t Extent, class Predicate>
+    typename ft::enable_if<ft::is_execution_policy<ExecutionPolicy>::value, typename ft::span<T, Extent>::iterator>::type
+    find_if(const ExecutionPolicy &policy, const ft::span<T, Extent> &s, Predicate pred) {
+        return s.begin() + (ft::find_if(policy, s.data(), s.data() + s.size(), pred) - s.data());
+    }
+
+    template <class T, size_t Extent>
+    void sort(const ft::span<T, Extent> &s) {
+        ft::sort(s.data(), s.data() + s.size());
+    }
+
+    template <class T, size_t Extent, class Compare>
+    void sort(const ft::span<T, Extent> &s, Compare comp) {
+        ft::sort(s.data(), s.data() + s.size(), comp);
+    }
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+namespace ft
+{
+    inline unsigned count_trailing_zeros(unsigned long long x){
+#if defined(__GNUC__) || defined(__clang__)
+        return x ? __builtin_ctzll(x) : 64;
+#else
+        unsigned res = 0;
+
+        if (!x)
+            return 64;
+        while (!(x & 1)){
+            x >>= 1;
+            ++res;
+        }
+        return res;
+#endif
+    }
+
+    inline unsigned popcount(unsigned long long x){
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_popcountll(x);
+#else
+        unsigned res = 0;
+
+        for (; x; x &= x - 1)
+            ++res;
+        return res;
+#endif
+    }
+
+    // Index of the highest set bit; x must be non-zero.
+    inline unsigned log2_floor(unsigned long long x){
+#if defined(__GNUC__) || defined(__clang__)
+        return 63 - __builtin_clzll(x);
+#else
+        unsigned res = 0;
+
+        while (x >>= 1)
+            ++res;
+        return res;
+#endif
+    }
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+#include <cstddef>
+
+namespace ft
+{
+    // Destructive interference size assumed for padding shared atomics apart.
+    static const size_t cache_line_size = 64;
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstddef>
+
+namespace ft
+{
+    // log2 of the largest power-of-two element count that keeps a chunk of T within Bytes.
+    template <typename T, size_t Bytes, size_t Count = Bytes / sizeof(T)>
+    struct chunk_shift{
+        static const size_t value = chunk_shift<T, Bytes, Count / 2>::value + 1;
+    };
+
+    template <typename T, size_t Bytes>
+    struct chunk_shift<T, Bytes, 1>{
+        static const size_t value = 0;
+    };
+
+    template <typename T, size_t Bytes>
+    struct chunk_shift<T, Bytes, 0>{
+        static const size_t value = 0;
+    };
+}
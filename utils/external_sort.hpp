@@ -0,0 +1,497 @@
+#pragma once
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <cstddef>
+#include <utility>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+#include <sys/types.h>
+#include <unistd.h>
+#include "less.hpp"
+#include "sort.hpp"
+#include "loser_tree.hpp"
+#include "../deque/deque.hpp"
+#include "../vector/vector.hpp"
+
+namespace ft{
+    namespace external_sort_detail
+    {
+        static const size_t block_bytes = 1 << 20;
+        static const size_t min_block_bytes = 1 << 16;
+
+        // One transfer for the I/O thread. offset < 0 means the fd's own position (pipes, the
+        // output); reads stop short only at end of file.
+        struct request{
+            int fd;
+            char *data;
+            size_t bytes;
+            off_t offset;
+            bool write;
+            size_t done;
+            int error;
+            bool finished;
+        };
+
+        // Runs the transfers in submission order on one thread, so the caller can keep comparing
+        // while the next blocks come in and the previous ones go out.
+        class io_thread{
+            public:
+                io_thread() : stop_(false), thread_(&io_thread::work, this) {}
+
+                ~io_thread() {
+                    {
+                        std::lock_guard<std::mutex> guard(mutex_);
+                        stop_ = true;
+                    }
+                    wake_.notify_one();
+                    thread_.join();
+                }
+
+                void submit(request *r) {
+                    r->done = 0;
+                    r->error = 0;
+                    r->finished = false;
+                    {
+                        std::lock_guard<std::mutex> guard(mutex_);
+                        queue_.push_back(r);
+                    }
+                    wake_.notify_one();
+                }
+
+                void wait_quietly(request *r) {
+                    std::unique_lock<std::mutex> lock(mutex_);
+
+                    while (!r->finished)
+                        finished_.wait(lock);
+                }
+
+                size_t wait(request *r) {
+                    wait_quietly(r);
+                    if (r->error)
+                        throw std::system_error(r->error, std::generic_category(), "ft::external_sort");
+                    return r->done;
+                }
+
+            private:
+                io_thread(const io_thread &);
+                io_thread &operator=(const io_thread &);
+
+                std::mutex mutex_;
+                std::condition_variable wake_;
+                std::condition_variable finished_;
+                ft::deque<request *> queue_;
+                bool stop_;
+                std::thread thread_;
+
+                static void transfer(request *r) {
+                    while (r->done < r->bytes) {
+                        char *p = r->data + r->done;
+                        size_t left = r->bytes - r->done;
+                        off_t at = r->offset + static_cast<off_t>(r->done);
+                        ssize_t n;
+                        if (r->write)
+                            n = r->offset < 0 ? ::write(r->fd, p, left) : ::pwrite(r->fd, p, left, at);
+                        else
+                            n = r->offset < 0 ? ::read(r->fd, p, left) : ::pread(r->fd, p, left, at);
+                        if (n < 0 && errno == EINTR)
+                            continue;
+                        if (n < 0) {
+                            r->error = errno;
+                            return;
+                        }
+                        if (!n)
+                            return;
+                        r->done += n;
+                    }
+                }
+
+                void work() {
+                    for (;;) {
+                        request *r;
+                        {
+                            std::unique_lock<std::mutex> lock(mutex_);
+                            while (queue_.empty() && !stop_)
+                                wake_.wait(lock);
+                            if (queue_.empty())
+                                return;
+                            r = queue_.front();
+                            queue_.pop_front();
+                        }
+                        transfer(r);
+                        {
+                            std::lock_guard<std::mutex> guard(mutex_);
+                            r->finished = true;
+                        }
+                        finished_.notify_all();
+                    }
+                }
+        };
+
+        // A sorted run inside a temporary file, in records.
+        struct span{
+            unsigned long long offset;
+            unsigned long long count;
+        };
+
+        // Reads one run through two blocks: while the merge consumes one, the other is being filled.
+        template <class T>
+        class run_reader{
+            public:
+                run_reader() : io_(0) {
+                    pending_[0] = false;
+                    pending_[1] = false;
+                }
+
+                ~run_reader() {
+                    for (int i = 0; i < 2; ++i)
+                        if (pending_[i])
+                            io_->wait_quietly(&requests_[i]);
+                }
+
+                void open(io_thread &io, int fd, const span &s, size_t block_records) {
+                    io_ = &io;
+                    fd_ = fd;
+                    next_ = s.offset;
+                    left_ = s.count;
+                    block_ = block_records;
+                    for (int i = 0; i < 2; ++i) {
+                        buffers_[i].resize(block_records * sizeof(T));
+                        pending_[i] = false;
+                        fetch(i);
+                    }
+                    active_ = 0;
+                    pos_ = 0;
+                    end_ = 0;
+                }
+
+                // Next record, or 0 once the run is exhausted.
+                const T *next() {
+                    if (pos_ == end_) {
+                        if (!pending_[active_])
+                            return 0;
+                        end_ = io_->wait(&requests_[active_]) / sizeof(T);
+                        pending_[active_] = false;
+                        pos_ = 0;
+                        if (!end_)
+                            return 0;
+                    }
+                    const T *record = reinterpret_cast<const T *>(&buffers_[active_][0]) + pos_;
+                    if (++pos_ == end_) {
+                        current_ = *record;
+                        pos_ = end_ = 0;
+                        fetch(active_);
+                        active_ ^= 1;
+                        return &current_;
+                    }
+                    return record;
+                }
+
+            private:
+                run_reader(const run_reader &);
+                run_reader &operator=(const run_reader &);
+
+                io_thread *io_;
+                int fd_;
+                unsigned long long next_;
+                unsigned long long left_;
+                size_t block_;
+                ft::vector<char> buffers_[2];
+                request requests_[2];
+                bool pending_[2];
+                int active_;
+                size_t pos_;
+                size_t end_;
+                T current_;
+
+                // The last record of a block is copied out, so its block can be refilled right away.
+                void fetch(int i) {
+                    size_t count = left_ < block_ ? static_cast<size_t>(left_) : block_;
+
+                    if (!count)
+                        return;
+                    request r = {fd_, &buffers_[i][0], count * sizeof(T),
+                                 static_cast<off_t>(next_ * sizeof(T)), false, 0, 0, false};
+                    requests_[i] = r;
+                    next_ += count;
+                    left_ -= count;
+                    pending_[i] = true;
+                    io_->submit(&requests_[i]);
+                }
+        };
+
+        // Collects records into one block while the other is being written.
+        template <class T>
+        class block_writer{
+            public:
+                block_writer(io_thread &io, int fd, off_t offset, size_t block_records)
+                    : io_(io), fd_(fd), offset_(offset), block_(block_records), active_(0), count_(0) {
+                    for (int i = 0; i < 2; ++i) {
+                        buffers_[i].resize(block_records * sizeof(T));
+                        pending_[i] = false;
+                    }
+                }
+
+                ~block_writer() {
+                    for (int i = 0; i < 2; ++i)
+                        if (pending_[i])
+                            io_.wait_quietly(&requests_[i]);
+                }
+
+                void push(const T &record) {
+                    std::memcpy(&buffers_[active_][count_ * sizeof(T)], static_cast<const void *>(&record), sizeof(T));
+                    if (++count_ == block_)
+                        send();
+                }
+
+                void flush() {
+                    if (count_)
+                        send();
+                    for (int i = 0; i < 2; ++i)
+                        finish(i);
+                }
+
+            private:
+                block_writer(const block_writer &);
+                block_writer &operator=(const block_writer &);
+
+                io_thread &io_;
+                int fd_;
+                off_t offset_;
+                size_t block_;
+                ft::vector<char> buffers_[2];
+                request requests_[2];
+                bool pending_[2];
+                int active_;
+                size_t count_;
+
+                void finish(int i) {
+                    if (!pending_[i])
+                        return;
+                    pending_[i] = false;
+                    if (io_.wait(&requests_[i]) != requests_[i].bytes)
+                        throw std::runtime_error("ft::external_sort: short write");
+                }
+
+                void send() {
+                    request r = {fd_, &buffers_[active_][0], count_ * sizeof(T), offset_, true, 0, 0, false};
+
+                    requests_[active_] = r;
+                    pending_[active_] = true;
+                    io_.submit(&requests_[active_]);
+                    if (offset_ >= 0)
+                        offset_ += static_cast<off_t>(count_ * sizeof(T));
+                    active_ ^= 1;
+                    count_ = 0;
+                    finish(active_);
+                }
+        };
+
+        inline std::FILE *temporary() {
+            std::FILE *file = std::tmpfile();
+
+            if (!file)
+                throw std::system_error(errno, std::generic_category(), "ft::external_sort");
+            return file;
+        }
+
+        struct temporary_file{
+            std::FILE *file;
+
+            temporary_file() : file(temporary()) {}
+
+            ~temporary_file() {
+                std::fclose(file);
+            }
+
+            int fd() const {
+                return fileno(file);
+            }
+        };
+
+        // Merges runs[first, first + k) of fd into out, anything with push(const T &), through a loser
+        // tree. Equal records leave in run order, so merging consecutive runs is stable.
+        template <class T, class Compare, class Out>
+        void merge(io_thread &io, int fd, const ft::vector<span> &runs, size_t first, size_t k,
+                   Out &out, size_t block_records, const Compare &comp) {
+            ft::vector<run_reader<T> *> readers(k, (run_reader<T> *)0);
+            ft::loser_tree<T, Compare> tree(k, comp);
+
+            try {
+                for (size_t i = 0; i < k; ++i) {
+                    readers[i] = new run_reader<T>();
+                    readers[i]->open(io, fd, runs[first + i], block_records);
+                }
+                for (size_t i = 0; i < k; ++i)
+                    tree.set(i, readers[i]->next());
+                tree.build();
+                while (!tree.empty()) {
+                    out.push(*tree.top_value());
+                    tree.replace_top(readers[tree.top()]->next());
+                }
+            }
+            catch (...) {
+                for (size_t i = 0; i < k; ++i)
+                    delete readers[i];
+                throw;
+            }
+            for (size_t i = 0; i < k; ++i)
+                delete readers[i];
+        }
+
+        // Records per block when merging `ways` runs: two blocks per run and two for the output.
+        template <class T>
+        size_t merge_block(size_t memory_budget, size_t ways) {
+            size_t block = memory_budget / (2 * (ways + 1)) / sizeof(T);
+
+            if (block * sizeof(T) > block_bytes)
+                block = block_bytes / sizeof(T);
+            return block ? block : 1;
+        }
+
+        // Merges groups of k consecutive runs of from into one run each of to, a generation per pass,
+        // until at most k runs are left; from then names the file that holds them.
+        template <class T, class Compare>
+        void merge_passes(io_thread &io, int &from, int &to, ft::vector<span> &runs, size_t k,
+                          size_t block_records, const Compare &comp) {
+            while (runs.size() > k) {
+                ft::vector<span> merged;
+                unsigned long long offset = 0;
+                for (size_t first = 0; first < runs.size(); first += k) {
+                    size_t n = runs.size() - first < k ? runs.size() - first : k;
+                    block_writer<T> out(io, to, static_cast<off_t>(offset * sizeof(T)), block_records);
+                    merge<T>(io, from, runs, first, n, out, block_records, comp);
+                    out.flush();
+                    span s = {offset, 0};
+                    for (size_t i = 0; i < n; ++i)
+                        s.count += runs[first + i].count;
+                    merged.push_back(s);
+                    offset += s.count;
+                }
+                runs = merged;
+                std::swap(from, to);
+            }
+        }
+
+        // Cuts the input into sorted runs appended to fd and returns where they lie. Two buffers of
+        // run_records alternate: while one is sorted, the next run is read into the other and the
+        // previous one written from it. An input that fits in one run is sorted and written
+        // straight to output_fd instead, and no run is returned.
+        template <class T, class Compare>
+        ft::vector<span> make_runs(io_thread &io, int input_fd, int output_fd, int fd, size_t run_records, const Compare &comp) {
+            ft::vector<span> runs;
+            ft::vector<char> buffers[2];
+            request reads[2];
+            request writes[2];
+            bool reading[2] = {false, false};
+            bool writing[2] = {false, false};
+            unsigned long long offset = 0;
+            int active = 0;
+
+            try {
+                for (int i = 0; i < 2; ++i)
+                    buffers[i].resize(run_records * sizeof(T));
+                request first = {input_fd, &buffers[0][0], run_records * sizeof(T), -1, false, 0, 0, false};
+                reads[0] = first;
+                reading[0] = true;
+                io.submit(&reads[0]);
+                for (;;) {
+                    reading[active] = false;
+                    size_t bytes = io.wait(&reads[active]);
+                    if (bytes % sizeof(T))
+                        throw std::runtime_error("ft::external_sort: truncated record");
+                    size_t count = bytes / sizeof(T);
+                    T *data = reinterpret_cast<T *>(&buffers[active][0]);
+                    bool last = count < run_records;
+                    int other = active ^ 1;
+                    if (writing[other]) {
+                        writing[other] = false;
+                        io.wait(&writes[other]);
+                    }
+                    if (!last) {
+                        request next = {input_fd, &buffers[other][0], run_records * sizeof(T), -1, false, 0, 0, false};
+                        reads[other] = next;
+                        reading[other] = true;
+                        io.submit(&reads[other]);
+                    }
+                    ft::sort(data, data + count, comp);
+                    bool direct = last && runs.empty();
+                    request out = {direct ? output_fd : fd, &buffers[active][0], count * sizeof(T),
+                                   direct ? -1 : static_cast<off_t>(offset * sizeof(T)), true, 0, 0, false};
+                    writes[active] = out;
+                    writing[active] = true;
+                    io.submit(&writes[active]);
+                    if (!direct && count) {
+                        span s = {offset, count};
+                        runs.push_back(s);
+                        offset += count;
+                    }
+                    if (last)
+                        break;
+                    active = other;
+                }
+                for (int i = 0; i < 2; ++i)
+                    if (writing[i]) {
+                        writing[i] = false;
+                        if (io.wait(&writes[i]) != writes[i].bytes)
+                            throw std::runtime_error("ft::external_sort: short write");
+                    }
+            }
+            catch (...) {
+                for (int i = 0; i < 2; ++i) {
+                    if (reading[i])
+                        io.wait_quietly(&reads[i]);
+                    if (writing[i])
+                        io.wait_quietly(&writes[i]);
+                }
+                throw;
+            }
+            return runs;
+        }
+    }
+
+    // Sorts the T records read from input_fd into output_fd using about memory_budget bytes.
+    //
+    // The two run buffers share the budget, so sorting one overlaps reading the next (see make_runs).
+    // When ft::sort radix sorts the records it takes a scratch buffer of one more run, so runs are
+    // then a third of the budget each.
+    // The runs, kept in one temporary file, are merged k at a time through a loser tree, with k as
+    // large as the budget allows at min_block_bytes per block; more runs than that take extra
+    // passes between two temporary files. Run readers and the output are double-buffered on the I/O
+    // thread, so comparisons overlap the transfers. Both fds are used from their current position
+    // and may be pipes.
+    template <class T, class Compare>
+    void external_sort(int input_fd, int output_fd, size_t memory_budget, Compare comp) {
+        static_assert(std::is_trivially_copyable<T>::value, "ft::external_sort needs trivially copyable records");
+        size_t run_records = memory_budget / (ft::radix_sortable<T *, Compare>::value ? 3 : 2) / sizeof(T);
+        external_sort_detail::io_thread io;
+        external_sort_detail::temporary_file runs_file;
+        ft::vector<external_sort_detail::span> runs = external_sort_detail::make_runs<T>(
+                io, input_fd, output_fd, runs_file.fd(), run_records ? run_records : 1, comp);
+
+        if (runs.empty())
+            return;
+        size_t k = memory_budget / (2 * external_sort_detail::min_block_bytes);
+        k = k > 2 ? k - 1 : 2;
+        size_t block = external_sort_detail::merge_block<T>(memory_budget, k);
+        external_sort_detail::temporary_file spare;
+        int from = runs_file.fd();
+        int to = spare.fd();
+
+        external_sort_detail::merge_passes<T>(io, from, to, runs, k, block, comp);
+        block = external_sort_detail::merge_block<T>(memory_budget, runs.size());
+        external_sort_detail::block_writer<T> out(io, output_fd, -1, block);
+        external_sort_detail::merge<T>(io, from, runs, 0, runs.size(), out, block, comp);
+        out.flush();
+    }
+
+    template <class T>
+    void external_sort(int input_fd, int output_fd, size_t memory_budget) {
+        ft::external_sort<T>(input_fd, output_fd, memory_budget, ft::less<T>());
+    }
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstddef>
+#include "../vector/vector.hpp"
+
+namespace ft{
+    // Tournament tree for k-way merging. Each leaf holds a pointer to the current value of one input,
+    // or 0 once that input is exhausted. Internal nodes keep the loser of their match, so replacing
+    // the winner replays one leaf-to-root path: ceil(log2 k) comparisons, against a heap's two per
+    // level. Equal values go to the lower leaf, which keeps the merge stable.
+    template <class T, class Compare>
+    class loser_tree{
+        public:
+            typedef size_t size_type;
+
+            loser_tree(size_type k, const Compare &comp) : k_(k), tree_(k ? k : 1, 0), leaves_(k, (const T *)0), comp_(comp) {}
+
+            size_type size() const {
+                return k_;
+            }
+
+            void set(size_type leaf, const T *value) {
+                leaves_[leaf] = value;
+            }
+
+            // Plays every match; call once after setting all leaves.
+            void build() {
+                if (k_)
+                    tree_[0] = play(1);
+            }
+
+            // Leaf holding the smallest current value.
+            size_type top() const {
+                return tree_[0];
+            }
+
+            const T *top_value() const {
+                return k_ ? leaves_[tree_[0]] : 0;
+            }
+
+            bool empty() const {
+                return !top_value();
+            }
+
+            // Gives the winning leaf its next value (0 when exhausted) and replays its path.
+            void replace_top(const T *value) {
+                size_type winner = tree_[0];
+
+                leaves_[winner] = value;
+                for (size_type node = (winner + k_) / 2; node; node /= 2)
+                    if (beats(tree_[node], winner)) {
+                        size_type loser = winner;
+                        winner = tree_[node];
+                        tree_[node] = loser;
+                    }
+                tree_[0] = winner;
+            }
+
+        private:
+            size_type k_;
+            ft::vector<size_type> tree_;
+            ft::vector<const T *> leaves_;
+            Compare comp_;
+
+            bool beats(size_type a, size_type b) const {
+                if (!leaves_[b])
+                    return leaves_[a] || a < b;
+                if (!leaves_[a])
+                    return false;
+                if (comp_(*leaves_[a], *leaves_[b]))
+                    return true;
+                return !comp_(*leaves_[b], *leaves_[a]) && a < b;
+            }
+
+            // Leaves sit at k..2k-1, so node i has children 2i and 2i + 1 for any k.
+            size_type play(size_type node) {
+                if (node >= k_)
+                    return node - k_;
+                size_type a = play(2 * node);
+                size_type b = play(2 * node + 1);
+                if (beats(a, b)) {
+                    tree_[node] = b;
+                    return a;
+                }
+                tree_[node] = a;
+                return b;
+            }
+    };
+}
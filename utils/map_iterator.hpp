@@ -29,6 +29,14 @@ namespace ft
 
         ~rbt_iterator() {}
 
+        p_node base() const {
+            return node_;
+        }
+
+        p_node root() const {
+            return root_;
+        }
+
         rbt_iterator &operator=(const rbt_iterator &src) {
             if (this == &src)
                 return *this;
@@ -18,6 +18,14 @@ namespace ft
             return (compare_(x.first, y.first));
         }
 
+        bool operator()(const value_type &x, const Key &y) const {
+            return (compare_(x.first, y));
+        }
+
+        bool operator()(const Key &x, const value_type &y) const {
+            return (compare_(x, y.first));
+        }
+
     private:
         key_compare compare_;
     };
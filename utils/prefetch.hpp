@@ -0,0 +1,12 @@
+#pragma once
+
+namespace ft
+{
+    inline void prefetch(const void *address){
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(address);
+#else
+        (void)address;
+#endif
+    }
+}
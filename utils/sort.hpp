@@ -0,0 +1,374 @@
+#pragma once
+
+#include <memory>
+#include <cstring>
+#include <cstddef>
+#include <utility>
+#include <functional>
+#include <type_traits>
+#include "iterator_traits.hpp"
+#include "less.hpp"
+
+namespace ft
+{
+    // Iterators known to walk a plain array; sorting goes through raw pointers for them.
+    template <class Iterator>
+    struct contiguous_iterator{
+        static const bool value = false;
+    };
+
+    template <class T>
+    struct contiguous_iterator<T *>{
+        static const bool value = true;
+        static T *address(T *it) {
+            return it;
+        }
+    };
+
+    template <class T>
+    struct contiguous_iterator<ft::random_access_iterator<T> >{
+        static const bool value = true;
+        static T *address(const ft::random_access_iterator<T> &it) {
+            return it.base();
+        }
+    };
+
+    // Order-preserving map from an arithmetic key to an unsigned integer of the same width.
+    template <size_t Bytes> struct radix_word{};
+    template <> struct radix_word<1>{ typedef unsigned char type; };
+    template <> struct radix_word<2>{ typedef unsigned short type; };
+    template <> struct radix_word<4>{ typedef unsigned int type; };
+    template <> struct radix_word<8>{ typedef unsigned long long type; };
+
+    template <class T, bool Float = std::is_floating_point<T>::value>
+    struct radix_key{
+        typedef typename radix_word<sizeof(T)>::type word;
+
+        static word get(T value) {
+            word bits = static_cast<word>(value);
+
+            if (std::is_signed<T>::value)
+                bits ^= word(1) << (sizeof(T) * 8 - 1);
+            return bits;
+        }
+    };
+
+    // Negative floats sort by flipped bits, positive ones by setting the sign; -0.0 folds into +0.0.
+    template <class T>
+    struct radix_key<T, true>{
+        typedef typename radix_word<sizeof(T)>::type word;
+
+        static word get(T value) {
+            word bits;
+            const word sign = word(1) << (sizeof(T) * 8 - 1);
+
+            if (value == 0)
+                value = 0;
+            std::memcpy(&bits, &value, sizeof(T));
+            return bits & sign ? ~bits : bits | sign;
+        }
+    };
+
+    // Whether sort/stable_sort may replace comparisons with an LSD radix sort.
+    template <class Iterator, class Compare>
+    struct radix_sortable{
+        typedef typename ft::iterator_traits<Iterator>::value_type value_type;
+
+        static const bool arithmetic = (std::is_integral<value_type>::value && !std::is_same<value_type, bool>::value)
+                                       || std::is_same<value_type, float>::value || std::is_same<value_type, double>::value;
+        static const bool value = arithmetic && ft::contiguous_iterator<Iterator>::value
+                                  && (std::is_same<Compare, ft::less<value_type> >::value
+                                      || std::is_same<Compare, std::less<value_type> >::value);
+    };
+
+    namespace sort_detail
+    {
+        static const ptrdiff_t insertion_threshold = 16;
+        static const ptrdiff_t radix_threshold = 256;
+
+        // Contiguous ranges are sorted through pointers so the memmove/memcpy paths apply.
+        template <class Iterator, bool Contiguous = ft::contiguous_iterator<Iterator>::value>
+        struct raw{
+            typedef Iterator type;
+            static type get(Iterator it) {
+                return it;
+            }
+        };
+
+        template <class Iterator>
+        struct raw<Iterator, true>{
+            typedef typename ft::iterator_traits<Iterator>::value_type *type;
+            static type get(Iterator it) {
+                return ft::contiguous_iterator<Iterator>::address(it);
+            }
+        };
+
+        // Qualified: ft::swap is an unconstrained template and would make an ADL call ambiguous.
+        template <class Iterator>
+        void iter_swap(Iterator a, Iterator b) {
+            std::swap(*a, *b);
+        }
+
+        // Moves [first, last) one slot up; memmove when the elements are plain bytes.
+        template <class T>
+        void shift_up(T *first, T *last, std::true_type) {
+            std::memmove(first + 1, first, (last - first) * sizeof(T));
+        }
+
+        template <class Iterator>
+        void shift_up(Iterator first, Iterator last, std::false_type) {
+            while (last != first) {
+                Iterator prev = last;
+                --prev;
+                *last = *prev;
+                last = prev;
+            }
+        }
+
+        template <class Iterator>
+        struct bitwise_copy : std::integral_constant<bool, std::is_pointer<Iterator>::value
+            && std::is_trivially_copyable<typename ft::iterator_traits<Iterator>::value_type>::value>{};
+
+        template <class Iterator, class Compare>
+        void insertion_sort(Iterator first, Iterator last, Compare comp) {
+            typedef typename ft::iterator_traits<Iterator>::value_type value_type;
+
+            if (first == last)
+                return;
+            for (Iterator it = first + 1; it != last; ++it) {
+                value_type val = *it;
+                if (comp(val, *first)) {
+                    shift_up(first, it, bitwise_copy<Iterator>());
+                    *first = val;
+                    continue;
+                }
+                Iterator hole = it;
+                Iterator prev = it - 1;
+                while (comp(val, *prev)) {
+                    *hole = *prev;
+                    hole = prev--;
+                }
+                *hole = val;
+            }
+        }
+
+        template <class Iterator, class Compare>
+        void sift_down(Iterator first, ptrdiff_t hole, ptrdiff_t len, Compare comp) {
+            typedef typename ft::iterator_traits<Iterator>::value_type value_type;
+            value_type val = first[hole];
+
+            for (ptrdiff_t child = 2 * hole + 1; child < len; child = 2 * hole + 1) {
+                if (child + 1 < len && comp(first[child], first[child + 1]))
+                    ++child;
+                if (!comp(val, first[child]))
+                    break;
+                first[hole] = first[child];
+                hole = child;
+            }
+            first[hole] = val;
+        }
+
+        template <class Iterator, class Compare>
+        void heap_sort(Iterator first, Iterator last, Compare comp) {
+            ptrdiff_t len = last - first;
+
+            for (ptrdiff_t i = len / 2; i-- > 0;)
+                sift_down(first, i, len, comp);
+            while (len > 1) {
+                iter_swap(first, first + --len);
+                sift_down(first, 0, len, comp);
+            }
+        }
+
+        template <class Iterator, class Compare>
+        void median_to_first(Iterator first, Iterator a, Iterator b, Iterator c, Compare comp) {
+            if (comp(*a, *b)) {
+                if (comp(*b, *c))
+                    iter_swap(first, b);
+                else if (comp(*a, *c))
+                    iter_swap(first, c);
+                else
+                    iter_swap(first, a);
+            }
+            else if (comp(*a, *c))
+                iter_swap(first, a);
+            else if (comp(*b, *c))
+                iter_swap(first, c);
+            else
+                iter_swap(first, b);
+        }
+
+        // Hoare partition of (first, last) around *first; the median of three bounds both scans.
+        template <class Iterator, class Compare>
+        Iterator partition_pivot(Iterator first, Iterator last, Compare comp) {
+            Iterator mid = first + (last - first) / 2;
+            Iterator left = first + 1;
+
+            median_to_first(first, left, mid, last - 1, comp);
+            for (;;) {
+                while (comp(*left, *first))
+                    ++left;
+                --last;
+                while (comp(*first, *last))
+                    --last;
+                if (!(left < last))
+                    return left;
+                iter_swap(left, last);
+                ++left;
+            }
+        }
+
+        template <class Iterator, class Compare>
+        void introsort_loop(Iterator first, Iterator last, size_t depth, Compare comp) {
+            while (last - first > insertion_threshold) {
+                if (!depth) {
+                    heap_sort(first, last, comp);
+                    return;
+                }
+                --depth;
+                Iterator cut = partition_pivot(first, last, comp);
+                introsort_loop(cut, last, depth, comp);
+                last = cut;
+            }
+        }
+
+        template <class Iterator, class Compare>
+        void introsort(Iterator first, Iterator last, Compare comp) {
+            size_t depth = 0;
+
+            for (ptrdiff_t n = last - first; n > 1; n >>= 1)
+                depth += 2;
+            introsort_loop(first, last, depth, comp);
+            insertion_sort(first, last, comp);
+        }
+
+        // LSD radix sort, one byte per pass; passes where every key shares the byte are skipped.
+        template <class T>
+        void radix_sort(T *first, T *last) {
+            typedef radix_key<T> key;
+            typedef typename key::word word;
+            const size_t n = last - first;
+            size_t counts[sizeof(T)][256];
+            std::allocator<T> allocator;
+
+            std::memset(counts, 0, sizeof(counts));
+            for (T *it = first; it != last; ++it) {
+                word bits = key::get(*it);
+                for (size_t pass = 0; pass < sizeof(T); ++pass)
+                    ++counts[pass][(bits >> (pass * 8)) & 0xff];
+            }
+            T *buffer = allocator.allocate(n);
+            T *from = first;
+            T *to = buffer;
+            for (size_t pass = 0; pass < sizeof(T); ++pass) {
+                size_t *count = counts[pass];
+                if (count[(key::get(*first) >> (pass * 8)) & 0xff] == n)
+                    continue;
+                for (size_t i = 0, sum = 0; i < 256; ++i) {
+                    size_t c = count[i];
+                    count[i] = sum;
+                    sum += c;
+                }
+                for (size_t i = 0; i < n; ++i)
+                    to[count[(key::get(from[i]) >> (pass * 8)) & 0xff]++] = from[i];
+                std::swap(from, to);
+            }
+            if (from != first)
+                std::memcpy(first, from, n * sizeof(T));
+            allocator.deallocate(buffer, n);
+        }
+
+        // Merges [first, mid) and [mid, last) through a raw buffer holding a copy of the left run.
+        template <class Iterator, class T, class Compare>
+        void merge_runs(Iterator first, Iterator mid, Iterator last, T *buffer, Compare comp) {
+            ptrdiff_t left = mid - first;
+            ptrdiff_t i = 0;
+            Iterator out = first;
+
+            if (bitwise_copy<Iterator>::value)
+                std::memcpy(static_cast<void *>(buffer), &*first, left * sizeof(T));
+            else
+                std::uninitialized_copy(first, mid, buffer);
+            while (i < left && mid != last) {
+                if (comp(*mid, buffer[i]))
+                    *out++ = *mid++;
+                else
+                    *out++ = buffer[i++];
+            }
+            for (; i < left; ++i)
+                *out++ = buffer[i];
+            if (!std::is_trivially_destructible<T>::value)
+                for (i = 0; i < left; ++i)
+                    buffer[i].~T();
+        }
+
+        template <class Iterator, class T, class Compare>
+        void merge_sort(Iterator first, Iterator last, T *buffer, Compare comp) {
+            if (last - first <= insertion_threshold * 2) {
+                insertion_sort(first, last, comp);
+                return;
+            }
+            Iterator mid = first + (last - first) / 2;
+            merge_sort(first, mid, buffer, comp);
+            merge_sort(mid, last, buffer, comp);
+            if (comp(*mid, *(mid - 1)))
+                merge_runs(first, mid, last, buffer, comp);
+        }
+
+        template <class Iterator, class Compare>
+        void sort(Iterator first, Iterator last, Compare comp, std::true_type) {
+            typedef ft::contiguous_iterator<Iterator> contiguous;
+
+            if (last - first < radix_threshold)
+                introsort(contiguous::address(first), contiguous::address(first) + (last - first), comp);
+            else
+                radix_sort(contiguous::address(first), contiguous::address(first) + (last - first));
+        }
+
+        template <class Iterator, class Compare>
+        void sort(Iterator first, Iterator last, Compare comp, std::false_type) {
+            introsort(raw<Iterator>::get(first), raw<Iterator>::get(first) + (last - first), comp);
+        }
+
+        template <class Iterator, class Compare>
+        void stable_sort(Iterator first, Iterator last, Compare comp, std::false_type) {
+            typedef typename ft::iterator_traits<Iterator>::value_type value_type;
+            std::allocator<value_type> allocator;
+            size_t half = (last - first) / 2 + 1;
+            value_type *buffer = allocator.allocate(half);
+
+            merge_sort(raw<Iterator>::get(first), raw<Iterator>::get(first) + (last - first), buffer, comp);
+            allocator.deallocate(buffer, half);
+        }
+
+        template <class Iterator, class Compare>
+        void stable_sort(Iterator first, Iterator last, Compare comp, std::true_type) {
+            sort(first, last, comp, std::true_type());
+        }
+    }
+
+    // Introsort: quicksort with a median-of-three pivot, heap sort past 2 log n levels, insertion sort
+    // for short runs. Integer and floating keys under the default order are radix sorted instead.
+    template <class RandomIterator, class Compare>
+    void sort(RandomIterator first, RandomIterator last, Compare comp) {
+        if (last - first > 1)
+            sort_detail::sort(first, last, comp, std::integral_constant<bool, ft::radix_sortable<RandomIterator, Compare>::value>());
+    }
+
+    template <class RandomIterator>
+    void sort(RandomIterator first, RandomIterator last) {
+        ft::sort(first, last, ft::less<typename ft::iterator_traits<RandomIterator>::value_type>());
+    }
+
+    // Top-down merge sort with a buffer of half the range; radix sorted under the same rule as sort.
+    template <class RandomIterator, class Compare>
+    void stable_sort(RandomIterator first, RandomIterator last, Compare comp) {
+        if (last - first > 1)
+            sort_detail::stable_sort(first, last, comp, std::integral_constant<bool, ft::radix_sortable<RandomIterator, Compare>::value>());
+    }
+
+    template <class RandomIterator>
+    void stable_sort(RandomIterator first, RandomIterator last) {
+        ft::stable_sort(first, last, ft::less<typename ft::iterator_traits<RandomIterator>::value_type>());
+    }
+}
@@ -0,0 +1,202 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <new>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include "../utils/bits.hpp"
+#include "../utils/cache_line.hpp"
+#include "../utils/is_integral.hpp"
+#include "../utils/enable_if.hpp"
+
+namespace ft{
+    // Append-only vector for many writers. A slot is claimed with one fetch_add on the size and its
+    // segment is allocated on first use, so push_back and grow_by never lock and elements never move.
+    // A slot counts as ready once constructed; ready() is the length of the fully constructed prefix,
+    // which readers may index while writers keep appending. A copy that throws leaves its slot
+    // unconstructed and stops ready() there for good.
+    template <class T, class Alloc = std::allocator<T> >
+    class concurrent_vector
+    {
+        private:
+            struct slot{
+                typename std::aligned_storage<sizeof(T), alignof(T)>::type value;
+                std::atomic<bool> ready;
+            };
+
+        public:
+            typedef T value_type;
+            typedef T &reference;
+            typedef const T &const_reference;
+            typedef size_t size_type;
+            typedef typename Alloc::template rebind<slot>::other slot_allocator_type;
+
+            concurrent_vector() : size_(0), ready_(0) {
+                for (size_type i = 0; i < segment_count; ++i)
+                    segments_[i].store(0, std::memory_order_relaxed);
+            }
+
+            ~concurrent_vector() {
+                for (size_type i = 0; i < segment_count; ++i) {
+                    slot *segment = segments_[i].load(std::memory_order_relaxed);
+                    if (!segment)
+                        continue;
+                    for (size_type j = 0; j < segment_size(i); ++j)
+                        if (segment[j].ready.load(std::memory_order_relaxed))
+                            reinterpret_cast<T *>(&segment[j].value)->~T();
+                    allocator_.deallocate(segment, segment_size(i));
+                }
+            }
+
+            // Slots claimed so far, some possibly still under construction.
+            size_type size() const {
+                return size_.load(std::memory_order_acquire);
+            }
+
+            size_type ready() const {
+                return ready_.load(std::memory_order_acquire);
+            }
+
+            bool empty() const {
+                return !ready();
+            }
+
+            reference operator[](size_type n) {
+                return *value(n);
+            }
+
+            const_reference operator[](size_type n) const {
+                return *value(n);
+            }
+
+            reference at(size_type n) {
+                if (n < ready())
+                    return *value(n);
+                throw std::out_of_range("Error: position_ out of range");
+            }
+
+            const_reference at(size_type n) const {
+                if (n < ready())
+                    return *value(n);
+                throw std::out_of_range("Error: position_ out of range");
+            }
+
+            // Allocates the segments for the first n slots up front.
+            void reserve(size_type n) {
+                if (n)
+                    allocate(0, n);
+            }
+
+            // Returns the index of the new element.
+            size_type push_back(const value_type &val) {
+                size_type index = size_.fetch_add(1, std::memory_order_acq_rel);
+
+                allocate(index, 1);
+                construct(index, val);
+                publish();
+                return index;
+            }
+
+            // Appends n copies of val as one contiguous run of indices and returns the first one.
+            size_type grow_by(size_type n, const value_type &val = value_type()) {
+                size_type first = size_.fetch_add(n, std::memory_order_acq_rel);
+
+                if (!n)
+                    return first;
+                allocate(first, n);
+                for (size_type i = 0; i < n; ++i)
+                    construct(first + i, val);
+                publish();
+                return first;
+            }
+
+            template <class ForwardIterator>
+            size_type grow_by(ForwardIterator first, ForwardIterator last,
+                              typename ft::enable_if<!ft::is_integral<ForwardIterator>::value>::type* = nullptr) {
+                size_type n = 0;
+
+                for (ForwardIterator it = first; it != last; ++it)
+                    ++n;
+                size_type start = size_.fetch_add(n, std::memory_order_acq_rel);
+                if (!n)
+                    return start;
+                allocate(start, n);
+                for (size_type i = start; first != last; ++first, ++i)
+                    construct(i, *first);
+                publish();
+                return start;
+            }
+
+        private:
+            concurrent_vector(const concurrent_vector &);
+            concurrent_vector &operator=(const concurrent_vector &);
+
+            static const unsigned base_shift = 5;
+            static const size_type segment_count = 8 * sizeof(size_type) - base_shift;
+
+            // A full line after each hot word keeps size_, ready_ and the segment table on separate
+            // lines wherever the object lands; alignas would not survive plain new before C++17.
+            std::atomic<size_type> size_;
+            char size_pad_[ft::cache_line_size];
+            std::atomic<size_type> ready_;
+            char ready_pad_[ft::cache_line_size];
+            std::atomic<slot *> segments_[segment_count];
+            slot_allocator_type allocator_;
+
+            static size_type segment_size(size_type segment) {
+                return size_type(1) << (segment + base_shift);
+            }
+
+            // Index i lives in segment s at offset o where i + 2^base_shift == 2^(s + base_shift) + o.
+            static size_type segment_of(size_type index) {
+                return ft::log2_floor(index + (size_type(1) << base_shift)) - base_shift;
+            }
+
+            slot *at_slot(size_type index) const {
+                size_type segment = segment_of(index);
+                size_type offset = index + (size_type(1) << base_shift) - segment_size(segment);
+
+                return segments_[segment].load(std::memory_order_acquire) + offset;
+            }
+
+            T *value(size_type index) const {
+                return reinterpret_cast<T *>(&at_slot(index)->value);
+            }
+
+            // Makes sure every segment under [first, first + n) exists; racing writers allocate the
+            // same segment at most once each and the losers give theirs back.
+            void allocate(size_type first, size_type n) {
+                size_type last = segment_of(first + n - 1);
+
+                for (size_type s = segment_of(first); s <= last; ++s) {
+                    if (segments_[s].load(std::memory_order_acquire))
+                        continue;
+                    slot *fresh = allocator_.allocate(segment_size(s));
+                    for (size_type j = 0; j < segment_size(s); ++j)
+                        new (&fresh[j].ready) std::atomic<bool>(false);
+                    slot *expected = 0;
+                    if (!segments_[s].compare_exchange_strong(expected, fresh, std::memory_order_acq_rel))
+                        allocator_.deallocate(fresh, segment_size(s));
+                }
+            }
+
+            void construct(size_type index, const value_type &val) {
+                slot *target = at_slot(index);
+
+                new (&target->value) T(val);
+                target->ready.store(true);
+            }
+
+            // Moves the watermark over every ready slot. Flags and watermark are sequentially
+            // consistent, so of two writers finishing next to each other at least one sees the other.
+            void publish() {
+                size_type mark = ready_.load();
+
+                while (mark < size_.load() && segments_[segment_of(mark)].load() && at_slot(mark)->ready.load())
+                    if (ready_.compare_exchange_weak(mark, mark + 1))
+                        ++mark;
+            }
+    };
+}
@@ -0,0 +1,207 @@
+#pragma once
+
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include "../utils/bits.hpp"
+#include "../utils/enable_if.hpp"
+#include "../utils/is_integral.hpp"
+#include "../utils/iterator_traits.hpp"
+#include "../utils/utils.hpp"
+#include "vector.hpp"
+#include "span.hpp"
+#include "packed_vector.hpp"
+
+namespace ft{
+    // Non-decreasing unsigned integers in frame-of-reference blocks of block_size values. A full
+    // block keeps its first value in the skip index and every value as its offset from it, packed
+    // at the width of the block's largest offset; dense sorted ids need a few bits each. Element n
+    // is one skip index lookup and one unaligned read away, lower_bound searches the skip index
+    // before the block, and the last, still open block stays uncompressed until it fills.
+    template <class T = unsigned long long>
+    class delta_vector{
+        public:
+            typedef T value_type;
+            typedef size_t size_type;
+            typedef ptrdiff_t difference_type;
+            typedef packed_detail::value_iterator<delta_vector> const_iterator;
+            typedef const_iterator iterator;
+            typedef ft::reverse_iterator<const_iterator> const_reverse_iterator;
+            typedef const_reverse_iterator reverse_iterator;
+
+            static const size_type block_size = 128;
+
+            delta_vector() : words_(2, 0) {
+                static_assert(std::is_integral<T>::value && std::is_unsigned<T>::value,
+                              "ft::delta_vector needs an unsigned integer type");
+            }
+
+            template <class InputIterator>
+            delta_vector(InputIterator first, InputIterator last,
+                         typename ft::enable_if<!ft::is_integral<InputIterator>::value>::type* = 0) : words_(2, 0) {
+                for (; first != last; ++first)
+                    push_back(*first);
+            }
+
+            const_iterator begin() const {
+                return const_iterator(this, 0);
+            }
+
+            const_iterator end() const {
+                return const_iterator(this, size());
+            }
+
+            const_reverse_iterator rbegin() const {
+                return const_reverse_iterator(end());
+            }
+
+            const_reverse_iterator rend() const {
+                return const_reverse_iterator(begin());
+            }
+
+            size_type size() const {
+                return blocks_.size() * block_size + tail_.size();
+            }
+
+            bool empty() const {
+                return !size();
+            }
+
+            // Bytes of packed words, skip index and open block.
+            size_type storage_bytes() const {
+                return words_.size() * sizeof(packed_detail::word) + blocks_.size() * sizeof(block)
+                    + tail_.size() * sizeof(T);
+            }
+
+            value_type operator[](size_type n) const {
+                size_type b = n / block_size;
+
+                if (b == blocks_.size())
+                    return tail_[n % block_size];
+                const block &entry = blocks_[b];
+                return entry.base + static_cast<T>(packed_detail::extract(&words_[0],
+                                                                          entry.bit + (n % block_size) * entry.width, entry.width));
+            }
+
+            value_type at(size_type n) const {
+                if (n < size())
+                    return (*this)[n];
+                throw std::out_of_range("Error: position_ out of range");
+            }
+
+            value_type front() const {
+                return (*this)[0];
+            }
+
+            value_type back() const {
+                return tail_.empty() ? (*this)[size() - 1] : tail_[tail_.size() - 1];
+            }
+
+            // val must not be less than back().
+            void push_back(value_type val) {
+                if (!empty() && val < back())
+                    throw std::invalid_argument("ft::delta_vector: values must not decrease");
+                tail_.push_back(val);
+                if (tail_.size() == block_size)
+                    seal();
+            }
+
+            // First position whose value is not less than val.
+            const_iterator lower_bound(value_type val) const {
+                size_type lo = 0;
+                size_type hi = blocks_.size();
+
+                while (lo < hi) {
+                    size_type mid = lo + (hi - lo) / 2;
+                    if (blocks_[mid].base < val)
+                        lo = mid + 1;
+                    else
+                        hi = mid;
+                }
+                // Block lo starts at or after val, so the answer is in block lo - 1 or at lo's start.
+                size_type first = lo ? (lo - 1) * block_size : 0;
+                size_type last = lo < blocks_.size() ? lo * block_size : size();
+                while (first < last) {
+                    size_type mid = first + (last - first) / 2;
+                    if ((*this)[mid] < val)
+                        first = mid + 1;
+                    else
+                        last = mid;
+                }
+                return const_iterator(this, first);
+            }
+
+            bool contains(value_type val) const {
+                const_iterator it = lower_bound(val);
+                return it != end() && *it == val;
+            }
+
+            // Unpacks out.size() values starting at first, a block at a time.
+            void decode(size_type first, ft::span<value_type> out) const {
+                if (first > size() || out.size() > size() - first)
+                    throw std::out_of_range("Error: position_ out of range");
+                value_type *dest = out.data();
+                size_type left = out.size();
+                while (left) {
+                    size_type b = first / block_size;
+                    size_type offset = first % block_size;
+                    size_type count = block_size - offset < left ? block_size - offset : left;
+                    if (b == blocks_.size()) {
+                        for (size_type i = 0; i < count; ++i)
+                            dest[i] = tail_[offset + i];
+                    }
+                    else {
+                        const block &entry = blocks_[b];
+                        packed_detail::unpack_offset(&words_[0], entry.bit + offset * entry.width, entry.width,
+                                                     entry.base, dest, count);
+                    }
+                    dest += count;
+                    first += count;
+                    left -= count;
+                }
+            }
+
+            void clear() {
+                words_.clear();
+                words_.resize(2, 0);
+                blocks_.clear();
+                tail_.clear();
+            }
+
+            void swap(delta_vector &x) {
+                words_.swap(x.words_);
+                blocks_.swap(x.blocks_);
+                tail_.swap(x.tail_);
+            }
+
+        private:
+            struct block{
+                T base;
+                unsigned width;
+                size_t bit;
+            };
+
+            ft::vector<packed_detail::word> words_;
+            ft::vector<block> blocks_;
+            ft::vector<T> tail_;
+
+            // Packs the full open block behind the previous ones. Blocks take whole words, so each
+            // starts word-aligned and the padding word stays last. Blocks of equal values take no
+            // words and read the always-zero word 0.
+            void seal() {
+                block entry;
+                entry.base = tail_[0];
+                T spread = tail_[block_size - 1] - entry.base;
+                entry.width = spread ? ft::log2_floor(spread) + 1 : 0;
+                entry.bit = entry.width ? (words_.size() - 1) * 64 : 0;
+                words_.resize(words_.size() + block_size * entry.width / 64, 0);
+                for (size_type i = 0; i < block_size; ++i)
+                    packed_detail::deposit(&words_[0], entry.bit + i * entry.width, entry.width, tail_[i] - entry.base);
+                blocks_.push_back(entry);
+                tail_.clear();
+            }
+    };
+
+    template <class T>
+    const size_t delta_vector<T>::block_size;
+}
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <cerrno>
+#include <cstddef>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "../utils/iterator_traits.hpp"
+#include "../utils/utils.hpp"
+#include "vector_io.hpp"
+
+namespace ft{
+    // Read-only view of a file written by ft::save. The file is mapped and the elements are used in
+    // place, so opening costs no copy and pages are read in on first access.
+    template <class T>
+    class mapped_vector_view{
+        public:
+            typedef T value_type;
+            typedef const T &const_reference;
+            typedef const T &reference;
+            typedef const T *const_pointer;
+            typedef const T *pointer;
+            typedef ft::random_access_iterator<const value_type> const_iterator;
+            typedef const_iterator iterator;
+            typedef ft::reverse_iterator<const_iterator> const_reverse_iterator;
+            typedef const_reverse_iterator reverse_iterator;
+            typedef ptrdiff_t difference_type;
+            typedef size_t size_type;
+
+            explicit mapped_vector_view(const char *path) : map_(0), length_(0), data_(0), size_(0) {
+                static_assert(std::is_trivially_copyable<T>::value, "mapped_vector_view needs a trivially copyable T");
+                int fd = ::open(path, O_RDONLY);
+                struct stat info;
+
+                if (fd < 0)
+                    throw std::system_error(errno, std::generic_category(), "ft::mapped_vector_view");
+                if (fstat(fd, &info) < 0) {
+                    int error = errno;
+                    ::close(fd);
+                    throw std::system_error(error, std::generic_category(), "ft::mapped_vector_view");
+                }
+                length_ = static_cast<size_t>(info.st_size);
+                if (length_ < sizeof(vector_file_header)) {
+                    ::close(fd);
+                    throw std::runtime_error("ft::mapped_vector_view: truncated file");
+                }
+                void *p = mmap(0, length_, PROT_READ, MAP_SHARED, fd, 0);
+                int error = errno;
+                ::close(fd);
+                if (p == MAP_FAILED)
+                    throw std::system_error(error, std::generic_category(), "ft::mapped_vector_view");
+                map_ = p;
+                try {
+                    const vector_file_header &header = *static_cast<const vector_file_header *>(map_);
+                    vector_io_detail::check_header(header, sizeof(T));
+                    if (header.data_offset % alignof(T) || header.data_offset > length_
+                        || header.count > (length_ - header.data_offset) / sizeof(T))
+                        throw std::runtime_error("ft::mapped_vector_view: truncated file");
+                    data_ = reinterpret_cast<const T *>(static_cast<const char *>(map_) + header.data_offset);
+                    size_ = header.count;
+                }
+                catch (...) {
+                    munmap(map_, length_);
+                    throw;
+                }
+            }
+
+            ~mapped_vector_view() {
+                munmap(map_, length_);
+            }
+
+            const_iterator begin() const {
+                return const_iterator(data_);
+            }
+
+            const_iterator end() const {
+                return const_iterator(data_ + size_);
+            }
+
+            const_reverse_iterator rbegin() const {
+                return const_reverse_iterator(end());
+            }
+
+            const_reverse_iterator rend() const {
+                return const_reverse_iterator(begin());
+            }
+
+            size_type size() const {
+                return size_;
+            }
+
+            bool empty() const {
+                return !size_;
+            }
+
+            const_reference operator[](size_type n) const {
+                return data_[n];
+            }
+
+            const_reference at(size_type n) const {
+                if (n < size_)
+                    return data_[n];
+                throw std::out_of_range("Error: position_ out of range");
+            }
+
+            const_reference front() const {
+                return data_[0];
+            }
+
+            const_reference back() const {
+                return data_[size_ - 1];
+            }
+
+            const_pointer data() const {
+                return data_;
+            }
+
+            // Asks the kernel to start reading the whole file ahead of the first scan.
+            void will_need() const {
+                madvise(map_, length_, MADV_WILLNEED);
+            }
+
+        private:
+            mapped_vector_view(const mapped_vector_view &);
+            mapped_vector_view &operator=(const mapped_vector_view &);
+
+            void *map_;
+            size_t length_;
+            const T *data_;
+            size_type size_;
+    };
+}
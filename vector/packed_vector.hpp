@@ -0,0 +1,341 @@
+#pragma once
+
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include "../utils/iterator_traits.hpp"
+#include "../utils/utils.hpp"
+#include "vector.hpp"
+#include "span.hpp"
+
+namespace ft{
+    namespace packed_detail
+    {
+        typedef unsigned long long word;
+
+        inline word mask(unsigned width) {
+            return width ? ~word(0) >> (64 - width) : 0;
+        }
+
+        // Words holding count values of width bits, plus the padding word that lets every read
+        // touch two words without a branch.
+        inline size_t words_for(size_t count, unsigned width) {
+            return (count * width + 63) / 64 + 1;
+        }
+
+        inline word extract(const word *words, size_t bit, unsigned width) {
+            const word *p = words + (bit >> 6);
+            unsigned offset = bit & 63;
+
+            return ((p[0] >> offset) | ((p[1] << 1) << (63 - offset))) & mask(width);
+        }
+
+        inline void deposit(word *words, size_t bit, unsigned width, word value) {
+            word *p = words + (bit >> 6);
+            unsigned offset = bit & 63;
+            word m = mask(width);
+
+            p[0] = (p[0] & ~(m << offset)) | (value << offset);
+            if (offset + width > 64) {
+                unsigned high = 64 - offset;
+                p[1] = (p[1] & ~(m >> high)) | (value >> high);
+            }
+        }
+
+        // Every value is located from its own index, so the iterations are independent and the
+        // loop vectorises; with a constant width the shifts and masks become immediates.
+        template <class T>
+        void unpack(const word *words, size_t bit, unsigned width, T *out, size_t count) {
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC ivdep
+#endif
+            for (size_t i = 0; i < count; ++i)
+                out[i] = static_cast<T>(extract(words, bit + i * width, width));
+        }
+
+        template <class T>
+        void unpack_offset(const word *words, size_t bit, unsigned width, T base, T *out, size_t count) {
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC ivdep
+#endif
+            for (size_t i = 0; i < count; ++i)
+                out[i] = base + static_cast<T>(extract(words, bit + i * width, width));
+        }
+
+        // Random access iterator over a container that hands out values rather than references.
+        template <class Container>
+        class value_iterator{
+            public:
+                typedef std::random_access_iterator_tag iterator_category;
+                typedef typename Container::value_type value_type;
+                typedef ptrdiff_t difference_type;
+                typedef const value_type *pointer;
+                typedef value_type reference;
+
+                value_iterator() : container_(0), index_(0) {}
+
+                value_iterator(const Container *container, size_t index) : container_(container), index_(index) {}
+
+                size_t index() const {
+                    return index_;
+                }
+
+                reference operator*() const {
+                    return (*container_)[index_];
+                }
+
+                reference operator[](difference_type n) const {
+                    return (*container_)[index_ + n];
+                }
+
+                value_iterator &operator++() {
+                    ++index_;
+                    return *this;
+                }
+
+                value_iterator operator++(int) {
+                    value_iterator tmp = *this;
+                    ++index_;
+                    return tmp;
+                }
+
+                value_iterator &operator--() {
+                    --index_;
+                    return *this;
+                }
+
+                value_iterator operator--(int) {
+                    value_iterator tmp = *this;
+                    --index_;
+                    return tmp;
+                }
+
+                value_iterator &operator+=(difference_type n) {
+                    index_ += n;
+                    return *this;
+                }
+
+                value_iterator &operator-=(difference_type n) {
+                    index_ -= n;
+                    return *this;
+                }
+
+                value_iterator operator+(difference_type n) const {
+                    return value_iterator(container_, index_ + n);
+                }
+
+                value_iterator operator-(difference_type n) const {
+                    return value_iterator(container_, index_ - n);
+                }
+
+                difference_type operator-(const value_iterator &it) const {
+                    return difference_type(index_) - difference_type(it.index_);
+                }
+
+                bool operator==(const value_iterator &it) const {
+                    return index_ == it.index_;
+                }
+
+                bool operator!=(const value_iterator &it) const {
+                    return index_ != it.index_;
+                }
+
+                bool operator<(const value_iterator &it) const {
+                    return index_ < it.index_;
+                }
+
+                bool operator>(const value_iterator &it) const {
+                    return index_ > it.index_;
+                }
+
+                bool operator<=(const value_iterator &it) const {
+                    return index_ <= it.index_;
+                }
+
+                bool operator>=(const value_iterator &it) const {
+                    return index_ >= it.index_;
+                }
+
+            private:
+                const Container *container_;
+                size_t index_;
+        };
+    }
+
+    // Unsigned integers of Bits bits each, stored back to back in 64-bit words: a column of 20-bit
+    // ids takes 20 bits per value instead of 32. Values are read and written by index, and decode
+    // unpacks a whole range into a span for scans. A value wider than Bits is rejected.
+    template <unsigned Bits>
+    class packed_vector{
+        public:
+            typedef typename std::conditional<(Bits <= 32), unsigned, unsigned long long>::type value_type;
+            typedef size_t size_type;
+            typedef ptrdiff_t difference_type;
+            typedef packed_detail::value_iterator<packed_vector> const_iterator;
+            typedef const_iterator iterator;
+            typedef ft::reverse_iterator<const_iterator> const_reverse_iterator;
+            typedef const_reverse_iterator reverse_iterator;
+
+            static const unsigned bits = Bits;
+
+            packed_vector() : words_(1, 0), size_(0) {
+                static_assert(Bits >= 1 && Bits <= 64, "ft::packed_vector needs 1 to 64 bits per value");
+            }
+
+            explicit packed_vector(size_type n, value_type val = 0) : words_(1, 0), size_(0) {
+                static_assert(Bits >= 1 && Bits <= 64, "ft::packed_vector needs 1 to 64 bits per value");
+                resize(n, val);
+            }
+
+            const_iterator begin() const {
+                return const_iterator(this, 0);
+            }
+
+            const_iterator end() const {
+                return const_iterator(this, size_);
+            }
+
+            const_reverse_iterator rbegin() const {
+                return const_reverse_iterator(end());
+            }
+
+            const_reverse_iterator rend() const {
+                return const_reverse_iterator(begin());
+            }
+
+            size_type size() const {
+                return size_;
+            }
+
+            bool empty() const {
+                return !size_;
+            }
+
+            // Bytes of packed storage, padding word included.
+            size_type storage_bytes() const {
+                return words_.size() * sizeof(packed_detail::word);
+            }
+
+            void reserve(size_type n) {
+                words_.reserve(packed_detail::words_for(n, Bits));
+            }
+
+            value_type operator[](size_type n) const {
+                return static_cast<value_type>(packed_detail::extract(&words_[0], n * Bits, Bits));
+            }
+
+            value_type at(size_type n) const {
+                if (n < size_)
+                    return (*this)[n];
+                throw std::out_of_range("Error: position_ out of range");
+            }
+
+            value_type front() const {
+                return (*this)[0];
+            }
+
+            value_type back() const {
+                return (*this)[size_ - 1];
+            }
+
+            void set(size_type n, value_type val) {
+                check(val);
+                packed_detail::deposit(&words_[0], n * Bits, Bits, val);
+            }
+
+            void push_back(value_type val) {
+                check(val);
+                grow(size_ + 1);
+                packed_detail::deposit(&words_[0], size_ * Bits, Bits, val);
+                ++size_;
+            }
+
+            void pop_back() {
+                --size_;
+                packed_detail::deposit(&words_[0], size_ * Bits, Bits, 0);
+            }
+
+            // Appends every value of s, checking their width once for the whole batch.
+            void append(ft::span<const value_type> s) {
+                value_type wide = 0;
+
+                for (size_type i = 0; i < s.size(); ++i)
+                    wide |= s[i];
+                check(wide);
+                grow(size_ + s.size());
+                for (size_type i = 0; i < s.size(); ++i)
+                    packed_detail::deposit(&words_[0], (size_ + i) * Bits, Bits, s[i]);
+                size_ += s.size();
+            }
+
+            // Unpacks out.size() values starting at first.
+            void decode(size_type first, ft::span<value_type> out) const {
+                if (first > size_ || out.size() > size_ - first)
+                    throw std::out_of_range("Error: position_ out of range");
+                packed_detail::unpack(&words_[0], first * Bits, Bits, out.data(), out.size());
+            }
+
+            void resize(size_type n, value_type val = 0) {
+                check(val);
+                if (n < size_) {
+                    words_.resize(packed_detail::words_for(n, Bits));
+                    words_.back() = 0;
+                    if ((n * Bits) & 63)
+                        words_[words_.size() - 2] &= packed_detail::mask((n * Bits) & 63);
+                    size_ = n;
+                    return;
+                }
+                grow(n);
+                if (val)
+                    for (size_type i = size_; i < n; ++i)
+                        packed_detail::deposit(&words_[0], i * Bits, Bits, val);
+                size_ = n;
+            }
+
+            void clear() {
+                words_.clear();
+                words_.push_back(0);
+                size_ = 0;
+            }
+
+            void swap(packed_vector &x) {
+                words_.swap(x.words_);
+                std::swap(size_, x.size_);
+            }
+
+        private:
+            ft::vector<packed_detail::word> words_;
+            size_type size_;
+
+            static void check(value_type val) {
+                if (Bits < 64 && (static_cast<packed_detail::word>(val) >> (Bits % 64)))
+                    throw std::out_of_range("ft::packed_vector: value wider than Bits");
+            }
+
+            // New words come in zeroed, so writes past size_ only ever OR into clean bits.
+            void grow(size_type n) {
+                size_type words = packed_detail::words_for(n, Bits);
+
+                if (words > words_.size())
+                    words_.resize(words, 0);
+            }
+    };
+
+    template <unsigned Bits>
+    const unsigned packed_vector<Bits>::bits;
+
+    template <unsigned Bits>
+    bool operator==(const packed_vector<Bits> &lhs, const packed_vector<Bits> &rhs) {
+        if (lhs.size() != rhs.size())
+            return false;
+        for (size_t i = 0; i < lhs.size(); ++i)
+            if (lhs[i] != rhs[i])
+                return false;
+        return true;
+    }
+
+    template <unsigned Bits>
+    bool operator!=(const packed_vector<Bits> &lhs, const packed_vector<Bits> &rhs) {
+        return !(lhs == rhs);
+    }
+}
@@ -0,0 +1,358 @@
+#pragma once
+
+#include <memory>
+#include <cstddef>
+#include <stdexcept>
+#include "../utils/iterator_traits.hpp"
+#include "../utils/utils.hpp"
+#include "../utils/switch_const.hpp"
+#include "../utils/chunk_shift.hpp"
+#include "vector.hpp"
+
+namespace ft{
+    template <typename T, typename Table, size_t Shift>
+    class segmented_iterator{
+    public:
+        typedef std::random_access_iterator_tag iterator_category;
+        typedef typename ft::switch_const<T>::type value_type;
+        typedef ptrdiff_t difference_type;
+        typedef T *pointer;
+        typedef T &reference;
+
+        segmented_iterator() : table_(0), index_(0) {}
+
+        segmented_iterator(const Table *table, size_t index) : table_(table), index_(index) {}
+
+        size_t index() const {
+            return index_;
+        }
+
+        reference operator*() const {
+            return (*table_)[index_ >> Shift][index_ & ((size_t(1) << Shift) - 1)];
+        }
+
+        pointer operator->() const {
+            return &(operator*());
+        }
+
+        reference operator[](difference_type n) const {
+            return *(*this + n);
+        }
+
+        segmented_iterator &operator++() {
+            ++index_;
+            return *this;
+        }
+
+        segmented_iterator operator++(int) {
+            segmented_iterator tmp = *this;
+            ++index_;
+            return tmp;
+        }
+
+        segmented_iterator &operator--() {
+            --index_;
+            return *this;
+        }
+
+        segmented_iterator operator--(int) {
+            segmented_iterator tmp = *this;
+            --index_;
+            return tmp;
+        }
+
+        segmented_iterator &operator+=(difference_type n) {
+            index_ += n;
+            return *this;
+        }
+
+        segmented_iterator &operator-=(difference_type n) {
+            index_ -= n;
+            return *this;
+        }
+
+        segmented_iterator operator+(difference_type n) const {
+            return segmented_iterator(table_, index_ + n);
+        }
+
+        segmented_iterator operator-(difference_type n) const {
+            return segmented_iterator(table_, index_ - n);
+        }
+
+        difference_type operator-(const segmented_iterator &it) const {
+            return difference_type(index_) - difference_type(it.index_);
+        }
+
+        bool operator==(const segmented_iterator &it) const {
+            return index_ == it.index_;
+        }
+
+        bool operator!=(const segmented_iterator &it) const {
+            return index_ != it.index_;
+        }
+
+        bool operator<(const segmented_iterator &it) const {
+            return index_ < it.index_;
+        }
+
+        bool operator>(const segmented_iterator &it) const {
+            return index_ > it.index_;
+        }
+
+        bool operator<=(const segmented_iterator &it) const {
+            return index_ <= it.index_;
+        }
+
+        bool operator>=(const segmented_iterator &it) const {
+            return index_ >= it.index_;
+        }
+
+        operator segmented_iterator<const T, Table, Shift>() const {
+            return segmented_iterator<const T, Table, Shift>(table_, index_);
+        }
+
+    private:
+        const Table *table_;
+        size_t index_;
+    };
+
+    // Elements live in fixed power-of-two chunks that never move, so references survive push_back.
+    template <typename T, size_t ChunkShift = ft::chunk_shift<T, 65536>::value, typename Alloc = std::allocator<T> >
+    class segmented_vector{
+        public:
+            typedef T value_type;
+            typedef Alloc allocator_type;
+            typedef typename allocator_type::reference reference;
+            typedef typename allocator_type::const_reference const_reference;
+            typedef typename allocator_type::const_pointer const_pointer;
+            typedef typename allocator_type::pointer pointer;
+            typedef typename allocator_type::size_type size_type;
+            typedef typename Alloc::template rebind<pointer>::other table_allocator_type;
+            typedef ft::vector<pointer, table_allocator_type> table_type;
+            typedef ft::segmented_iterator<value_type, table_type, ChunkShift> iterator;
+            typedef ft::segmented_iterator<const value_type, table_type, ChunkShift> const_iterator;
+            typedef ft::reverse_iterator<iterator> reverse_iterator;
+            typedef ft::reverse_iterator<const_iterator> const_reverse_iterator;
+            typedef typename iterator::difference_type difference_type;
+
+            static const size_type chunk_size = size_type(1) << ChunkShift;
+
+            explicit segmented_vector(const allocator_type &allocator = allocator_type())
+                : allocator_(allocator), size_(0) {}
+
+            explicit segmented_vector(size_type n, const value_type &val = value_type(), const allocator_type &allocator = allocator_type())
+                : allocator_(allocator), size_(0) {
+                try {
+                    resize(n, val);
+                } catch (...) {
+                    clear();
+                    throw;
+                }
+            }
+
+            segmented_vector(const segmented_vector &x) : allocator_(x.allocator_), size_(0) {
+                try {
+                    for (size_type i = 0; i < x.size_; ++i)
+                        push_back(x[i]);
+                } catch (...) {
+                    clear();
+                    throw;
+                }
+            }
+
+            ~segmented_vector() {
+                clear();
+            }
+
+            segmented_vector &operator=(const segmented_vector &x) {
+                if (&x != this) {
+                    segmented_vector copy(x);
+                    swap(copy);
+                }
+                return *this;
+            }
+
+            iterator begin() {
+                return iterator(&table_, 0);
+            }
+
+            const_iterator begin() const {
+                return const_iterator(&table_, 0);
+            }
+
+            iterator end() {
+                return iterator(&table_, size_);
+            }
+
+            const_iterator end() const {
+                return const_iterator(&table_, size_);
+            }
+
+            reverse_iterator rbegin() {
+                return reverse_iterator(end());
+            }
+
+            const_reverse_iterator rbegin() const {
+                return const_reverse_iterator(end());
+            }
+
+            reverse_iterator rend() {
+                return reverse_iterator(begin());
+            }
+
+            const_reverse_iterator rend() const {
+                return const_reverse_iterator(begin());
+            }
+
+            size_type size() const {
+                return size_;
+            }
+
+            size_type max_size() const {
+                return allocator_.max_size();
+            }
+
+            size_type capacity() const {
+                return table_.size() << ChunkShift;
+            }
+
+            bool empty() const {
+                return !size_;
+            }
+
+            void resize(size_type n, value_type val = value_type()) {
+                while (size_ > n)
+                    pop_back();
+                while (size_ < n)
+                    push_back(val);
+            }
+
+            const_reference operator[](size_type n) const {
+                return table_[n >> ChunkShift][n & (chunk_size - 1)];
+            }
+
+            reference operator[](size_type n) {
+                return table_[n >> ChunkShift][n & (chunk_size - 1)];
+            }
+
+            const_reference at(size_type n) const {
+                if (n < size_)
+                    return (*this)[n];
+                throw std::out_of_range("Error: position_ out of range");
+            }
+
+            reference at(size_type n) {
+                if (n < size_)
+                    return (*this)[n];
+                throw std::out_of_range("Error: position_ out of range");
+            }
+
+            const_reference front() const {
+                return (*this)[0];
+            }
+
+            reference front() {
+                return (*this)[0];
+            }
+
+            const_reference back() const {
+                return (*this)[size_ - 1];
+            }
+
+            reference back() {
+                return (*this)[size_ - 1];
+            }
+
+            // A fresh chunk joins the table only once its first element is built, so a throwing copy
+            // or table growth leaves neither a leaked chunk nor an empty one behind.
+            void push_back(const value_type &val) {
+                if (size_ < capacity()) {
+                    allocator_.construct(&(*this)[size_], val);
+                    ++size_;
+                    return;
+                }
+                pointer chunk = allocator_.allocate(chunk_size);
+                bool built = false;
+                try {
+                    allocator_.construct(chunk, val);
+                    built = true;
+                    table_.push_back(chunk);
+                } catch (...) {
+                    if (built)
+                        allocator_.destroy(chunk);
+                    allocator_.deallocate(chunk, chunk_size);
+                    throw;
+                }
+                ++size_;
+            }
+
+            void pop_back() {
+                if (!size_)
+                    return;
+                --size_;
+                allocator_.destroy(&(*this)[size_]);
+                if (!(size_ & (chunk_size - 1))) {
+                    allocator_.deallocate(table_.back(), chunk_size);
+                    table_.pop_back();
+                }
+            }
+
+            void clear() {
+                while (size_)
+                    pop_back();
+                while (!table_.empty()) {
+                    allocator_.deallocate(table_.back(), chunk_size);
+                    table_.pop_back();
+                }
+            }
+
+            allocator_type get_allocator() const {
+                return allocator_;
+            }
+
+            void swap(segmented_vector &x) {
+                table_.swap(x.table_);
+                ft::swap(size_, x.size_);
+            }
+
+        private:
+            allocator_type allocator_;
+            table_type table_;
+            size_type size_;
+    };
+
+    template<class T, size_t S, class Alloc>
+    bool operator==(const ft::segmented_vector<T, S, Alloc> &lhs, const ft::segmented_vector<T, S, Alloc> &rhs) {
+        return lhs.size() == rhs.size() && ft::equal(lhs.begin(), lhs.end(), rhs.begin());
+    }
+
+    template<class T, size_t S, class Alloc>
+    bool operator!=(const ft::segmented_vector<T, S, Alloc> &lhs, const ft::segmented_vector<T, S, Alloc> &rhs) {
+        return !(lhs == rhs);
+    }
+
+    template<class T, size_t S, class Alloc>
+    bool operator<(const ft::segmented_vector<T, S, Alloc> &lhs, const ft::segmented_vector<T, S, Alloc> &rhs) {
+        return ft::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+
+    template<class T, size_t S, class Alloc>
+    bool operator>(const ft::segmented_vector<T, S, Alloc> &lhs, const ft::segmented_vector<T, S, Alloc> &rhs) {
+        return rhs < lhs;
+    }
+
+    template<class T, size_t S, class Alloc>
+    bool operator<=(const ft::segmented_vector<T, S, Alloc> &lhs, const ft::segmented_vector<T, S, Alloc> &rhs) {
+        return !(rhs < lhs);
+    }
+
+    template<class T, size_t S, class Alloc>
+    bool operator>=(const ft::segmented_vector<T, S, Alloc> &lhs, const ft::segmented_vector<T, S, Alloc> &rhs) {
+        return !(lhs < rhs);
+    }
+
+    template<class T, size_t S, class Alloc>
+    void swap(ft::segmented_vector<T, S, Alloc> &x, ft::segmented_vector<T, S, Alloc> &y) {
+        x.swap(y);
+    }
+}
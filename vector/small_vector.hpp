@@ -0,0 +1,369 @@
+#pragma once
+
+#include <memory>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include "../utils/iterator_traits.hpp"
+#include "../utils/is_integral.hpp"
+#include "../utils/enable_if.hpp"
+#include "../utils/utils.hpp"
+
+namespace ft{
+    // ft::vector whose first N elements live inside the object; it only allocates once it grows past N.
+    template <typename T, size_t N, typename Alloc = std::allocator<T> >
+    class small_vector{
+        public:
+            typedef T value_type;
+            typedef Alloc allocator_type;
+            typedef typename allocator_type::reference reference;
+            typedef typename allocator_type::const_reference const_reference;
+            typedef typename allocator_type::const_pointer const_pointer;
+            typedef typename allocator_type::pointer pointer;
+            typedef ft::random_access_iterator<value_type> iterator;
+            typedef ft::random_access_iterator<const value_type> const_iterator;
+            typedef ft::reverse_iterator<iterator> reverse_iterator;
+            typedef ft::reverse_iterator<const_iterator> const_reverse_iterator;
+            typedef typename ft::iterator_traits<iterator>::difference_type difference_type;
+            typedef typename allocator_type::size_type size_type;
+
+            static const size_type inline_capacity = N ? N : 1;
+
+            explicit small_vector(const allocator_type &allocator = allocator_type())
+                : allocator_(allocator), data_(inline_data()), capacity_(inline_capacity), size_(0) {}
+
+            explicit small_vector(size_type n, const value_type &val = value_type(), const allocator_type &allocator = allocator_type())
+                : allocator_(allocator), data_(inline_data()), capacity_(inline_capacity), size_(0) {
+                assign(n, val);
+            }
+
+            template<class TemplateIterator>
+            small_vector(TemplateIterator first, TemplateIterator last, const allocator_type &allocator = allocator_type(),
+                   typename ft::enable_if<!ft::is_integral<TemplateIterator>::value>::type* = 0)
+                : allocator_(allocator), data_(inline_data()), capacity_(inline_capacity), size_(0) {
+                assign(first, last);
+            }
+
+            small_vector(const small_vector &x)
+                : allocator_(x.allocator_), data_(inline_data()), capacity_(inline_capacity), size_(0) {
+                assign(x.begin(), x.end());
+            }
+
+            ~small_vector() {
+                clear();
+                if (!is_inline())
+                    allocator_.deallocate(data_, capacity_);
+            }
+
+            small_vector &operator=(const small_vector &x) {
+                if (&x != this)
+                    assign(x.begin(), x.end());
+                return *this;
+            }
+
+            iterator begin() {
+                return data_;
+            }
+
+            const_iterator begin() const {
+                return const_pointer(data_);
+            }
+
+            iterator end() {
+                return data_ + size_;
+            }
+
+            const_iterator end() const {
+                return const_pointer(data_ + size_);
+            }
+
+            reverse_iterator rbegin() {
+                return reverse_iterator(end());
+            }
+
+            const_reverse_iterator rbegin() const {
+                return const_reverse_iterator(end());
+            }
+
+            reverse_iterator rend() {
+                return reverse_iterator(begin());
+            }
+
+            const_reverse_iterator rend() const {
+                return const_reverse_iterator(begin());
+            }
+
+            size_type size() const {
+                return size_;
+            }
+
+            size_type max_size() const {
+                return allocator_.max_size();
+            }
+
+            void resize(size_type n, value_type val = value_type()) {
+                if (n < size_)
+                    destroy_from(n);
+                else if (n > size_) {
+                    grow(n);
+                    for (; size_ < n; ++size_)
+                        allocator_.construct(data_ + size_, val);
+                }
+            }
+
+            void reserve(size_type n) {
+                if (n <= capacity_)
+                    return;
+                if (n > max_size())
+                    throw std::length_error("small_vector::reserve");
+                pointer temp = allocator_.allocate(n);
+                size_type i = 0;
+                try {
+                    for (; i < size_; ++i)
+                        allocator_.construct(temp + i, data_[i]);
+                }
+                catch(...) {
+                    while (i)
+                        allocator_.destroy(temp + --i);
+                    allocator_.deallocate(temp, n);
+                    throw;
+                }
+                for (i = 0; i < size_; ++i)
+                    allocator_.destroy(data_ + i);
+                if (!is_inline())
+                    allocator_.deallocate(data_, capacity_);
+                data_ = temp;
+                capacity_ = n;
+            }
+
+            bool empty() const {
+                return !size_;
+            }
+
+            size_type capacity() const {
+                return capacity_;
+            }
+
+            bool is_inline() const {
+                return data_ == inline_data();
+            }
+
+            const_reference operator[](size_type n) const {
+                return data_[n];
+            }
+
+            reference operator[](size_type n) {
+                return data_[n];
+            }
+
+            const_reference at(size_type n) const {
+                if (n < size_)
+                    return data_[n];
+                throw std::out_of_range("Error: position_ out of range");
+            }
+
+            reference at(size_type n) {
+                if (n < size_)
+                    return data_[n];
+                throw std::out_of_range("Error: position_ out of range");
+            }
+
+            const_reference front() const {
+                return data_[0];
+            }
+
+            reference front() {
+                return data_[0];
+            }
+
+            const_reference back() const {
+                return data_[size_ - 1];
+            }
+
+            reference back() {
+                return data_[size_ - 1];
+            }
+
+            pointer data() {
+                return data_;
+            }
+
+            const_pointer data() const {
+                return data_;
+            }
+
+            template<class TemplateIterator>
+            void assign(TemplateIterator first, TemplateIterator last, typename ft::enable_if<!ft::is_integral<TemplateIterator>::value>::type* = 0) {
+                clear();
+                grow(ft::distance(first, last));
+                for (; first != last; ++size_, ++first)
+                    allocator_.construct(data_ + size_, *first);
+            }
+
+            void assign(size_type n, const value_type &val) {
+                clear();
+                grow(n);
+                for (; size_ < n; ++size_)
+                    allocator_.construct(data_ + size_, val);
+            }
+
+            void push_back(const value_type &val) {
+                if (size_ == capacity_) {
+                    value_type copy(val);
+                    grow(size_ + 1);
+                    allocator_.construct(data_ + size_, copy);
+                }
+                else
+                    allocator_.construct(data_ + size_, val);
+                ++size_;
+            }
+
+            void pop_back() {
+                if (size_)
+                    allocator_.destroy(data_ + --size_);
+            }
+
+            iterator insert(iterator position, const value_type &val) {
+                size_type dist = position - begin();
+                insert(position, 1, val);
+                return begin() + dist;
+            }
+
+            void insert(iterator position, size_type n, const value_type &val) {
+                size_type dist = position - begin();
+                value_type copy(val);
+
+                open_gap(dist, n);
+                for (size_type i = dist; i < dist + n; ++i)
+                    put(i, copy);
+                size_ += n;
+            }
+
+            template<class TemplateIterator>
+            void insert(iterator position, TemplateIterator first, TemplateIterator last, typename ft::enable_if<!ft::is_integral<TemplateIterator>::value>::type* = 0) {
+                size_type dist = position - begin();
+                size_type n = ft::distance(first, last);
+
+                if (position > end() || position < begin())
+                    throw std::range_error("Index Error");
+                open_gap(dist, n);
+                for (size_type i = dist; i < dist + n; ++i, ++first)
+                    put(i, *first);
+                size_ += n;
+            }
+
+            iterator erase(iterator position) {
+                return erase(position, position + 1);
+            }
+
+            iterator erase(iterator first, iterator last) {
+                size_type from = first - begin();
+                size_type distance = last - first;
+
+                for (size_type i = from; i + distance < size_; ++i)
+                    data_[i] = data_[i + distance];
+                destroy_from(size_ - distance);
+                return begin() + from;
+            }
+
+            void clear() {
+                destroy_from(0);
+            }
+
+            allocator_type get_allocator() const {
+                return allocator_;
+            }
+
+            void swap(small_vector &x) {
+                if (!is_inline() && !x.is_inline()) {
+                    ft::swap(data_, x.data_);
+                    ft::swap(capacity_, x.capacity_);
+                    ft::swap(size_, x.size_);
+                    return;
+                }
+                small_vector temp(*this);
+                *this = x;
+                x = temp;
+            }
+
+        private:
+            typedef typename std::aligned_storage<sizeof(T) * inline_capacity, alignof(T)>::type storage_type;
+
+            allocator_type allocator_;
+            pointer data_;
+            size_type capacity_;
+            size_type size_;
+            storage_type storage_;
+
+            pointer inline_data() {
+                return reinterpret_cast<pointer>(&storage_);
+            }
+
+            const_pointer inline_data() const {
+                return reinterpret_cast<const_pointer>(&storage_);
+            }
+
+            void grow(size_type n) {
+                if (n > capacity_)
+                    reserve(n > capacity_ * 2 ? n : capacity_ * 2);
+            }
+
+            void destroy_from(size_type n) {
+                while (size_ > n)
+                    allocator_.destroy(data_ + --size_);
+            }
+
+            void put(size_type i, const value_type &val) {
+                if (i < size_)
+                    data_[i] = val;
+                else
+                    allocator_.construct(data_ + i, val);
+            }
+
+            // Shifts [dist, size_) up by n, leaving the slots below size_ assigned and the rest raw.
+            void open_gap(size_type dist, size_type n) {
+                grow(size_ + n);
+                for (size_type i = size_; i-- > dist;) {
+                    if (i + n >= size_)
+                        allocator_.construct(data_ + i + n, data_[i]);
+                    else
+                        data_[i + n] = data_[i];
+                }
+            }
+    };
+
+    template<class T, size_t N, class Alloc>
+    bool operator==(const ft::small_vector<T, N, Alloc> &lhs, const ft::small_vector<T, N, Alloc> &rhs) {
+        return lhs.size() == rhs.size() && ft::equal(lhs.begin(), lhs.end(), rhs.begin());
+    }
+
+    template<class T, size_t N, class Alloc>
+    bool operator!=(const ft::small_vector<T, N, Alloc> &lhs, const ft::small_vector<T, N, Alloc> &rhs) {
+        return !(lhs == rhs);
+    }
+
+    template<class T, size_t N, class Alloc>
+    bool operator<(const ft::small_vector<T, N, Alloc> &lhs, const ft::small_vector<T, N, Alloc> &rhs) {
+        return ft::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+
+    template<class T, size_t N, class Alloc>
+    bool operator>(const ft::small_vector<T, N, Alloc> &lhs, const ft::small_vector<T, N, Alloc> &rhs) {
+        return rhs < lhs;
+    }
+
+    template<class T, size_t N, class Alloc>
+    bool operator<=(const ft::small_vector<T, N, Alloc> &lhs, const ft::small_vector<T, N, Alloc> &rhs) {
+        return !(rhs < lhs);
+    }
+
+    template<class T, size_t N, class Alloc>
+    bool operator>=(const ft::small_vector<T, N, Alloc> &lhs, const ft::small_vector<T, N, Alloc> &rhs) {
+        return !(lhs < rhs);
+    }
+
+    template<class T, size_t N, class Alloc>
+    void swap(ft::small_vector<T, N, Alloc> &x, ft::small_vector<T, N, Alloc> &y) {
+        x.swap(y);
+    }
+}
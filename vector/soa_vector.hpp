@@ -0,0 +1,548 @@
+#pragma once
+
+#include <new>
+#include <algorithm>
+#include <memory>
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include "../utils/cache_line.hpp"
+#include "../utils/iterator_traits.hpp"
+#include "../utils/utils.hpp"
+#include "span.hpp"
+
+namespace ft{
+    namespace soa_detail
+    {
+        template <size_t... Is>
+        struct indices{};
+
+        template <size_t N, size_t... Is>
+        struct make_indices : make_indices<N - 1, N - 1, Is...>{};
+
+        template <size_t... Is>
+        struct make_indices<0, Is...>{
+            typedef indices<Is...> type;
+        };
+
+        template <class... Ts>
+        struct max_align;
+
+        template <>
+        struct max_align<>{
+            static const size_t value = ft::cache_line_size;
+        };
+
+        template <class T, class... Ts>
+        struct max_align<T, Ts...>{
+            static const size_t value = alignof(T) > max_align<Ts...>::value ? alignof(T) : max_align<Ts...>::value;
+        };
+
+        // Per-field steps that may throw, undoing the fields before I when a later one fails.
+        template <size_t I, size_t N>
+        struct fields{
+            template <class Pointers, class Values>
+            static void construct(const Pointers &p, size_t n, const Values &values) {
+                typedef typename std::remove_pointer<typename std::tuple_element<I, Pointers>::type>::type T;
+
+                new (std::get<I>(p) + n) T(std::get<I>(values));
+                try {
+                    fields<I + 1, N>::construct(p, n, values);
+                }
+                catch (...) {
+                    (std::get<I>(p) + n)->~T();
+                    throw;
+                }
+            }
+
+            template <class Pointers>
+            static void construct_default(const Pointers &p, size_t n) {
+                typedef typename std::remove_pointer<typename std::tuple_element<I, Pointers>::type>::type T;
+
+                new (std::get<I>(p) + n) T();
+                try {
+                    fields<I + 1, N>::construct_default(p, n);
+                }
+                catch (...) {
+                    (std::get<I>(p) + n)->~T();
+                    throw;
+                }
+            }
+
+            template <class Pointers>
+            static void copy(const Pointers &from, const Pointers &to, size_t count) {
+                typedef typename std::remove_pointer<typename std::tuple_element<I, Pointers>::type>::type T;
+
+                std::uninitialized_copy(std::get<I>(from), std::get<I>(from) + count, std::get<I>(to));
+                try {
+                    fields<I + 1, N>::copy(from, to, count);
+                }
+                catch (...) {
+                    for (size_t i = 0; i < count; ++i)
+                        std::get<I>(to)[i].~T();
+                    throw;
+                }
+            }
+        };
+
+        template <size_t N>
+        struct fields<N, N>{
+            template <class Pointers, class Values>
+            static void construct(const Pointers &, size_t, const Values &) {}
+
+            template <class Pointers>
+            static void construct_default(const Pointers &, size_t) {}
+
+            template <class Pointers>
+            static void copy(const Pointers &, const Pointers &, size_t) {}
+        };
+
+        template <class T>
+        void destroy(T *data, size_t first, size_t last) {
+            for (; first < last; ++first)
+                data[first].~T();
+        }
+
+        // Random access iterator whose elements are tuples of references, one per field.
+        template <class Container, bool Const>
+        class zip_iterator{
+            public:
+                typedef std::random_access_iterator_tag iterator_category;
+                typedef typename Container::value_type value_type;
+                typedef ptrdiff_t difference_type;
+                typedef void pointer;
+                typedef typename std::conditional<Const, typename Container::const_reference,
+                                                  typename Container::reference>::type reference;
+                typedef typename std::conditional<Const, const Container *, Container *>::type container_pointer;
+
+                zip_iterator() : container_(0), index_(0) {}
+
+                zip_iterator(container_pointer container, size_t index) : container_(container), index_(index) {}
+
+                size_t index() const {
+                    return index_;
+                }
+
+                reference operator*() const {
+                    return (*container_)[index_];
+                }
+
+                reference operator[](difference_type n) const {
+                    return (*container_)[index_ + n];
+                }
+
+                zip_iterator &operator++() {
+                    ++index_;
+                    return *this;
+                }
+
+                zip_iterator operator++(int) {
+                    zip_iterator tmp = *this;
+                    ++index_;
+                    return tmp;
+                }
+
+                zip_iterator &operator--() {
+                    --index_;
+                    return *this;
+                }
+
+                zip_iterator operator--(int) {
+                    zip_iterator tmp = *this;
+                    --index_;
+                    return tmp;
+                }
+
+                zip_iterator &operator+=(difference_type n) {
+                    index_ += n;
+                    return *this;
+                }
+
+                zip_iterator &operator-=(difference_type n) {
+                    index_ -= n;
+                    return *this;
+                }
+
+                zip_iterator operator+(difference_type n) const {
+                    return zip_iterator(container_, index_ + n);
+                }
+
+                zip_iterator operator-(difference_type n) const {
+                    return zip_iterator(container_, index_ - n);
+                }
+
+                difference_type operator-(const zip_iterator &it) const {
+                    return difference_type(index_) - difference_type(it.index_);
+                }
+
+                bool operator==(const zip_iterator &it) const {
+                    return index_ == it.index_;
+                }
+
+                bool operator!=(const zip_iterator &it) const {
+                    return index_ != it.index_;
+                }
+
+                bool operator<(const zip_iterator &it) const {
+                    return index_ < it.index_;
+                }
+
+                bool operator>(const zip_iterator &it) const {
+                    return index_ > it.index_;
+                }
+
+                bool operator<=(const zip_iterator &it) const {
+                    return index_ <= it.index_;
+                }
+
+                bool operator>=(const zip_iterator &it) const {
+                    return index_ >= it.index_;
+                }
+
+                operator zip_iterator<Container, true>() const {
+                    return zip_iterator<Container, true>(container_, index_);
+                }
+
+            private:
+                container_pointer container_;
+                size_t index_;
+        };
+    }
+
+    // Records of fields Ts... stored column by column: field I of every element lives in its own
+    // contiguous array, each starting on a cache line of one shared allocation. A scan of one
+    // field through field<I>() reads only that field's bytes and runs over a plain array the
+    // compiler can vectorise. Every operation that adds or removes elements does so in all fields
+    // at once; element access hands out tuples of references.
+    template <class... Ts>
+    class soa_vector{
+        public:
+            typedef std::tuple<Ts...> value_type;
+            typedef std::tuple<Ts &...> reference;
+            typedef std::tuple<const Ts &...> const_reference;
+            typedef size_t size_type;
+            typedef ptrdiff_t difference_type;
+            typedef soa_detail::zip_iterator<soa_vector, false> iterator;
+            typedef soa_detail::zip_iterator<soa_vector, true> const_iterator;
+            typedef ft::reverse_iterator<iterator> reverse_iterator;
+            typedef ft::reverse_iterator<const_iterator> const_reverse_iterator;
+
+            template <size_t I>
+            struct field_type{
+                typedef typename std::tuple_element<I, value_type>::type type;
+            };
+
+            static const size_t field_count = sizeof...(Ts);
+
+            soa_vector() : block_(0), capacity_(0), size_(0) {
+                static_assert(sizeof...(Ts) > 0, "ft::soa_vector needs at least one field");
+            }
+
+            explicit soa_vector(size_type n) : block_(0), capacity_(0), size_(0) {
+                try {
+                    resize(n);
+                }
+                catch (...) {
+                    release();
+                    throw;
+                }
+            }
+
+            soa_vector(const soa_vector &x) : block_(0), capacity_(0), size_(0) {
+                try {
+                    reserve(x.size_);
+                    for (; size_ < x.size_; ++size_)
+                        soa_detail::fields<0, sizeof...(Ts)>::construct(fields_, size_, x[size_]);
+                }
+                catch (...) {
+                    release();
+                    throw;
+                }
+            }
+
+            ~soa_vector() {
+                release();
+            }
+
+            soa_vector &operator=(const soa_vector &x) {
+                if (&x != this) {
+                    soa_vector copy(x);
+                    swap(copy);
+                }
+                return *this;
+            }
+
+            iterator begin() {
+                return iterator(this, 0);
+            }
+
+            const_iterator begin() const {
+                return const_iterator(this, 0);
+            }
+
+            iterator end() {
+                return iterator(this, size_);
+            }
+
+            const_iterator end() const {
+                return const_iterator(this, size_);
+            }
+
+            reverse_iterator rbegin() {
+                return reverse_iterator(end());
+            }
+
+            const_reverse_iterator rbegin() const {
+                return const_reverse_iterator(end());
+            }
+
+            reverse_iterator rend() {
+                return reverse_iterator(begin());
+            }
+
+            const_reverse_iterator rend() const {
+                return const_reverse_iterator(begin());
+            }
+
+            size_type size() const {
+                return size_;
+            }
+
+            size_type capacity() const {
+                return capacity_;
+            }
+
+            bool empty() const {
+                return !size_;
+            }
+
+            reference operator[](size_type n) {
+                return at_index(n, typename soa_detail::make_indices<sizeof...(Ts)>::type());
+            }
+
+            const_reference operator[](size_type n) const {
+                return at_index(n, typename soa_detail::make_indices<sizeof...(Ts)>::type());
+            }
+
+            reference at(size_type n) {
+                if (n < size_)
+                    return (*this)[n];
+                throw std::out_of_range("Error: position_ out of range");
+            }
+
+            const_reference at(size_type n) const {
+                if (n < size_)
+                    return (*this)[n];
+                throw std::out_of_range("Error: position_ out of range");
+            }
+
+            reference front() {
+                return (*this)[0];
+            }
+
+            const_reference front() const {
+                return (*this)[0];
+            }
+
+            reference back() {
+                return (*this)[size_ - 1];
+            }
+
+            const_reference back() const {
+                return (*this)[size_ - 1];
+            }
+
+            // Field I of every element as one contiguous array.
+            template <size_t I>
+            ft::span<typename field_type<I>::type> field() {
+                return ft::span<typename field_type<I>::type>(std::get<I>(fields_), size_);
+            }
+
+            template <size_t I>
+            ft::span<const typename field_type<I>::type> field() const {
+                return ft::span<const typename field_type<I>::type>(std::get<I>(fields_), size_);
+            }
+
+            template <size_t I>
+            typename field_type<I>::type *data() {
+                return std::get<I>(fields_);
+            }
+
+            template <size_t I>
+            const typename field_type<I>::type *data() const {
+                return std::get<I>(fields_);
+            }
+
+            void reserve(size_type n) {
+                if (n <= capacity_)
+                    return;
+                pointers fields;
+                char *block = allocate(n, fields);
+                try {
+                    soa_detail::fields<0, sizeof...(Ts)>::copy(fields_, fields, size_);
+                }
+                catch (...) {
+                    ::operator delete(block);
+                    throw;
+                }
+                destroy(0, size_);
+                ::operator delete(block_);
+                block_ = block;
+                fields_ = fields;
+                capacity_ = n;
+            }
+
+            // The values may refer into this container: on reallocation they are copied first.
+            void push_back(const Ts &... values) {
+                if (size_ == capacity_) {
+                    value_type copy(values...);
+                    reserve(capacity_ ? capacity_ * 2 : 1);
+                    soa_detail::fields<0, sizeof...(Ts)>::construct(fields_, size_, copy);
+                }
+                else
+                    soa_detail::fields<0, sizeof...(Ts)>::construct(fields_, size_, std::forward_as_tuple(values...));
+                ++size_;
+            }
+
+            void pop_back() {
+                if (size_) {
+                    --size_;
+                    destroy(size_, size_ + 1);
+                }
+            }
+
+            void resize(size_type n) {
+                if (n <= size_) {
+                    destroy(n, size_);
+                    size_ = n;
+                    return;
+                }
+                grow_to(n);
+                for (; size_ < n; ++size_)
+                    soa_detail::fields<0, sizeof...(Ts)>::construct_default(fields_, size_);
+            }
+
+            void resize(size_type n, const Ts &... values) {
+                if (n <= size_) {
+                    destroy(n, size_);
+                    size_ = n;
+                    return;
+                }
+                value_type copy(values...);
+                grow_to(n);
+                for (; size_ < n; ++size_)
+                    soa_detail::fields<0, sizeof...(Ts)>::construct(fields_, size_, copy);
+            }
+
+            iterator erase(iterator position) {
+                return erase(position, position + 1);
+            }
+
+            // Shifts the tail of every field down by assignment, then destroys the vacated end.
+            iterator erase(iterator first, iterator last) {
+                size_type from = first.index();
+                size_type count = last.index() - from;
+
+                if (count) {
+                    shift(from, count, typename soa_detail::make_indices<sizeof...(Ts)>::type());
+                    destroy(size_ - count, size_);
+                    size_ -= count;
+                }
+                return iterator(this, from);
+            }
+
+            void clear() {
+                destroy(0, size_);
+                size_ = 0;
+            }
+
+            void swap(soa_vector &x) {
+                std::swap(block_, x.block_);
+                std::swap(fields_, x.fields_);
+                std::swap(capacity_, x.capacity_);
+                std::swap(size_, x.size_);
+            }
+
+        private:
+            typedef std::tuple<Ts *...> pointers;
+
+            char *block_;
+            pointers fields_;
+            size_type capacity_;
+            size_type size_;
+
+            template <size_t... Is>
+            reference at_index(size_type n, soa_detail::indices<Is...>) {
+                return reference(std::get<Is>(fields_)[n]...);
+            }
+
+            template <size_t... Is>
+            const_reference at_index(size_type n, soa_detail::indices<Is...>) const {
+                return const_reference(std::get<Is>(fields_)[n]...);
+            }
+
+            // One block holds every field for n elements, each array rounded up to a cache line.
+            static char *allocate(size_type n, pointers &fields) {
+                return allocate(n, fields, typename soa_detail::make_indices<sizeof...(Ts)>::type());
+            }
+
+            template <size_t... Is>
+            static char *allocate(size_type n, pointers &fields, soa_detail::indices<Is...>) {
+                const size_t align = soa_detail::max_align<Ts...>::value;
+                const size_t sizes[] = {sizeof(Ts)...};
+                size_t offsets[sizeof...(Ts)];
+                size_t total = 0;
+
+                for (size_t i = 0; i < sizeof...(Ts); ++i) {
+                    if (n > (~size_t(0) - align - total) / sizes[i])
+                        throw std::length_error("ft::soa_vector");
+                    offsets[i] = total;
+                    total = (total + n * sizes[i] + align - 1) / align * align;
+                }
+                char *block = static_cast<char *>(::operator new(total + align - 1));
+                char *base = reinterpret_cast<char *>((reinterpret_cast<size_t>(block) + align - 1) / align * align);
+                fields = pointers(reinterpret_cast<Ts *>(base + offsets[Is])...);
+                return block;
+            }
+
+            void grow_to(size_type n) {
+                if (n > capacity_)
+                    reserve(n > capacity_ * 2 ? n : capacity_ * 2);
+            }
+
+            void destroy(size_type first, size_type last) {
+                destroy(first, last, typename soa_detail::make_indices<sizeof...(Ts)>::type());
+            }
+
+            template <size_t... Is>
+            void destroy(size_type first, size_type last, soa_detail::indices<Is...>) {
+                int expand[] = {0, (soa_detail::destroy(std::get<Is>(fields_), first, last), 0)...};
+                (void)expand;
+            }
+
+            template <size_t... Is>
+            void shift(size_type from, size_type count, soa_detail::indices<Is...>) {
+                int expand[] = {0, (std::copy(std::get<Is>(fields_) + from + count, std::get<Is>(fields_) + size_,
+                                              std::get<Is>(fields_) + from), 0)...};
+                (void)expand;
+            }
+
+            void release() {
+                destroy(0, size_);
+                ::operator delete(block_);
+                block_ = 0;
+                capacity_ = 0;
+                size_ = 0;
+            }
+    };
+
+    template <class... Ts>
+    const size_t soa_vector<Ts...>::field_count;
+
+    template <class... Ts>
+    void swap(soa_vector<Ts...> &x, soa_vector<Ts...> &y) {
+        x.swap(y);
+    }
+}
@@ -0,0 +1,257 @@
+#pragma once
+
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include "../utils/iterator_traits.hpp"
+#include "../utils/utils.hpp"
+#include "vector.hpp"
+#include "static_vector.hpp"
+
+namespace ft{
+    static const size_t dynamic_extent = static_cast<size_t>(-1);
+
+    template <class T, size_t Extent = ft::dynamic_extent>
+    class span;
+
+    // A fixed extent lives in the type, so such a span is a single pointer.
+    template <class T, size_t Extent>
+    class span_storage{
+        protected:
+            T *data_;
+
+            span_storage(T *data, size_t size) : data_(data) {
+                if (size != Extent)
+                    throw std::length_error("ft::span extent mismatch");
+            }
+
+            size_t count() const {
+                return Extent;
+            }
+    };
+
+    template <class T>
+    class span_storage<T, ft::dynamic_extent>{
+        protected:
+            T *data_;
+            size_t size_;
+
+            span_storage(T *data, size_t size) : data_(data), size_(size) {}
+
+            size_t count() const {
+                return size_;
+            }
+    };
+
+    namespace span_detail
+    {
+        // U elements may be viewed as T: same type up to added const or volatile.
+        template <class U, class T>
+        struct compatible : std::is_convertible<U (*)[], T (*)[]>{};
+
+        template <size_t From, size_t To>
+        struct extent_fits : std::integral_constant<bool, To == ft::dynamic_extent || From == ft::dynamic_extent || From == To>{};
+
+        template <size_t Extent, size_t Offset, size_t Count>
+        struct subspan_extent : std::integral_constant<size_t, Count != ft::dynamic_extent ? Count
+                                                       : Extent != ft::dynamic_extent ? Extent - Offset : ft::dynamic_extent>{};
+    }
+
+    // Non-owning view of count contiguous elements: a pointer and a size, or only a pointer when the
+    // extent is fixed. Slicing with first, last and subspan never allocates, and data() hands the
+    // elements to code that wants a raw pointer. The viewed storage must outlive the span, and a
+    // vector that reallocates invalidates it like any other iterator.
+    template <class T, size_t Extent>
+    class span : private span_storage<T, Extent>{
+        public:
+            typedef T element_type;
+            typedef typename std::remove_cv<T>::type value_type;
+            typedef size_t size_type;
+            typedef ptrdiff_t difference_type;
+            typedef T *pointer;
+            typedef const T *const_pointer;
+            typedef T &reference;
+            typedef const T &const_reference;
+            typedef ft::random_access_iterator<T> iterator;
+            typedef ft::reverse_iterator<iterator> reverse_iterator;
+
+            static const size_type extent = Extent;
+
+            span() : span_storage<T, Extent>(0, 0) {
+                static_assert(Extent == 0 || Extent == ft::dynamic_extent, "an empty ft::span needs extent 0 or dynamic_extent");
+            }
+
+            // A template on the count, so a literal 0 picks this form rather than (first, last).
+            template <class Size>
+            span(pointer data, Size count,
+                 typename std::enable_if<std::is_integral<Size>::value>::type* = nullptr)
+                : span_storage<T, Extent>(data, count) {}
+
+            span(pointer first, pointer last) : span_storage<T, Extent>(first, last - first) {}
+
+            template <size_t N>
+            span(element_type (&array)[N],
+                 typename std::enable_if<span_detail::extent_fits<N, Extent>::value>::type* = nullptr)
+                : span_storage<T, Extent>(array, N) {}
+
+            template <class U, class Alloc>
+            span(ft::vector<U, Alloc> &v,
+                 typename std::enable_if<span_detail::compatible<U, T>::value>::type* = nullptr)
+                : span_storage<T, Extent>(v.empty() ? 0 : v.begin().base(), v.size()) {}
+
+            template <class U, class Alloc>
+            span(const ft::vector<U, Alloc> &v,
+                 typename std::enable_if<span_detail::compatible<const U, T>::value>::type* = nullptr)
+                : span_storage<T, Extent>(v.empty() ? 0 : v.begin().base(), v.size()) {}
+
+            template <class U, size_t N, class Overflow>
+            span(ft::static_vector<U, N, Overflow> &v,
+                 typename std::enable_if<span_detail::compatible<U, T>::value>::type* = nullptr)
+                : span_storage<T, Extent>(v.data(), v.size()) {}
+
+            template <class U, size_t N, class Overflow>
+            span(const ft::static_vector<U, N, Overflow> &v,
+                 typename std::enable_if<span_detail::compatible<const U, T>::value>::type* = nullptr)
+                : span_storage<T, Extent>(v.data(), v.size()) {}
+
+            // span<const T> from span<T>, and fixed extents to dynamic ones or back (checked).
+            template <class U, size_t N>
+            span(const span<U, N> &s,
+                 typename std::enable_if<span_detail::compatible<U, T>::value
+                                         && span_detail::extent_fits<N, Extent>::value>::type* = nullptr)
+                : span_storage<T, Extent>(s.data(), s.size()) {}
+
+            iterator begin() const {
+                return iterator(this->data_);
+            }
+
+            iterator end() const {
+                return iterator(this->data_ + size());
+            }
+
+            reverse_iterator rbegin() const {
+                return reverse_iterator(end());
+            }
+
+            reverse_iterator rend() const {
+                return reverse_iterator(begin());
+            }
+
+            size_type size() const {
+                return this->count();
+            }
+
+            size_type size_bytes() const {
+                return size() * sizeof(T);
+            }
+
+            bool empty() const {
+                return !size();
+            }
+
+            pointer data() const {
+                return this->data_;
+            }
+
+            reference operator[](size_type n) const {
+                return this->data_[n];
+            }
+
+            reference at(size_type n) const {
+                if (n < size())
+                    return this->data_[n];
+                throw std::out_of_range("Error: position_ out of range");
+            }
+
+            reference front() const {
+                return this->data_[0];
+            }
+
+            reference back() const {
+                return this->data_[size() - 1];
+            }
+
+            template <size_t Count>
+            span<T, Count> first() const {
+                static_assert(Extent == ft::dynamic_extent || Count <= Extent, "ft::span::first past the extent");
+                check(0, Count);
+                return span<T, Count>(this->data_, Count);
+            }
+
+            span<T> first(size_type count) const {
+                check(0, count);
+                return span<T>(this->data_, count);
+            }
+
+            template <size_t Count>
+            span<T, Count> last() const {
+                static_assert(Extent == ft::dynamic_extent || Count <= Extent, "ft::span::last past the extent");
+                check(0, Count);
+                return span<T, Count>(this->data_ + (size() - Count), Count);
+            }
+
+            span<T> last(size_type count) const {
+                check(0, count);
+                return span<T>(this->data_ + (size() - count), count);
+            }
+
+            template <size_t Offset, size_t Count = ft::dynamic_extent>
+            span<T, span_detail::subspan_extent<Extent, Offset, Count>::value> subspan() const {
+                static_assert(Extent == ft::dynamic_extent || (Offset <= Extent && (Count == ft::dynamic_extent || Count <= Extent - Offset)),
+                              "ft::span::subspan past the extent");
+                size_type count = Count == ft::dynamic_extent ? size() - check(Offset, 0) : Count;
+                check(Offset, count);
+                return span<T, span_detail::subspan_extent<Extent, Offset, Count>::value>(this->data_ + Offset, count);
+            }
+
+            // count == dynamic_extent takes everything from offset on.
+            span<T> subspan(size_type offset, size_type count = ft::dynamic_extent) const {
+                if (count == ft::dynamic_extent)
+                    count = size() - check(offset, 0);
+                check(offset, count);
+                return span<T>(this->data_ + offset, count);
+            }
+
+        private:
+            size_type check(size_type offset, size_type count) const {
+                if (offset > size() || count > size() - offset)
+                    throw std::out_of_range("ft::span: slice out of range");
+                return offset;
+            }
+    };
+
+    template <class T, size_t Extent>
+    const size_t span<T, Extent>::extent;
+
+    // Views of the same elements as raw bytes, for I/O and bitwise kernels.
+    template <class T, size_t Extent>
+    span<const unsigned char> as_bytes(const span<T, Extent> &s) {
+        return span<const unsigned char>(reinterpret_cast<const unsigned char *>(s.data()), s.size_bytes());
+    }
+
+    template <class T, size_t Extent>
+    typename std::enable_if<!std::is_const<T>::value, span<unsigned char> >::type
+    as_writable_bytes(const span<T, Extent> &s) {
+        return span<unsigned char>(reinterpret_cast<unsigned char *>(s.data()), s.size_bytes());
+    }
+
+    template <class T, class Alloc>
+    span<T> make_span(ft::vector<T, Alloc> &v) {
+        return span<T>(v);
+    }
+
+    template <class T, class Alloc>
+    span<const T> make_span(const ft::vector<T, Alloc> &v) {
+        return span<const T>(v);
+    }
+
+    template <class T, size_t N>
+    span<T, N> make_span(T (&array)[N]) {
+        return span<T, N>(array);
+    }
+
+    template <class T>
+    span<T> make_span(T *data, size_t count) {
+        return span<T>(data, count);
+    }
+}
@@ -0,0 +1,358 @@
+#pragma once
+
+#include <new>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include "../utils/iterator_traits.hpp"
+#include "../utils/is_integral.hpp"
+#include "../utils/enable_if.hpp"
+#include "../utils/utils.hpp"
+
+namespace ft{
+    struct overflow_checked{
+        static void check(bool overflow) {
+            if (overflow)
+                throw std::length_error("static_vector capacity exceeded");
+        }
+    };
+
+    struct overflow_unchecked{
+        static void check(bool) {}
+    };
+
+    // Raw inline slots plus a size; only the non-trivial variant declares copy and destruction,
+    // so a static_vector of trivially copyable T stays trivially copyable.
+    template <typename T, size_t N, bool Trivial = std::is_trivially_copyable<T>::value>
+    class static_vector_storage{
+        protected:
+            typedef typename std::aligned_storage<sizeof(T) * (N ? N : 1), alignof(T)>::type storage_type;
+
+            size_t size_;
+            storage_type storage_;
+
+            T *slots() {
+                return reinterpret_cast<T *>(&storage_);
+            }
+
+            const T *slots() const {
+                return reinterpret_cast<const T *>(&storage_);
+            }
+    };
+
+    template <typename T, size_t N>
+    class static_vector_storage<T, N, false>{
+        public:
+            static_vector_storage() {}
+
+            static_vector_storage(const static_vector_storage &x) : size_(0) {
+                for (; size_ < x.size_; ++size_)
+                    new (slots() + size_) T(x.slots()[size_]);
+            }
+
+            ~static_vector_storage() {
+                while (size_)
+                    slots()[--size_].~T();
+            }
+
+            static_vector_storage &operator=(const static_vector_storage &x) {
+                if (&x != this) {
+                    while (size_)
+                        slots()[--size_].~T();
+                    for (; size_ < x.size_; ++size_)
+                        new (slots() + size_) T(x.slots()[size_]);
+                }
+                return *this;
+            }
+
+        protected:
+            typedef typename std::aligned_storage<sizeof(T) * (N ? N : 1), alignof(T)>::type storage_type;
+
+            size_t size_;
+            storage_type storage_;
+
+            T *slots() {
+                return reinterpret_cast<T *>(&storage_);
+            }
+
+            const T *slots() const {
+                return reinterpret_cast<const T *>(&storage_);
+            }
+    };
+
+    template <typename T, size_t N, typename Overflow = ft::overflow_checked>
+    class static_vector : public static_vector_storage<T, N>{
+        public:
+            typedef T value_type;
+            typedef T &reference;
+            typedef const T &const_reference;
+            typedef const T *const_pointer;
+            typedef T *pointer;
+            typedef ft::random_access_iterator<value_type> iterator;
+            typedef ft::random_access_iterator<const value_type> const_iterator;
+            typedef ft::reverse_iterator<iterator> reverse_iterator;
+            typedef ft::reverse_iterator<const_iterator> const_reverse_iterator;
+            typedef typename ft::iterator_traits<iterator>::difference_type difference_type;
+            typedef size_t size_type;
+
+            static_vector() {
+                this->size_ = 0;
+            }
+
+            explicit static_vector(size_type n, const value_type &val = value_type()) {
+                this->size_ = 0;
+                assign(n, val);
+            }
+
+            template<class TemplateIterator>
+            static_vector(TemplateIterator first, TemplateIterator last,
+                   typename ft::enable_if<!ft::is_integral<TemplateIterator>::value>::type* = 0) {
+                this->size_ = 0;
+                assign(first, last);
+            }
+
+            iterator begin() {
+                return this->slots();
+            }
+
+            const_iterator begin() const {
+                return this->slots();
+            }
+
+            iterator end() {
+                return this->slots() + this->size_;
+            }
+
+            const_iterator end() const {
+                return this->slots() + this->size_;
+            }
+
+            reverse_iterator rbegin() {
+                return reverse_iterator(end());
+            }
+
+            const_reverse_iterator rbegin() const {
+                return const_reverse_iterator(end());
+            }
+
+            reverse_iterator rend() {
+                return reverse_iterator(begin());
+            }
+
+            const_reverse_iterator rend() const {
+                return const_reverse_iterator(begin());
+            }
+
+            size_type size() const {
+                return this->size_;
+            }
+
+            static constexpr size_type max_size() {
+                return N;
+            }
+
+            static constexpr size_type capacity() {
+                return N;
+            }
+
+            void resize(size_type n, value_type val = value_type()) {
+                Overflow::check(n > N);
+                while (this->size_ > n)
+                    pop_back();
+                for (; this->size_ < n; ++this->size_)
+                    new (this->slots() + this->size_) T(val);
+            }
+
+            void reserve(size_type n) {
+                Overflow::check(n > N);
+            }
+
+            bool empty() const {
+                return !this->size_;
+            }
+
+            bool full() const {
+                return this->size_ == N;
+            }
+
+            const_reference operator[](size_type n) const {
+                return this->slots()[n];
+            }
+
+            reference operator[](size_type n) {
+                return this->slots()[n];
+            }
+
+            const_reference at(size_type n) const {
+                if (n < this->size_)
+                    return this->slots()[n];
+                throw std::out_of_range("Error: position_ out of range");
+            }
+
+            reference at(size_type n) {
+                if (n < this->size_)
+                    return this->slots()[n];
+                throw std::out_of_range("Error: position_ out of range");
+            }
+
+            const_reference front() const {
+                return this->slots()[0];
+            }
+
+            reference front() {
+                return this->slots()[0];
+            }
+
+            const_reference back() const {
+                return this->slots()[this->size_ - 1];
+            }
+
+            reference back() {
+                return this->slots()[this->size_ - 1];
+            }
+
+            pointer data() {
+                return this->slots();
+            }
+
+            const_pointer data() const {
+                return this->slots();
+            }
+
+            template<class TemplateIterator>
+            void assign(TemplateIterator first, TemplateIterator last, typename ft::enable_if<!ft::is_integral<TemplateIterator>::value>::type* = 0) {
+                clear();
+                for (; first != last; ++first)
+                    push_back(*first);
+            }
+
+            void assign(size_type n, const value_type &val) {
+                clear();
+                resize(n, val);
+            }
+
+            void push_back(const value_type &val) {
+                Overflow::check(this->size_ == N);
+                new (this->slots() + this->size_) T(val);
+                ++this->size_;
+            }
+
+            void pop_back() {
+                if (this->size_)
+                    this->slots()[--this->size_].~T();
+            }
+
+            iterator insert(iterator position, const value_type &val) {
+                size_type dist = position - begin();
+                insert(position, 1, val);
+                return begin() + dist;
+            }
+
+            void insert(iterator position, size_type n, const value_type &val) {
+                size_type dist = position - begin();
+                value_type copy(val);
+
+                open_gap(dist, n);
+                for (size_type i = dist; i < dist + n; ++i)
+                    put(i, copy);
+                this->size_ += n;
+            }
+
+            template<class TemplateIterator>
+            void insert(iterator position, TemplateIterator first, TemplateIterator last, typename ft::enable_if<!ft::is_integral<TemplateIterator>::value>::type* = 0) {
+                size_type dist = position - begin();
+                size_type n = ft::distance(first, last);
+
+                if (position > end() || position < begin())
+                    throw std::range_error("Index Error");
+                open_gap(dist, n);
+                for (size_type i = dist; i < dist + n; ++i, ++first)
+                    put(i, *first);
+                this->size_ += n;
+            }
+
+            iterator erase(iterator position) {
+                return erase(position, position + 1);
+            }
+
+            iterator erase(iterator first, iterator last) {
+                size_type from = first - begin();
+                size_type distance = last - first;
+                pointer data = this->slots();
+
+                for (size_type i = from; i + distance < this->size_; ++i)
+                    data[i] = data[i + distance];
+                while (distance--)
+                    pop_back();
+                return begin() + from;
+            }
+
+            void clear() {
+                while (this->size_)
+                    pop_back();
+            }
+
+            void swap(static_vector &x) {
+                static_vector temp(*this);
+                *this = x;
+                x = temp;
+            }
+
+        private:
+            void put(size_type i, const value_type &val) {
+                if (i < this->size_)
+                    this->slots()[i] = val;
+                else
+                    new (this->slots() + i) T(val);
+            }
+
+            void open_gap(size_type dist, size_type n) {
+                pointer data = this->slots();
+
+                Overflow::check(this->size_ + n > N);
+                for (size_type i = this->size_; i-- > dist;) {
+                    if (i + n >= this->size_)
+                        new (data + i + n) T(data[i]);
+                    else
+                        data[i + n] = data[i];
+                }
+            }
+    };
+
+    static_assert(std::is_trivially_copyable<ft::static_vector<int, 8> >::value, "static_vector of a trivially copyable type must stay trivially copyable");
+
+    template<class T, size_t N, class Overflow>
+    bool operator==(const ft::static_vector<T, N, Overflow> &lhs, const ft::static_vector<T, N, Overflow> &rhs) {
+        return lhs.size() == rhs.size() && ft::equal(lhs.begin(), lhs.end(), rhs.begin());
+    }
+
+    template<class T, size_t N, class Overflow>
+    bool operator!=(const ft::static_vector<T, N, Overflow> &lhs, const ft::static_vector<T, N, Overflow> &rhs) {
+        return !(lhs == rhs);
+    }
+
+    template<class T, size_t N, class Overflow>
+    bool operator<(const ft::static_vector<T, N, Overflow> &lhs, const ft::static_vector<T, N, Overflow> &rhs) {
+        return ft::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+
+    template<class T, size_t N, class Overflow>
+    bool operator>(const ft::static_vector<T, N, Overflow> &lhs, const ft::static_vector<T, N, Overflow> &rhs) {
+        return rhs < lhs;
+    }
+
+    template<class T, size_t N, class Overflow>
+    bool operator<=(const ft::static_vector<T, N, Overflow> &lhs, const ft::static_vector<T, N, Overflow> &rhs) {
+        return !(rhs < lhs);
+    }
+
+    template<class T, size_t N, class Overflow>
+    bool operator>=(const ft::static_vector<T, N, Overflow> &lhs, const ft::static_vector<T, N, Overflow> &rhs) {
+        return !(lhs < rhs);
+    }
+
+    template<class T, size_t N, class Overflow>
+    void swap(ft::static_vector<T, N, Overflow> &x, ft::static_vector<T, N, Overflow> &y) {
+        x.swap(y);
+    }
+}
@@ -3,6 +3,7 @@
 # include <memory>
 # include <algorithm>
 # include <cstddef>
+# include <type_traits>
 # include <tgmath.h>
 #include <iostream>
 #include "../utils/iterator_traits.hpp"
@@ -159,6 +160,8 @@ namespace ft{
 						allocator_.deallocate(temp, n);
 						throw;
 					}
+					for (size_type i = 0; i < size_; ++i)
+						allocator_.destroy(data_ + i);
 					allocator_.deallocate(data_, capacity_);
                     data_ = temp;
                     capacity_ = n;
@@ -239,6 +242,34 @@ namespace ft{
 				}
 			}
 
+			// Constructs the copies in one slice per worker of executor (anything with size() and
+			// parallel_for(first, last, f(begin, end), grain)), so every page of a fresh buffer is first
+			// touched by the thread filling it and lands on that thread's NUMA node. Types whose copy may
+			// throw are filled on the calling thread.
+			template <class Executor>
+			void assign(size_type n, const value_type &val, Executor &executor) {
+				clear();
+				if (capacity_ < n) {
+					allocator_.deallocate(data_, capacity_);
+					data_ = nullptr;
+					capacity_ = 0;
+					data_ = allocator_.allocate(n);
+					capacity_ = n;
+				}
+				if (!std::is_nothrow_copy_constructible<value_type>::value) {
+					for(; size_ < n; ++size_)
+						allocator_.construct(data_ + size_, val);
+					return;
+				}
+				pointer data = data_;
+				allocator_type &allocator = allocator_;
+				executor.parallel_for(0, n, [&](size_type begin, size_type end) {
+					for (size_type i = begin; i < end; ++i)
+						allocator.construct(data + i, val);
+				}, n / executor.size() + 1);
+				size_ = n;
+			}
+
 			void push_back(const value_type &val) {
 				if (!size_)
 					reserve(1);
@@ -432,3 +463,5 @@ namespace ft{
 		x.swap(y);
 	}
 }
+
+#include "vector_bool.hpp"
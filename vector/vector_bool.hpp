@@ -0,0 +1,534 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include "../utils/bits.hpp"
+#include "../utils/enable_if.hpp"
+#include "../utils/is_integral.hpp"
+#include "../utils/iterator_traits.hpp"
+#include "vector.hpp"
+
+namespace ft{
+    typedef unsigned long long bit_word;
+
+    // Stands in for bool & to one bit of a word.
+    class bit_reference{
+        public:
+            bit_reference(bit_word *word, bit_word mask) : word_(word), mask_(mask) {}
+
+            operator bool() const {
+                return *word_ & mask_;
+            }
+
+            bit_reference &operator=(bool x) {
+                if (x)
+                    *word_ |= mask_;
+                else
+                    *word_ &= ~mask_;
+                return *this;
+            }
+
+            bit_reference &operator=(const bit_reference &x) {
+                return *this = bool(x);
+            }
+
+            bool operator~() const {
+                return !bool(*this);
+            }
+
+            void flip() {
+                *word_ ^= mask_;
+            }
+
+        private:
+            bit_word *word_;
+            bit_word mask_;
+    };
+
+    inline void swap(bit_reference x, bit_reference y) {
+        bool tmp = x;
+
+        x = y;
+        y = tmp;
+    }
+
+    // Random access iterator over the bits of a word array, low bit first.
+    template <bool Const>
+    class bit_iterator{
+        public:
+            typedef std::random_access_iterator_tag iterator_category;
+            typedef bool value_type;
+            typedef ptrdiff_t difference_type;
+            typedef void pointer;
+            typedef typename std::conditional<Const, bool, ft::bit_reference>::type reference;
+            typedef typename std::conditional<Const, const bit_word *, bit_word *>::type word_pointer;
+
+            bit_iterator() : word_(0), offset_(0) {}
+
+            bit_iterator(word_pointer word, unsigned offset) : word_(word), offset_(offset) {}
+
+            word_pointer word() const {
+                return word_;
+            }
+
+            unsigned offset() const {
+                return offset_;
+            }
+
+            reference operator*() const {
+                return deref(std::integral_constant<bool, Const>());
+            }
+
+            reference operator[](difference_type n) const {
+                return *(*this + n);
+            }
+
+            bit_iterator &operator++() {
+                if (++offset_ == 64) {
+                    offset_ = 0;
+                    ++word_;
+                }
+                return *this;
+            }
+
+            bit_iterator operator++(int) {
+                bit_iterator tmp = *this;
+                ++(*this);
+                return tmp;
+            }
+
+            bit_iterator &operator--() {
+                if (!offset_--) {
+                    offset_ = 63;
+                    --word_;
+                }
+                return *this;
+            }
+
+            bit_iterator operator--(int) {
+                bit_iterator tmp = *this;
+                --(*this);
+                return tmp;
+            }
+
+            bit_iterator &operator+=(difference_type n) {
+                difference_type bit = difference_type(offset_) + n;
+                difference_type words = bit >= 0 ? bit / 64 : -((63 - bit) / 64);
+
+                word_ += words;
+                offset_ = static_cast<unsigned>(bit - words * 64);
+                return *this;
+            }
+
+            bit_iterator &operator-=(difference_type n) {
+                return *this += -n;
+            }
+
+            bit_iterator operator+(difference_type n) const {
+                bit_iterator tmp = *this;
+                return tmp += n;
+            }
+
+            bit_iterator operator-(difference_type n) const {
+                bit_iterator tmp = *this;
+                return tmp -= n;
+            }
+
+            difference_type operator-(const bit_iterator &it) const {
+                return (word_ - it.word_) * 64 + difference_type(offset_) - difference_type(it.offset_);
+            }
+
+            bool operator==(const bit_iterator &it) const {
+                return word_ == it.word_ && offset_ == it.offset_;
+            }
+
+            bool operator!=(const bit_iterator &it) const {
+                return !(*this == it);
+            }
+
+            bool operator<(const bit_iterator &it) const {
+                return word_ < it.word_ || (word_ == it.word_ && offset_ < it.offset_);
+            }
+
+            bool operator>(const bit_iterator &it) const {
+                return it < *this;
+            }
+
+            bool operator<=(const bit_iterator &it) const {
+                return !(it < *this);
+            }
+
+            bool operator>=(const bit_iterator &it) const {
+                return !(*this < it);
+            }
+
+            operator bit_iterator<true>() const {
+                return bit_iterator<true>(word_, offset_);
+            }
+
+        private:
+            word_pointer word_;
+            unsigned offset_;
+
+            bool deref(std::true_type) const {
+                return (*word_ >> offset_) & 1;
+            }
+
+            ft::bit_reference deref(std::false_type) const {
+                return ft::bit_reference(word_, bit_word(1) << offset_);
+            }
+    };
+
+    // One bit per flag, 64 to a word. Bits past size() in the last word are kept clear, so count,
+    // comparison and the bitwise operators work a whole word at a time. Elements are reached through
+    // ft::bit_reference proxies rather than bool &.
+    template <class Alloc>
+    class vector<bool, Alloc>{
+        public:
+            typedef bool value_type;
+            typedef Alloc allocator_type;
+            typedef ft::bit_reference reference;
+            typedef bool const_reference;
+            typedef ft::bit_iterator<false> iterator;
+            typedef ft::bit_iterator<true> const_iterator;
+            typedef ft::reverse_iterator<iterator> reverse_iterator;
+            typedef ft::reverse_iterator<const_iterator> const_reverse_iterator;
+            typedef ptrdiff_t difference_type;
+            typedef size_t size_type;
+            typedef ft::bit_word word_type;
+
+            static const size_type bits_per_word = 64;
+            // Returned by find_first and find_next when no bit is set.
+            static const size_type npos = static_cast<size_type>(-1);
+
+            explicit vector(const allocator_type &allocator = allocator_type())
+                : allocator_(allocator), words_(word_allocator(allocator)), size_(0) {}
+
+            explicit vector(size_type n, const value_type &val = value_type(), const allocator_type &allocator = allocator_type())
+                : allocator_(allocator), words_(word_allocator(allocator)), size_(0) {
+                resize(n, val);
+            }
+
+            template<class TemplateIterator>
+            vector(TemplateIterator first, TemplateIterator last, const allocator_type &allocator = allocator_type(),
+                   typename ft::enable_if<!ft::is_integral<TemplateIterator>::value>::type* = 0)
+                : allocator_(allocator), words_(word_allocator(allocator)), size_(0) {
+                for (; first != last; ++first)
+                    push_back(*first);
+            }
+
+            iterator begin() {
+                return iterator(data(), 0);
+            }
+
+            const_iterator begin() const {
+                return const_iterator(data(), 0);
+            }
+
+            iterator end() {
+                return begin() + size_;
+            }
+
+            const_iterator end() const {
+                return begin() + size_;
+            }
+
+            reverse_iterator rbegin() {
+                return reverse_iterator(end());
+            }
+
+            const_reverse_iterator rbegin() const {
+                return const_reverse_iterator(end());
+            }
+
+            reverse_iterator rend() {
+                return reverse_iterator(begin());
+            }
+
+            const_reverse_iterator rend() const {
+                return const_reverse_iterator(begin());
+            }
+
+            size_type size() const {
+                return size_;
+            }
+
+            size_type max_size() const {
+                return words_.max_size() * bits_per_word;
+            }
+
+            size_type capacity() const {
+                return words_.capacity() * bits_per_word;
+            }
+
+            bool empty() const {
+                return !size_;
+            }
+
+            void reserve(size_type n) {
+                words_.reserve(words_for(n));
+            }
+
+            void resize(size_type n, value_type val = value_type()) {
+                size_type old = size_;
+
+                words_.resize(words_for(n), 0);
+                size_ = n;
+                if (n < old)
+                    clear_tail();
+                else if (val)
+                    set_range(old, n);
+            }
+
+            const_reference operator[](size_type n) const {
+                return (words_[n / bits_per_word] >> (n % bits_per_word)) & 1;
+            }
+
+            reference operator[](size_type n) {
+                return reference(&words_[n / bits_per_word], word_type(1) << (n % bits_per_word));
+            }
+
+            const_reference at(size_type n) const {
+                if (n < size_)
+                    return (*this)[n];
+                throw std::out_of_range("Error: position_ out of range");
+            }
+
+            reference at(size_type n) {
+                if (n < size_)
+                    return (*this)[n];
+                throw std::out_of_range("Error: position_ out of range");
+            }
+
+            const_reference front() const {
+                return (*this)[0];
+            }
+
+            reference front() {
+                return (*this)[0];
+            }
+
+            const_reference back() const {
+                return (*this)[size_ - 1];
+            }
+
+            reference back() {
+                return (*this)[size_ - 1];
+            }
+
+            template<class TemplateIterator>
+            void assign(TemplateIterator first, TemplateIterator last, typename ft::enable_if<!ft::is_integral<TemplateIterator>::value>::type* = 0) {
+                clear();
+                for (; first != last; ++first)
+                    push_back(*first);
+            }
+
+            void assign(size_type n, const value_type &val) {
+                clear();
+                resize(n, val);
+            }
+
+            void push_back(const value_type &val) {
+                if (!(size_ % bits_per_word))
+                    words_.push_back(0);
+                if (val)
+                    words_[size_ / bits_per_word] |= word_type(1) << (size_ % bits_per_word);
+                ++size_;
+            }
+
+            void pop_back() {
+                if (!size_)
+                    return;
+                (*this)[--size_] = false;
+                if (!(size_ % bits_per_word))
+                    words_.pop_back();
+            }
+
+            iterator insert(iterator position, const value_type &val) {
+                size_type index = position - begin();
+
+                insert(position, 1, val);
+                return begin() + index;
+            }
+
+            void insert(iterator position, size_type n, const value_type &val) {
+                size_type index = position - begin();
+
+                open(index, n);
+                for (size_type i = 0; i < n; ++i)
+                    (*this)[index + i] = val;
+            }
+
+            template<class TemplateIterator>
+            void insert(iterator position, TemplateIterator first, TemplateIterator last,
+                        typename ft::enable_if<!ft::is_integral<TemplateIterator>::value>::type* = 0) {
+                vector tmp(first, last, allocator_);
+                size_type index = position - begin();
+
+                open(index, tmp.size());
+                for (size_type i = 0; i < tmp.size(); ++i)
+                    (*this)[index + i] = tmp[i];
+            }
+
+            iterator erase(iterator position) {
+                return erase(position, position + 1);
+            }
+
+            iterator erase(iterator first, iterator last) {
+                size_type index = first - begin();
+                size_type n = last - first;
+
+                for (size_type i = index; i + n < size_; ++i)
+                    (*this)[i] = bool((*this)[i + n]);
+                resize(size_ - n);
+                return begin() + index;
+            }
+
+            void swap(vector &x) {
+                words_.swap(x.words_);
+                std::swap(size_, x.size_);
+            }
+
+            static void swap(reference x, reference y) {
+                ft::swap(x, y);
+            }
+
+            void clear() {
+                words_.clear();
+                size_ = 0;
+            }
+
+            void flip() {
+                for (size_type i = 0; i < words_.size(); ++i)
+                    words_[i] = ~words_[i];
+                clear_tail();
+            }
+
+            allocator_type get_allocator() const {
+                return allocator_;
+            }
+
+            // Number of set bits, one popcount per word.
+            size_type count() const {
+                size_type res = 0;
+
+                for (size_type i = 0; i < words_.size(); ++i)
+                    res += ft::popcount(words_[i]);
+                return res;
+            }
+
+            size_type find_first() const {
+                return find_from(0);
+            }
+
+            // First set bit after pos, or npos.
+            size_type find_next(size_type pos) const {
+                return pos + 1 < size_ ? find_from(pos + 1) : npos;
+            }
+
+            // The bitwise operators need equal sizes; the word loops are left to the vectoriser.
+            vector &operator&=(const vector &x) {
+                check_size(x);
+                for (size_type i = 0; i < words_.size(); ++i)
+                    words_[i] &= x.words_[i];
+                return *this;
+            }
+
+            vector &operator|=(const vector &x) {
+                check_size(x);
+                for (size_type i = 0; i < words_.size(); ++i)
+                    words_[i] |= x.words_[i];
+                return *this;
+            }
+
+            vector &operator^=(const vector &x) {
+                check_size(x);
+                for (size_type i = 0; i < words_.size(); ++i)
+                    words_[i] ^= x.words_[i];
+                return *this;
+            }
+
+            // The packed words, size() bits low bit first, for word-level code outside the class.
+            const word_type *words() const {
+                return data();
+            }
+
+            friend bool operator==(const vector &lhs, const vector &rhs) {
+                if (lhs.size_ != rhs.size_)
+                    return false;
+                for (size_type i = 0; i < lhs.words_.size(); ++i)
+                    if (lhs.words_[i] != rhs.words_[i])
+                        return false;
+                return true;
+            }
+
+        private:
+            typedef typename Alloc::template rebind<word_type>::other word_allocator;
+
+            allocator_type allocator_;
+            ft::vector<word_type, word_allocator> words_;
+            size_type size_;
+
+            static size_type words_for(size_type n) {
+                return (n + bits_per_word - 1) / bits_per_word;
+            }
+
+            word_type *data() {
+                return words_.empty() ? 0 : &words_[0];
+            }
+
+            const word_type *data() const {
+                return words_.empty() ? 0 : &words_[0];
+            }
+
+            void clear_tail() {
+                if (size_ % bits_per_word)
+                    words_.back() &= ~word_type(0) >> (bits_per_word - size_ % bits_per_word);
+            }
+
+            void set_range(size_type first, size_type last) {
+                for (; first < last && first % bits_per_word; ++first)
+                    (*this)[first] = true;
+                for (; first + bits_per_word <= last; first += bits_per_word)
+                    words_[first / bits_per_word] = ~word_type(0);
+                for (; first < last; ++first)
+                    (*this)[first] = true;
+            }
+
+            size_type find_from(size_type pos) const {
+                size_type w = pos / bits_per_word;
+
+                if (w >= words_.size())
+                    return npos;
+                word_type bits = words_[w] & (~word_type(0) << (pos % bits_per_word));
+                while (!bits) {
+                    if (++w == words_.size())
+                        return npos;
+                    bits = words_[w];
+                }
+                return w * bits_per_word + ft::count_trailing_zeros(bits);
+            }
+
+            // Grows by n bits and moves [index, size) up to make room at index.
+            void open(size_type index, size_type n) {
+                size_type old = size_;
+
+                resize(size_ + n);
+                for (size_type i = old; i-- > index; )
+                    (*this)[i + n] = bool((*this)[i]);
+            }
+
+            void check_size(const vector &x) const {
+                if (x.size_ != size_)
+                    throw std::invalid_argument("ft::vector<bool>: size mismatch");
+            }
+    };
+
+    template <class Alloc>
+    const typename vector<bool, Alloc>::size_type vector<bool, Alloc>::bits_per_word;
+
+    template <class Alloc>
+    const typename vector<bool, Alloc>::size_type vector<bool, Alloc>::npos;
+}
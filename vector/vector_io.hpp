@@ -0,0 +1,170 @@
+#pragma once
+
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "vector.hpp"
+
+namespace ft{
+    // On-disk layout: this header, zero padding up to data_offset, then the elements as raw bytes.
+    // data_offset is a multiple of 64, so a mapped file keeps any element alignment up to that.
+    struct vector_file_header{
+        char magic[8];
+        unsigned version;
+        unsigned byte_order;
+        unsigned long long element_size;
+        unsigned long long count;
+        unsigned long long data_offset;
+    };
+
+    namespace vector_io_detail
+    {
+        static const char magic[8] = {'F', 'T', 'V', 'E', 'C', 0, 0, 0};
+        static const unsigned version = 1;
+        static const unsigned byte_order = 0x01020304;
+        static const unsigned long long data_offset = 64;
+
+        inline vector_file_header make_header(size_t element_size, size_t count) {
+            vector_file_header header;
+
+            std::memset(&header, 0, sizeof(header));
+            std::memcpy(header.magic, magic, sizeof(magic));
+            header.version = version;
+            header.byte_order = byte_order;
+            header.element_size = element_size;
+            header.count = count;
+            header.data_offset = data_offset;
+            return header;
+        }
+
+        // Rejects files from another format version, another byte order or another element type size.
+        inline void check_header(const vector_file_header &header, size_t element_size) {
+            if (std::memcmp(header.magic, magic, sizeof(magic)) || header.version != version)
+                throw std::runtime_error("ft::load: not a vector file");
+            if (header.byte_order != byte_order)
+                throw std::runtime_error("ft::load: byte order mismatch");
+            if (header.element_size != element_size)
+                throw std::runtime_error("ft::load: element size mismatch");
+            if (header.data_offset < sizeof(header))
+                throw std::runtime_error("ft::load: corrupt header");
+        }
+
+        // write and read may move fewer bytes than asked (large counts, signals), so both loop.
+        inline void write_all(int fd, const void *data, size_t bytes, const char *what = "ft::save") {
+            const char *p = static_cast<const char *>(data);
+
+            while (bytes) {
+                ssize_t done = ::write(fd, p, bytes);
+                if (done < 0 && errno == EINTR)
+                    continue;
+                if (done < 0)
+                    throw std::system_error(errno, std::generic_category(), what);
+                p += done;
+                bytes -= done;
+            }
+        }
+
+        // Stops short of bytes only at end of file and returns what it got.
+        inline size_t read_some(int fd, void *data, size_t bytes, const char *what = "ft::load") {
+            char *p = static_cast<char *>(data);
+            size_t total = 0;
+
+            while (total < bytes) {
+                ssize_t done = ::read(fd, p + total, bytes - total);
+                if (done < 0 && errno == EINTR)
+                    continue;
+                if (done < 0)
+                    throw std::system_error(errno, std::generic_category(), what);
+                if (!done)
+                    break;
+                total += done;
+            }
+            return total;
+        }
+
+        inline void read_all(int fd, void *data, size_t bytes) {
+            if (read_some(fd, data, bytes) != bytes)
+                throw std::runtime_error("ft::load: truncated file");
+        }
+
+        // Bytes left after the current offset for a regular file; -1 for pipes and the like.
+        inline long long bytes_left(int fd) {
+            struct stat info;
+
+            if (fstat(fd, &info) < 0)
+                throw std::system_error(errno, std::generic_category(), "ft::load");
+            if (!S_ISREG(info.st_mode))
+                return -1;
+            off_t offset = ::lseek(fd, 0, SEEK_CUR);
+            if (offset < 0)
+                throw std::system_error(errno, std::generic_category(), "ft::load");
+            return offset < info.st_size ? static_cast<long long>(info.st_size - offset) : 0;
+        }
+
+        // Elements per read when the size cannot be checked up front, so memory follows the data.
+        static const size_t read_chunk = 1 << 20;
+    }
+
+    // Writes the header and then every element with one bulk write, from the current offset of fd.
+    template <class T, class Alloc>
+    void save(const ft::vector<T, Alloc> &v, int fd) {
+        static_assert(std::is_trivially_copyable<T>::value, "ft::save needs a trivially copyable T");
+        vector_file_header header = vector_io_detail::make_header(sizeof(T), v.size());
+        char padding[vector_io_detail::data_offset] = {};
+
+        std::memcpy(padding, &header, sizeof(header));
+        vector_io_detail::write_all(fd, padding, sizeof(padding));
+        if (!v.empty())
+            vector_io_detail::write_all(fd, &v[0], v.size() * sizeof(T));
+    }
+
+    // Replaces the contents of v with a vector written by ft::save, read with one bulk read. The count
+    // in the header is checked against what the file still holds before anything is allocated, and v is
+    // only touched once the whole load has succeeded.
+    template <class T, class Alloc>
+    void load(ft::vector<T, Alloc> &v, int fd) {
+        static_assert(std::is_trivially_copyable<T>::value, "ft::load needs a trivially copyable T");
+        vector_file_header header;
+        char padding[vector_io_detail::data_offset];
+
+        vector_io_detail::read_all(fd, &header, sizeof(header));
+        vector_io_detail::check_header(header, sizeof(T));
+        if (header.count > ~size_t(0) / sizeof(T))
+            throw std::runtime_error("ft::load: corrupt header");
+
+        const size_t count = static_cast<size_t>(header.count);
+        long long left = vector_io_detail::bytes_left(fd);
+        unsigned long long skip = header.data_offset - sizeof(header);
+
+        if (left >= 0 && (skip > static_cast<unsigned long long>(left)
+                          || count > (static_cast<unsigned long long>(left) - skip) / sizeof(T)))
+            throw std::runtime_error("ft::load: truncated file");
+        while (skip) {
+            size_t step = skip < sizeof(padding) ? skip : sizeof(padding);
+            vector_io_detail::read_all(fd, padding, step);
+            skip -= step;
+        }
+
+        ft::vector<T, Alloc> loaded(v.get_allocator());
+
+        if (left >= 0) {
+            loaded.resize(count);
+            if (count)
+                vector_io_detail::read_all(fd, &loaded[0], count * sizeof(T));
+        }
+        else {
+            for (size_t done = 0; done < count; ) {
+                size_t step = count - done < vector_io_detail::read_chunk ? count - done : vector_io_detail::read_chunk;
+                loaded.resize(done + step);
+                vector_io_detail::read_all(fd, &loaded[done], step * sizeof(T));
+                done += step;
+            }
+        }
+        v.swap(loaded);
+    }
+}